@@ -247,6 +247,7 @@ SOURCES += \
   src/common/htmlinfobuilder.cpp \
   src/common/jsoninfobuilder.cpp \
   src/common/jumpback.cpp \
+  src/common/labelcache.cpp \
   src/common/mapcolors.cpp \
   src/common/mapflags.cpp \
   src/common/mapresult.cpp \
@@ -256,6 +257,7 @@ SOURCES += \
   src/common/procflags.cpp \
   src/common/proctypes.cpp \
   src/common/settingsmigrate.cpp \
+  src/common/sqlcolumnindex.cpp \
   src/common/symbolpainter.cpp \
   src/common/tabindexes.cpp \
   src/common/textplacement.cpp \
@@ -294,6 +296,7 @@ SOURCES += \
   src/logbook/logdatadialog.cpp \
   src/logbook/logstatisticsdialog.cpp \
   src/main.cpp \
+  src/mapgui/airportdiagramcache.cpp \
   src/mapgui/aprongeometrycache.cpp \
   src/mapgui/imageexportdialog.cpp \
   src/mapgui/mapairporthandler.cpp \
@@ -310,6 +313,7 @@ SOURCES += \
   src/mapgui/maptooltip.cpp \
   src/mapgui/mapvisible.cpp \
   src/mapgui/mapwidget.cpp \
+  src/mapgui/screenindexgrid.cpp \
   src/mappainter/mappainter.cpp \
   src/mappainter/mappainteraircraft.cpp \
   src/mappainter/mappainterairport.cpp \
@@ -328,6 +332,7 @@ SOURCES += \
   src/mappainter/mappainterweather.cpp \
   src/mappainter/mappainterwind.cpp \
   src/mappainter/mappaintlayer.cpp \
+  src/mappainter/renderprofiler.cpp \
   src/navapp.cpp \
   src/online/onlinedatacontroller.cpp \
   src/options/optiondata.cpp \
@@ -350,6 +355,7 @@ SOURCES += \
   src/query/mapquery.cpp \
   src/query/procedurequery.cpp \
   src/query/querytypes.cpp \
+  src/query/userpointindex.cpp \
   src/query/waypointquery.cpp \
   src/query/waypointtrackquery.cpp \
   src/route/customproceduredialog.cpp \
@@ -365,6 +371,8 @@ SOURCES += \
   src/route/routeflags.cpp \
   src/route/routelabel.cpp \
   src/route/routeleg.cpp \
+  src/route/routesegmentindex.cpp \
+  src/route/routetablemodel.cpp \
   src/route/runwayselectiondialog.cpp \
   src/route/userwaypointdialog.cpp \
   src/routeexport/fetchroutedialog.cpp \
@@ -392,8 +400,7 @@ SOURCES += \
   src/search/onlineserversearch.cpp \
   src/search/proceduresearch.cpp \
   src/search/querybuilder.cpp \
-  src/search/randomdepartureairportpickingbycriteria.cpp \
-  src/search/randomdestinationairportpickingbycriteria.cpp \
+  src/search/randomflightplangenerator.cpp \
   src/search/searchbasetable.cpp \
   src/search/searchcontroller.cpp \
   src/search/sqlcontroller.cpp \
@@ -442,6 +449,7 @@ HEADERS  += \
   src/common/infobuildertypes.h \
   src/common/jsoninfobuilder.h \
   src/common/jumpback.h \
+  src/common/labelcache.h \
   src/common/mapcolors.h \
   src/common/mapflags.h \
   src/common/mapresult.h \
@@ -451,6 +459,7 @@ HEADERS  += \
   src/common/procflags.h \
   src/common/proctypes.h \
   src/common/settingsmigrate.h \
+  src/common/sqlcolumnindex.h \
   src/common/symbolpainter.h \
   src/common/tabindexes.h \
   src/common/textplacement.h \
@@ -488,6 +497,7 @@ HEADERS  += \
   src/logbook/logdataconverter.h \
   src/logbook/logdatadialog.h \
   src/logbook/logstatisticsdialog.h \
+  src/mapgui/airportdiagramcache.h \
   src/mapgui/aprongeometrycache.h \
   src/mapgui/imageexportdialog.h \
   src/mapgui/mapairporthandler.h \
@@ -504,6 +514,7 @@ HEADERS  += \
   src/mapgui/maptooltip.h \
   src/mapgui/mapvisible.h \
   src/mapgui/mapwidget.h \
+  src/mapgui/screenindexgrid.h \
   src/mappainter/mappainter.h \
   src/mappainter/mappainteraircraft.h \
   src/mappainter/mappainterairport.h \
@@ -522,6 +533,7 @@ HEADERS  += \
   src/mappainter/mappainterweather.h \
   src/mappainter/mappainterwind.h \
   src/mappainter/mappaintlayer.h \
+  src/mappainter/renderprofiler.h \
   src/navapp.h \
   src/online/onlinedatacontroller.h \
   src/options/optiondata.h \
@@ -544,6 +556,7 @@ HEADERS  += \
   src/query/mapquery.h \
   src/query/procedurequery.h \
   src/query/querytypes.h \
+  src/query/userpointindex.h \
   src/query/waypointquery.h \
   src/query/waypointtrackquery.h \
   src/route/customproceduredialog.h \
@@ -559,6 +572,8 @@ HEADERS  += \
   src/route/routeflags.h \
   src/route/routelabel.h \
   src/route/routeleg.h \
+  src/route/routesegmentindex.h \
+  src/route/routetablemodel.h \
   src/route/runwayselectiondialog.h \
   src/route/userwaypointdialog.h \
   src/routeexport/fetchroutedialog.h \
@@ -586,8 +601,7 @@ HEADERS  += \
   src/search/onlineserversearch.h \
   src/search/proceduresearch.h \
   src/search/querybuilder.h \
-  src/search/randomdepartureairportpickingbycriteria.h \
-  src/search/randomdestinationairportpickingbycriteria.h \
+  src/search/randomflightplangenerator.h \
   src/search/searchbasetable.h \
   src/search/searchcontroller.h \
   src/search/sqlcontroller.h \
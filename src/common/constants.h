@@ -341,6 +341,12 @@ const QLatin1String OPTIONS_WEATHER_DEBUG("Options/WeatherDebug");
 const QLatin1String OPTIONS_MAP_JUMP_BACK_DEBUG("Options/MapJumpBackDebug");
 const QLatin1String OPTIONS_PROFILE_JUMP_BACK_DEBUG("Options/ProfileJumpBackDebug");
 const QLatin1String OPTIONS_MAP_LAYER_DEBUG("Options/MapLayerDebug");
+const QLatin1String OPTIONS_RENDER_PROFILER("Options/RenderProfiler");
+const QLatin1String OPTIONS_RENDER_PROFILER_OVERLAY("Options/RenderProfilerOverlay");
+const QLatin1String OPTIONS_MAP_LABEL_COLLISION("Options/MapLabelCollision");
+const QLatin1String OPTIONS_MAP_LAYER_CACHE("Options/MapLayerCache");
+const QLatin1String OPTIONS_MAP_FRAME_BUDGET("Options/MapFrameBudgetMs");
+const QLatin1String OPTIONS_MAP_EXPORT_TILE_SIZE("Options/MapExportTileSize");
 const QLatin1String OPTIONS_ONLINE_NETWORK_DEBUG("Options/OnlineNetworkDebug");
 const QLatin1String OPTIONS_ONLINE_NETWORK_DISABLE_SHADOW("Options/OnlineNetworkDisableShadow");
 const QLatin1String OPTIONS_TRACK_DEBUG("Options/TrackDebug");
@@ -23,16 +23,24 @@
 #include "geo/linestring.h"
 
 #include <marble/GeoDataLineString.h>
+#include <marble/MarbleGlobal.h>
+#include <marble/Quaternion.h>
 #include <marble/ViewportParams.h>
 
 #include <QLineF>
 #include <QPolygonF>
+#include <QtMath>
 
 using namespace Marble;
 using namespace atools::geo;
 
 const QSize CoordinateConverter::DEFAULT_WTOS_SIZE(100, 100);
 
+const static float DEG_TO_RAD = static_cast<float>(M_PI / 180.);
+
+/* Marble does not draw beyond this latitude in Mercator projection */
+const static float MAX_MERCATOR_LAT_DEG = 85.05113f;
+
 CoordinateConverter::CoordinateConverter(const ViewportParams *viewportParams)
   : viewport(viewportParams)
 {
@@ -378,3 +386,124 @@ bool CoordinateConverter::wToSInternal(const Marble::GeoDataCoordinates& coords,
     *isHidden = hidden;
   return visible && !hidden;
 }
+
+bool CoordinateConverter::wToS(const float *lonX, const float *latY, int num, float *x, float *y, bool *visible,
+                               bool *hidden, const QSize& size) const
+{
+  const float width = viewport->width(), height = viewport->height();
+  const float radius = viewport->radius();
+  const float halfWidth = width / 2.f, halfHeight = height / 2.f;
+  bool closedFormula = false;
+
+  if(viewport->projection() == Marble::Spherical)
+  {
+    // Orthographic projection of the rotated globe - same as Marble::SphericalProjection ======
+    const Marble::matrix& m = viewport->planetAxisMatrix();
+    const float m00 = static_cast<float>(m[0][0]), m10 = static_cast<float>(m[1][0]), m20 = static_cast<float>(m[2][0]);
+    const float m01 = static_cast<float>(m[0][1]), m11 = static_cast<float>(m[1][1]), m21 = static_cast<float>(m[2][1]);
+    const float m02 = static_cast<float>(m[0][2]), m12 = static_cast<float>(m[1][2]), m22 = static_cast<float>(m[2][2]);
+
+    // No branches in loop to allow vectorization
+    for(int i = 0; i < num; i++)
+    {
+      const float lon = lonX[i] * DEG_TO_RAD, lat = latY[i] * DEG_TO_RAD;
+      const float cosLat = std::cos(lat);
+      const float qx = cosLat * std::sin(lon), qy = std::sin(lat), qz = cosLat * std::cos(lon);
+
+      x[i] = halfWidth + radius * (m00 * qx + m10 * qy + m20 * qz);
+      y[i] = halfHeight - radius * (m01 * qx + m11 * qy + m21 * qz);
+
+      // Point is on the back side of the globe if z is negative
+      visible[i] = m02 * qx + m12 * qy + m22 * qz >= 0.f;
+    }
+    closedFormula = true;
+  }
+  else if(viewport->projection() == Marble::Mercator && 4.f * radius > width + size.width())
+  {
+    // Mercator projection if the world is wider than the screen - same as Marble::MercatorProjection ======
+    // Otherwise repetitions are visible which need the more complex calculation in Marble
+    qreal centerLonRad, centerLatRad;
+    viewport->centerCoordinates(centerLonRad, centerLatRad);
+
+    const float rad2Pixel = 2.f * radius / static_cast<float>(M_PI);
+    const float centerLon = static_cast<float>(qRadiansToDegrees(centerLonRad));
+    const float centerY = static_cast<float>(std::atanh(std::sin(centerLatRad)));
+
+    for(int i = 0; i < num; i++)
+    {
+      // Normalize longitude difference to -180 to 180 to get the repetition closest to the center
+      float diffLon = lonX[i] - centerLon;
+      diffLon -= 360.f * std::floor((diffLon + 180.f) / 360.f);
+
+      const float lat = std::min(std::max(latY[i], -MAX_MERCATOR_LAT_DEG), MAX_MERCATOR_LAT_DEG) * DEG_TO_RAD;
+
+      x[i] = halfWidth + rad2Pixel * diffLon * DEG_TO_RAD;
+      y[i] = halfHeight - rad2Pixel * (std::atanh(std::sin(lat)) - centerY);
+      visible[i] = std::abs(latY[i]) <= MAX_MERCATOR_LAT_DEG;
+    }
+    closedFormula = true;
+  }
+  else
+  {
+    // Point by point for all other projections ======
+    for(int i = 0; i < num; i++)
+    {
+      double xd, yd;
+      bool hid = false;
+      visible[i] = wToSInternal(GeoDataCoordinates(lonX[i], latY[i], 0., DEG), xd, yd, size, &hid);
+      x[i] = static_cast<float>(xd);
+      y[i] = static_cast<float>(yd);
+      if(hidden != nullptr)
+        hidden[i] = hid;
+    }
+    return false;
+  }
+
+  // Hidden status and screen check for closed formulas ======
+  const float halfSizeWidth = size.width() / 2.f, halfSizeHeight = size.height() / 2.f;
+  for(int i = 0; i < num; i++)
+  {
+    if(hidden != nullptr)
+      hidden[i] = !visible[i];
+    visible[i] = visible[i] && x[i] + halfSizeWidth >= 0.f && x[i] - halfSizeWidth < width &&
+                 y[i] + halfSizeHeight >= 0.f && y[i] - halfSizeHeight < height;
+  }
+  return closedFormula;
+}
+
+// ============================================================================================
+
+void CoordinateBatch::clear()
+{
+  // Shrinking does not free memory
+  lonX.resize(0);
+  latY.resize(0);
+}
+
+void CoordinateBatch::reserve(int size)
+{
+  lonX.reserve(size);
+  latY.reserve(size);
+}
+
+void CoordinateBatch::append(const atools::geo::Pos& pos)
+{
+  lonX.append(pos.getLonX());
+  latY.append(pos.getLatY());
+}
+
+void CoordinateBatch::append(float lonXDeg, float latYDeg)
+{
+  lonX.append(lonXDeg);
+  latY.append(latYDeg);
+}
+
+bool CoordinateBatch::project(const CoordinateConverter& converter, const QSize& size)
+{
+  int num = lonX.size();
+  x.resize(num);
+  y.resize(num);
+  visible.resize(num);
+  hidden.resize(num);
+  return converter.wToS(lonX.constData(), latY.constData(), num, x.data(), y.data(), visible.data(), hidden.data(), size);
+}
@@ -22,6 +22,7 @@
 
 #include <QPoint>
 #include <QSize>
+#include <QVector>
 
 namespace Marble {
 class ViewportParams;
@@ -123,6 +124,20 @@ public:
 
   bool wToS(const atools::geo::Line& coords, QLineF& line, const QSize& size = DEFAULT_WTOS_SIZE, bool *isHidden = nullptr) const;
 
+  /*
+   * Batch conversion of world to screen coordinates for arrays of longitude and latitude in degree.
+   * Uses closed formulas for the spherical and Mercator projections and converts point by point for all others.
+   *
+   * x, y, visible and hidden have to be allocated for num values. hidden can be null.
+   * visible is true if the point is on screen extended by size and not hidden behind the globe.
+   * Coordinates of hidden points are not usable.
+   *
+   * @return true if a closed formula was used. Coordinates are continuous then and can be used
+   * to draw polylines and polygons. Otherwise Mercator repetitions might be mixed.
+   */
+  bool wToS(const float *lonX, const float *latY, int num, float *x, float *y, bool *visible, bool *hidden = nullptr,
+            const QSize& size = DEFAULT_WTOS_SIZE) const;
+
   bool sToW(int x, int y, atools::geo::Pos& pos) const;
   bool sToW(int x, int y, Marble::GeoDataCoordinates& coords) const;
 
@@ -144,4 +159,67 @@ private:
 
 };
 
+/*
+ * Buffer for batched world to screen conversion in CoordinateConverter.
+ * Keep an instance as a member to avoid reallocation for each frame.
+ */
+class CoordinateBatch
+{
+public:
+  /* Remove all points but keep allocated memory */
+  void clear();
+
+  void append(const atools::geo::Pos& pos);
+  void append(float lonXDeg, float latYDeg);
+
+  void reserve(int size);
+
+  /* Convert all appended points. Returns true if a closed formula was used. See CoordinateConverter::wToS */
+  bool project(const CoordinateConverter& converter, const QSize& size = CoordinateConverter::DEFAULT_WTOS_SIZE);
+
+  int size() const
+  {
+    return lonX.size();
+  }
+
+  float getLonX(int index) const
+  {
+    return lonX.at(index);
+  }
+
+  float getLatY(int index) const
+  {
+    return latY.at(index);
+  }
+
+  float getX(int index) const
+  {
+    return x.at(index);
+  }
+
+  float getY(int index) const
+  {
+    return y.at(index);
+  }
+
+  QPointF getPointF(int index) const
+  {
+    return QPointF(x.at(index), y.at(index));
+  }
+
+  bool isVisible(int index) const
+  {
+    return visible.at(index);
+  }
+
+  bool isHidden(int index) const
+  {
+    return hidden.at(index);
+  }
+
+private:
+  QVector<float> lonX, latY, x, y;
+  QVector<bool> visible, hidden;
+};
+
 #endif // LITTLENAVMAP_COORDINATECONVERTER_H
@@ -0,0 +1,122 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "common/labelcache.h"
+
+#include "atools.h"
+
+#include <QFontMetricsF>
+#include <QTransform>
+
+#include <algorithm>
+
+/* Size of a collision grid cell in pixels */
+const static int CELL_SIZE = 32;
+
+const LabelCache::Label *LabelCache::label(LabelKey& key, const QFont& font)
+{
+  key.fontHash = fontHash(font);
+  return labels.object(key);
+}
+
+const LabelCache::Label *LabelCache::insert(const LabelKey& key, const QFont& font, const QStringList& texts)
+{
+  QFontMetricsF metrics(font);
+  Label *label = new Label;
+  label->reserve(texts.size());
+
+  for(const QString& text : texts)
+  {
+    Line line;
+    line.text.setText(text);
+    line.text.setTextFormat(Qt::PlainText);
+    line.text.setPerformanceHint(QStaticText::AggressiveCaching);
+    line.text.prepare(QTransform(), font);
+    line.width = static_cast<float>(metrics.horizontalAdvance(text));
+    label->append(line);
+  }
+
+  labels.insert(key, label);
+  return label;
+}
+
+void LabelCache::clear()
+{
+  labels.clear();
+  lastFontValid = false;
+}
+
+uint LabelCache::fontHash(const QFont& font)
+{
+  if(!lastFontValid || font != lastFont)
+  {
+    lastFont = font;
+    lastFontHash = qHash(font.key());
+    lastFontValid = true;
+  }
+  return lastFontHash;
+}
+
+void LabelCollisionGrid::reset(const QRect& rect)
+{
+  gridRect = rect;
+  columns = std::max(1, (rect.width() + CELL_SIZE - 1) / CELL_SIZE);
+  rows = std::max(1, (rect.height() + CELL_SIZE - 1) / CELL_SIZE);
+
+  cells.clear();
+  cells.resize(columns * rows);
+}
+
+int LabelCollisionGrid::column(double x) const
+{
+  return atools::minmax(0, columns - 1, static_cast<int>(x - gridRect.left()) / CELL_SIZE);
+}
+
+int LabelCollisionGrid::row(double y) const
+{
+  return atools::minmax(0, rows - 1, static_cast<int>(y - gridRect.top()) / CELL_SIZE);
+}
+
+bool LabelCollisionGrid::place(const QRectF& rect)
+{
+  if(cells.isEmpty())
+    return true;
+
+  int colMin = column(rect.left()), colMax = column(rect.right());
+  int rowMin = row(rect.top()), rowMax = row(rect.bottom());
+
+  // Check all cells covered by the rectangle first
+  for(int r = rowMin; r <= rowMax; r++)
+  {
+    for(int c = colMin; c <= colMax; c++)
+    {
+      for(const QRectF& placed : cells.at(r * columns + c))
+      {
+        if(placed.intersects(rect))
+          return false;
+      }
+    }
+  }
+
+  // Free - occupy cells
+  for(int r = rowMin; r <= rowMax; r++)
+  {
+    for(int c = colMin; c <= colMax; c++)
+      cells[r * columns + c].append(rect);
+  }
+  return true;
+}
@@ -0,0 +1,113 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_LABELCACHE_H
+#define LITTLENAVMAP_LABELCACHE_H
+
+#include <QCache>
+#include <QFont>
+#include <QRect>
+#include <QStaticText>
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Key for a map object label. Contains all values which change the label text.
+ * Ident hash is used to detect reused ids after database switches.
+ */
+struct LabelKey
+{
+  int type = 0, id = -1;
+  uint identHash = 0;
+  int flags = 0, options = 0, maxLength = 0;
+  uint fontHash = 0;
+
+  bool operator==(const LabelKey& other) const
+  {
+    return type == other.type && id == other.id && identHash == other.identHash && flags == other.flags &&
+           options == other.options && maxLength == other.maxLength && fontHash == other.fontHash;
+  }
+
+};
+
+inline uint qHash(const LabelKey& key)
+{
+  return static_cast<uint>(key.id) ^ (static_cast<uint>(key.type) << 24) ^ key.identHash ^
+         (static_cast<uint>(key.flags) << 12) ^ static_cast<uint>(key.options) ^
+         (static_cast<uint>(key.maxLength) << 16) ^ key.fontHash;
+}
+
+/*
+ * Keeps prepared static texts and widths for map labels to avoid text layout and font metrics
+ * calculation on each frame. Texts are prepared for the font used when inserting.
+ */
+class LabelCache
+{
+public:
+  /* One line of a label */
+  struct Line
+  {
+    QStaticText text;
+    float width;
+  };
+
+  typedef QVector<Line> Label;
+
+  /* Get label or null if not cached. Font hash is added to the key. */
+  const Label *label(LabelKey& key, const QFont& font);
+
+  /* Prepare texts for font and insert. Key has to be passed through label() before. */
+  const Label *insert(const LabelKey& key, const QFont& font, const QStringList& texts);
+
+  void clear();
+
+private:
+  uint fontHash(const QFont& font);
+
+  QCache<LabelKey, Label> labels{5000};
+
+  /* Avoid building the font key for each call */
+  QFont lastFont;
+  uint lastFontHash = 0;
+  bool lastFontValid = false;
+};
+
+/*
+ * Uniform screen grid holding rectangles of already drawn labels. Used to drop overlapping labels.
+ */
+class LabelCollisionGrid
+{
+public:
+  /* Clear and prepare grid for the given screen rectangle */
+  void reset(const QRect& rect);
+
+  /* Returns false if rect overlaps a label placed before. Otherwise rect is added and true is returned. */
+  bool place(const QRectF& rect);
+
+private:
+  /* Get clamped cell column and row for screen coordinates */
+  int column(double x) const;
+  int row(double y) const;
+
+  QRect gridRect;
+  int columns = 0, rows = 0;
+
+  /* Row major list of cells with label rectangles */
+  QVector<QVector<QRectF> > cells;
+};
+
+#endif // LITTLENAVMAP_LABELCACHE_H
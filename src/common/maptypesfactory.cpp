@@ -19,6 +19,7 @@
 
 #include "navapp.h"
 #include "common/maptypes.h"
+#include "common/sqlcolumnindex.h"
 #include "fs/common/binarymsageometry.h"
 #include "geo/calculations.h"
 #include "io/binaryutil.h"
@@ -30,6 +31,62 @@ using namespace atools::geo;
 using atools::sql::SqlRecord;
 using namespace map;
 
+/* Airport columns for SqlColumnIndex. Order has to match AIRPORT_COLUMN_NAMES. */
+enum AirportColumn
+{
+  AP_COL_AIRPORT_ID, AP_COL_TOWER_FREQUENCY, AP_COL_IDENT, AP_COL_ICAO, AP_COL_IATA, AP_COL_FAA, AP_COL_LOCAL,
+  AP_COL_NAME, AP_COL_RATING, AP_COL_TYPE, AP_COL_LONGEST_RUNWAY_LENGTH, AP_COL_LONGEST_RUNWAY_HEADING, AP_COL_MAG_VAR,
+  AP_COL_TRANSITION_ALTITUDE, AP_COL_TRANSITION_LEVEL, AP_COL_FLATTEN, AP_COL_LEFT_LONX, AP_COL_TOP_LATY,
+  AP_COL_RIGHT_LONX, AP_COL_BOTTOM_LATY, AP_COL_TOWER_LONX, AP_COL_TOWER_LATY, AP_COL_ATIS_FREQUENCY,
+  AP_COL_AWOS_FREQUENCY, AP_COL_ASOS_FREQUENCY, AP_COL_UNICOM_FREQUENCY, AP_COL_LONX, AP_COL_LATY, AP_COL_ALTITUDE,
+  AP_COL_REGION,
+
+  /* Flags */
+  AP_COL_NUM_HELIPAD, AP_COL_HAS_AVGAS, AP_COL_HAS_JETFUEL, AP_COL_IS_CLOSED, AP_COL_IS_MILITARY, AP_COL_IS_ADDON,
+  AP_COL_IS_3D, AP_COL_NUM_RUNWAY_HARD, AP_COL_NUM_RUNWAY_SOFT, AP_COL_NUM_RUNWAY_WATER, AP_COL_NUM_APPROACH,
+  AP_COL_NUM_RUNWAY_LIGHT, AP_COL_NUM_RUNWAY_END_ILS, AP_COL_NUM_APRON, AP_COL_NUM_TAXI_PATH, AP_COL_HAS_TOWER_OBJECT,
+  AP_COL_NUM_PARKING_GATE, AP_COL_NUM_PARKING_GA_RAMP, AP_COL_NUM_PARKING_CARGO, AP_COL_NUM_PARKING_MIL_CARGO,
+  AP_COL_NUM_PARKING_MIL_COMBAT, AP_COL_NUM_RUNWAY_END_VASI, AP_COL_NUM_RUNWAY_END_ALS, AP_COL_NUM_RUNWAY_END_CLOSED
+};
+
+const static QStringList AIRPORT_COLUMN_NAMES({
+  "airport_id", "tower_frequency", "ident", "icao", "iata", "faa", "local",
+  "name", "rating", "type", "longest_runway_length", "longest_runway_heading", "mag_var",
+  "transition_altitude", "transition_level", "flatten", "left_lonx", "top_laty",
+  "right_lonx", "bottom_laty", "tower_lonx", "tower_laty", "atis_frequency",
+  "awos_frequency", "asos_frequency", "unicom_frequency", "lonx", "laty", "altitude",
+  "region",
+  "num_helipad", "has_avgas", "has_jetfuel", "is_closed", "is_military", "is_addon",
+  "is_3d", "num_runway_hard", "num_runway_soft", "num_runway_water", "num_approach",
+  "num_runway_light", "num_runway_end_ils", "num_apron", "num_taxi_path", "has_tower_object",
+  "num_parking_gate", "num_parking_ga_ramp", "num_parking_cargo", "num_parking_mil_cargo",
+  "num_parking_mil_combat", "num_runway_end_vasi", "num_runway_end_als", "num_runway_end_closed"
+});
+
+/* Airport columns which are missing in some queries or database versions and fall back to a default value */
+const static QStringList AIRPORT_OPTIONAL_COLUMN_NAMES({
+  "icao", "iata", "faa", "local", "rating", "type", "transition_altitude", "transition_level", "flatten", "region",
+  "num_helipad", "has_avgas", "has_jetfuel", "is_closed", "is_military", "is_addon",
+  "is_3d", "num_runway_hard", "num_runway_soft", "num_runway_water", "num_approach",
+  "num_runway_light", "num_runway_end_ils", "num_apron", "num_taxi_path", "has_tower_object",
+  "num_parking_gate", "num_parking_ga_ramp", "num_parking_cargo", "num_parking_mil_cargo",
+  "num_parking_mil_combat", "num_runway_end_vasi", "num_runway_end_als", "num_runway_end_closed"
+});
+
+/* Parking columns for SqlColumnIndex. Order has to match PARKING_COLUMN_NAMES. */
+enum ParkingColumn
+{
+  PARK_COL_PARKING_ID, PARK_COL_AIRPORT_ID, PARK_COL_TYPE, PARK_COL_NAME, PARK_COL_SUFFIX, PARK_COL_AIRLINE_CODES,
+  PARK_COL_LONX, PARK_COL_LATY, PARK_COL_HAS_JETWAY, PARK_COL_NUMBER, PARK_COL_HEADING, PARK_COL_RADIUS
+};
+
+const static QStringList PARKING_COLUMN_NAMES({
+  "parking_id", "airport_id", "type", "name", "suffix", "airline_codes",
+  "lonx", "laty", "has_jetway", "number", "heading", "radius"
+});
+
+const static QStringList PARKING_OPTIONAL_COLUMN_NAMES({"suffix"});
+
 MapTypesFactory::MapTypesFactory()
 {
 
@@ -40,40 +97,69 @@ MapTypesFactory::~MapTypesFactory()
 
 }
 
+SqlColumnIndex MapTypesFactory::airportColumns()
+{
+  return SqlColumnIndex(AIRPORT_COLUMN_NAMES, AIRPORT_OPTIONAL_COLUMN_NAMES);
+}
+
+SqlColumnIndex MapTypesFactory::parkingColumns()
+{
+  return SqlColumnIndex(PARKING_COLUMN_NAMES, PARKING_OPTIONAL_COLUMN_NAMES);
+}
+
 void MapTypesFactory::fillAirport(const SqlRecord& record, map::MapAirport& airport, bool complete, bool nav,
-                                  bool xplane)
+                                  bool xplane, SqlColumnIndex *columns)
 {
-  fillAirportBase(record, airport, complete);
+  // Resolve columns for this record only if no index is given
+  SqlColumnIndex localColumns;
+  if(columns == nullptr)
+  {
+    localColumns = airportColumns();
+    columns = &localColumns;
+  }
+  SqlColumnIndex& col = *columns;
+
+  fillAirportBase(record, airport, complete, col);
   airport.navdata = nav;
   airport.xplane = xplane;
 
   if(complete)
   {
-    airport.flags = fillAirportFlags(record, false);
-    if(record.contains("has_tower_object"))
-      airport.towerCoords = Pos(record.valueFloat("tower_lonx"), record.valueFloat("tower_laty"));
+    airport.flags = fillAirportFlags(record, false, col);
+    if(col.contains(record, AP_COL_HAS_TOWER_OBJECT))
+      airport.towerCoords = Pos(col.valueFloat(record, AP_COL_TOWER_LONX), col.valueFloat(record, AP_COL_TOWER_LATY));
 
-    airport.atisFrequency = record.valueInt("atis_frequency");
-    airport.awosFrequency = record.valueInt("awos_frequency");
-    airport.asosFrequency = record.valueInt("asos_frequency");
-    airport.unicomFrequency = record.valueInt("unicom_frequency");
+    airport.atisFrequency = col.valueInt(record, AP_COL_ATIS_FREQUENCY);
+    airport.awosFrequency = col.valueInt(record, AP_COL_AWOS_FREQUENCY);
+    airport.asosFrequency = col.valueInt(record, AP_COL_ASOS_FREQUENCY);
+    airport.unicomFrequency = col.valueInt(record, AP_COL_UNICOM_FREQUENCY);
 
-    airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), record.valueFloat("altitude"));
+    airport.position = Pos(col.valueFloat(record, AP_COL_LONX), col.valueFloat(record, AP_COL_LATY),
+                           col.valueFloat(record, AP_COL_ALTITUDE));
 
-    airport.region = record.valueStr("region", QString());
+    airport.region = col.valueStr(record, AP_COL_REGION);
   }
   else
-    airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), 0.f);
+    airport.position = Pos(col.valueFloat(record, AP_COL_LONX), col.valueFloat(record, AP_COL_LATY), 0.f);
 }
 
-void MapTypesFactory::fillAirportForOverview(const SqlRecord& record, map::MapAirport& airport, bool nav, bool xplane)
+void MapTypesFactory::fillAirportForOverview(const SqlRecord& record, map::MapAirport& airport, bool nav, bool xplane,
+                                             SqlColumnIndex *columns)
 {
-  fillAirportBase(record, airport, true);
+  SqlColumnIndex localColumns;
+  if(columns == nullptr)
+  {
+    localColumns = airportColumns();
+    columns = &localColumns;
+  }
+  SqlColumnIndex& col = *columns;
+
+  fillAirportBase(record, airport, true, col);
   airport.navdata = nav;
   airport.xplane = xplane;
 
-  airport.flags = fillAirportFlags(record, true);
-  airport.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"), 0.f);
+  airport.flags = fillAirportFlags(record, true, col);
+  airport.position = Pos(col.valueFloat(record, AP_COL_LONX), col.valueFloat(record, AP_COL_LATY), 0.f);
 }
 
 void MapTypesFactory::fillRunway(const atools::sql::SqlRecord& record, map::MapRunway& runway, bool overview)
@@ -141,75 +227,76 @@ void MapTypesFactory::fillRunwayEnd(const atools::sql::SqlRecord& record, MapRun
   end.pattern = record.valueStr("is_pattern", QString());
 }
 
-void MapTypesFactory::fillAirportBase(const SqlRecord& record, map::MapAirport& ap, bool complete)
+void MapTypesFactory::fillAirportBase(const SqlRecord& record, map::MapAirport& ap, bool complete,
+                                      SqlColumnIndex& col)
 {
-  ap.id = record.valueInt("airport_id");
+  ap.id = col.valueInt(record, AP_COL_AIRPORT_ID);
 
   if(complete)
   {
-    ap.towerFrequency = record.valueInt("tower_frequency");
-    ap.ident = record.valueStr("ident");
-    ap.icao = record.valueStr("icao", QString());
-    ap.iata = record.valueStr("iata", QString());
-    ap.faa = record.valueStr("faa", QString());
-    ap.local = record.valueStr("local", QString());
-    ap.name = record.valueStr("name");
-    ap.rating = record.valueInt("rating", -1);
-    ap.type = static_cast<map::MapAirportType>(record.valueInt("type", map::AP_TYPE_NONE));
-    ap.longestRunwayLength = record.valueInt("longest_runway_length");
-    ap.longestRunwayHeading = static_cast<int>(std::round(record.valueFloat("longest_runway_heading")));
-    ap.magvar = record.valueFloat("mag_var");
-    ap.transitionAltitude = record.valueFloat("transition_altitude", 0.f);
-    ap.transitionLevel = record.valueFloat("transition_level", 0.f);
-
-    if(record.contains("flatten"))
-      ap.flatten = record.isNull("flatten") ? -1 : record.valueInt("flatten");
-
-    ap.bounding = Rect(record.valueFloat("left_lonx"), record.valueFloat("top_laty"),
-                       record.valueFloat("right_lonx"), record.valueFloat("bottom_laty"));
+    ap.towerFrequency = col.valueInt(record, AP_COL_TOWER_FREQUENCY);
+    ap.ident = col.valueStr(record, AP_COL_IDENT);
+    ap.icao = col.valueStr(record, AP_COL_ICAO);
+    ap.iata = col.valueStr(record, AP_COL_IATA);
+    ap.faa = col.valueStr(record, AP_COL_FAA);
+    ap.local = col.valueStr(record, AP_COL_LOCAL);
+    ap.name = col.valueStr(record, AP_COL_NAME);
+    ap.rating = col.valueInt(record, AP_COL_RATING, -1);
+    ap.type = static_cast<map::MapAirportType>(col.valueInt(record, AP_COL_TYPE, map::AP_TYPE_NONE));
+    ap.longestRunwayLength = col.valueInt(record, AP_COL_LONGEST_RUNWAY_LENGTH);
+    ap.longestRunwayHeading = static_cast<int>(std::round(col.valueFloat(record, AP_COL_LONGEST_RUNWAY_HEADING)));
+    ap.magvar = col.valueFloat(record, AP_COL_MAG_VAR);
+    ap.transitionAltitude = col.valueFloat(record, AP_COL_TRANSITION_ALTITUDE, 0.f);
+    ap.transitionLevel = col.valueFloat(record, AP_COL_TRANSITION_LEVEL, 0.f);
+
+    if(col.contains(record, AP_COL_FLATTEN))
+      ap.flatten = col.isNull(record, AP_COL_FLATTEN) ? -1 : col.valueInt(record, AP_COL_FLATTEN);
+
+    ap.bounding = Rect(col.valueFloat(record, AP_COL_LEFT_LONX), col.valueFloat(record, AP_COL_TOP_LATY),
+                       col.valueFloat(record, AP_COL_RIGHT_LONX), col.valueFloat(record, AP_COL_BOTTOM_LATY));
     ap.flags |= AP_COMPLETE;
   }
 }
 
-map::MapAirportFlags MapTypesFactory::fillAirportFlags(const SqlRecord& record, bool overview)
+map::MapAirportFlags MapTypesFactory::fillAirportFlags(const SqlRecord& record, bool overview, SqlColumnIndex& col)
 {
   MapAirportFlags flags = AP_NONE;
-  flags |= airportFlag(record, "num_helipad", AP_HELIPAD);
-  flags |= airportFlag(record, "has_avgas", AP_AVGAS);
-  flags |= airportFlag(record, "has_jetfuel", AP_JETFUEL);
-  flags |= airportFlag(record, "tower_frequency", AP_TOWER);
-  flags |= airportFlag(record, "is_closed", AP_CLOSED);
-  flags |= airportFlag(record, "is_military", AP_MIL);
-  flags |= airportFlag(record, "is_addon", AP_ADDON);
-  flags |= airportFlag(record, "is_3d", AP_3D);
-  flags |= airportFlag(record, "num_runway_hard", AP_HARD);
-  flags |= airportFlag(record, "num_runway_soft", AP_SOFT);
-  flags |= airportFlag(record, "num_runway_water", AP_WATER);
+  flags |= airportFlag(record, col, AP_COL_NUM_HELIPAD, AP_HELIPAD);
+  flags |= airportFlag(record, col, AP_COL_HAS_AVGAS, AP_AVGAS);
+  flags |= airportFlag(record, col, AP_COL_HAS_JETFUEL, AP_JETFUEL);
+  flags |= airportFlag(record, col, AP_COL_TOWER_FREQUENCY, AP_TOWER);
+  flags |= airportFlag(record, col, AP_COL_IS_CLOSED, AP_CLOSED);
+  flags |= airportFlag(record, col, AP_COL_IS_MILITARY, AP_MIL);
+  flags |= airportFlag(record, col, AP_COL_IS_ADDON, AP_ADDON);
+  flags |= airportFlag(record, col, AP_COL_IS_3D, AP_3D);
+  flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_HARD, AP_HARD);
+  flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_SOFT, AP_SOFT);
+  flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_WATER, AP_WATER);
 
   if(!overview)
   {
-    flags |= airportFlag(record, "num_approach", AP_PROCEDURE);
-    flags |= airportFlag(record, "num_runway_light", AP_LIGHT);
-    flags |= airportFlag(record, "num_runway_end_ils", AP_ILS);
+    flags |= airportFlag(record, col, AP_COL_NUM_APPROACH, AP_PROCEDURE);
+    flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_LIGHT, AP_LIGHT);
+    flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_END_ILS, AP_ILS);
 
-    flags |= airportFlag(record, "num_apron", AP_APRON);
-    flags |= airportFlag(record, "num_taxi_path", AP_TAXIWAY);
-    flags |= airportFlag(record, "has_tower_object", AP_TOWER_OBJ);
+    flags |= airportFlag(record, col, AP_COL_NUM_APRON, AP_APRON);
+    flags |= airportFlag(record, col, AP_COL_NUM_TAXI_PATH, AP_TAXIWAY);
+    flags |= airportFlag(record, col, AP_COL_HAS_TOWER_OBJECT, AP_TOWER_OBJ);
 
-    flags |= airportFlag(record, "num_parking_gate", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_ga_ramp", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_cargo", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_mil_cargo", AP_PARKING);
-    flags |= airportFlag(record, "num_parking_mil_combat", AP_PARKING);
+    flags |= airportFlag(record, col, AP_COL_NUM_PARKING_GATE, AP_PARKING);
+    flags |= airportFlag(record, col, AP_COL_NUM_PARKING_GA_RAMP, AP_PARKING);
+    flags |= airportFlag(record, col, AP_COL_NUM_PARKING_CARGO, AP_PARKING);
+    flags |= airportFlag(record, col, AP_COL_NUM_PARKING_MIL_CARGO, AP_PARKING);
+    flags |= airportFlag(record, col, AP_COL_NUM_PARKING_MIL_COMBAT, AP_PARKING);
 
-    flags |= airportFlag(record, "num_runway_end_vasi", AP_VASI);
-    flags |= airportFlag(record, "num_runway_end_als", AP_ALS);
-    flags |= airportFlag(record, "num_runway_end_closed", AP_RW_CLOSED);
+    flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_END_VASI, AP_VASI);
+    flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_END_ALS, AP_ALS);
+    flags |= airportFlag(record, col, AP_COL_NUM_RUNWAY_END_CLOSED, AP_RW_CLOSED);
 
   }
   else
   {
-    if(record.valueInt("rating") > 0)
+    if(col.valueInt(record, AP_COL_RATING) > 0)
     {
       // Force non empty airports for overview results
       flags |= AP_APRON;
@@ -221,10 +308,10 @@ map::MapAirportFlags MapTypesFactory::fillAirportFlags(const SqlRecord& record,
   return flags;
 }
 
-map::MapAirportFlags MapTypesFactory::airportFlag(const SqlRecord& record, const QString& field,
+map::MapAirportFlags MapTypesFactory::airportFlag(const SqlRecord& record, SqlColumnIndex& col, int column,
                                                   map::MapAirportFlags flag)
 {
-  if(!record.contains(field) || record.isNull(field) || record.valueInt(field) == 0)
+  if(col.isNull(record, column) || col.valueInt(record, column) == 0)
     return AP_NONE;
   else
     return flag;
@@ -695,21 +782,30 @@ void MapTypesFactory::fillAirportMsa(const atools::sql::SqlRecord& record, map::
                              record.valueFloat("right_lonx"), record.valueFloat("bottom_laty"));
 }
 
-void MapTypesFactory::fillParking(const SqlRecord& record, map::MapParking& parking)
+void MapTypesFactory::fillParking(const SqlRecord& record, map::MapParking& parking, SqlColumnIndex *columns)
 {
-  parking.id = record.valueInt("parking_id");
-  parking.airportId = record.valueInt("airport_id");
-  parking.type = record.valueStr("type");
-  parking.name = record.valueStr("name");
-  parking.suffix = record.valueStr("suffix", QString());
-  parking.airlineCodes = record.valueStr("airline_codes");
-
-  parking.position = Pos(record.valueFloat("lonx"), record.valueFloat("laty"));
-  parking.jetway = record.valueInt("has_jetway") > 0;
-  parking.number = record.valueInt("number");
-
-  parking.heading = record.isNull("heading") ? map::INVALID_HEADING_VALUE : record.valueFloat("heading");
-  parking.radius = static_cast<int>(std::round(record.valueFloat("radius")));
+  SqlColumnIndex localColumns;
+  if(columns == nullptr)
+  {
+    localColumns = parkingColumns();
+    columns = &localColumns;
+  }
+  SqlColumnIndex& col = *columns;
+
+  parking.id = col.valueInt(record, PARK_COL_PARKING_ID);
+  parking.airportId = col.valueInt(record, PARK_COL_AIRPORT_ID);
+  parking.type = col.valueStr(record, PARK_COL_TYPE);
+  parking.name = col.valueStr(record, PARK_COL_NAME);
+  parking.suffix = col.valueStr(record, PARK_COL_SUFFIX);
+  parking.airlineCodes = col.valueStr(record, PARK_COL_AIRLINE_CODES);
+
+  parking.position = Pos(col.valueFloat(record, PARK_COL_LONX), col.valueFloat(record, PARK_COL_LATY));
+  parking.jetway = col.valueInt(record, PARK_COL_HAS_JETWAY) > 0;
+  parking.number = col.valueInt(record, PARK_COL_NUMBER);
+
+  parking.heading = col.isNull(record, PARK_COL_HEADING) ?
+                    map::INVALID_HEADING_VALUE : col.valueFloat(record, PARK_COL_HEADING);
+  parking.radius = static_cast<int>(std::round(col.valueFloat(record, PARK_COL_RADIUS)));
 
   // Calculate a short text if using X-Plane parking names
   if(parking.number == -1)
@@ -47,6 +47,8 @@ struct MapLogbookEntry;
 struct MapAirportMsa;
 }
 
+class SqlColumnIndex;
+
 /*
  * Create all map objects (namespace maptypes) from sql records. The sql records can be
  * a result from sql queries or manually built.
@@ -62,12 +64,20 @@ public:
    * @param complete if false only id and position are present in the record. Used for creating the object
    * based on incomplete records in the search.
    * @param nav filled from third party nav database
+   * @param columns optional column index from airportColumns() which is reused for all rows of a query.
+   * Columns are looked up by name if null.
    */
   void fillAirport(const atools::sql::SqlRecord& record, map::MapAirport& airport, bool complete, bool nav,
-                   bool xplane);
+                   bool xplane, SqlColumnIndex *columns = nullptr);
 
   /* Populate airport from queries based on the overview tables airport_medium and airport_large. */
-  void fillAirportForOverview(const atools::sql::SqlRecord& record, map::MapAirport& airport, bool nav, bool xplane);
+  void fillAirportForOverview(const atools::sql::SqlRecord& record, map::MapAirport& airport, bool nav, bool xplane,
+                              SqlColumnIndex *columns = nullptr);
+
+  /* Get column indexes for fillAirport(), fillAirportForOverview() and fillParking().
+   * Reuse the returned object for all rows of a query to avoid lookups by column name. */
+  static SqlColumnIndex airportColumns();
+  static SqlColumnIndex parkingColumns();
 
   /*
    * @param overview if true fill only fields needed for airport overview symbol (white filled runways)
@@ -89,7 +99,7 @@ public:
   void fillHolding(const atools::sql::SqlRecord& record, map::MapHolding& holding);
   void fillAirportMsa(const atools::sql::SqlRecord& record, map::MapAirportMsa& airportMsa);
 
-  void fillParking(const atools::sql::SqlRecord& record, map::MapParking& parking);
+  void fillParking(const atools::sql::SqlRecord& record, map::MapParking& parking, SqlColumnIndex *columns = nullptr);
   void fillStart(const atools::sql::SqlRecord& record, map::MapStart& start);
 
   void fillAirspace(const atools::sql::SqlRecord& record, map::MapAirspace& airspace, map::MapAirspaceSources src);
@@ -103,11 +113,11 @@ public:
 private:
   void fillVorBase(const atools::sql::SqlRecord& record, map::MapVor& vor);
 
-  void fillAirportBase(const atools::sql::SqlRecord& record, map::MapAirport& ap, bool complete);
+  void fillAirportBase(const atools::sql::SqlRecord& record, map::MapAirport& ap, bool complete, SqlColumnIndex& col);
 
-  map::MapAirportFlags airportFlag(const atools::sql::SqlRecord& record, const QString& field,
+  map::MapAirportFlags airportFlag(const atools::sql::SqlRecord& record, SqlColumnIndex& col, int column,
                                    map::MapAirportFlags airportFlag);
-  map::MapAirportFlags fillAirportFlags(const atools::sql::SqlRecord& record, bool overview);
+  map::MapAirportFlags fillAirportFlags(const atools::sql::SqlRecord& record, bool overview, SqlColumnIndex& col);
 
   map::MapType strToType(const QString& navType);
 
@@ -0,0 +1,46 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#include "common/sqlcolumnindex.h"
+
+#include <QDebug>
+
+SqlColumnIndex::SqlColumnIndex(const QStringList& columnNames, const QStringList& optionalColumnNames)
+  : names(columnNames), indexes(columnNames.size(), UNRESOLVED), optional(columnNames.size(), false)
+{
+  for(const QString& name : optionalColumnNames)
+  {
+    int column = names.indexOf(name);
+    Q_ASSERT(column != -1);
+    if(column != -1)
+      optional[column] = true;
+  }
+}
+
+void SqlColumnIndex::reset()
+{
+  indexes.fill(UNRESOLVED);
+}
+
+int SqlColumnIndex::resolve(const atools::sql::SqlRecord& record, int column)
+{
+  int idx = record.indexOf(names.at(column));
+  if(idx == -1 && !optional.at(column))
+    qWarning() << Q_FUNC_INFO << "Required column" << names.at(column) << "not found in record";
+  return idx;
+}
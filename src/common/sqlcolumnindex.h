@@ -0,0 +1,112 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+
+#ifndef LITTLENAVMAP_SQLCOLUMNINDEX_H
+#define LITTLENAVMAP_SQLCOLUMNINDEX_H
+
+#include "sql/sqlrecord.h"
+
+#include <QStringList>
+#include <QVector>
+
+/*
+ * Caches column indexes of an SQL result for a fixed list of column names to avoid lookups by name for each row.
+ * Columns are addressed by their position in the name list, usually by an enum defined by the user of this class.
+ *
+ * Indexes are resolved lazily on first access. All records passed to one instance have to come from the same
+ * query or at least have the same layout. Call reset() if the query is prepared again.
+ * Missing columns return the given default value and are reported as null. A warning is logged when a column
+ * is resolved and not found unless it is given in the list of optional columns.
+ */
+class SqlColumnIndex
+{
+public:
+  SqlColumnIndex()
+  {
+  }
+
+  /* optionalColumnNames is a subset of columnNames which can be missing depending on query or database version */
+  explicit SqlColumnIndex(const QStringList& columnNames, const QStringList& optionalColumnNames = QStringList());
+
+  /* Forget resolved indexes */
+  void reset();
+
+  /* true if column is present in record */
+  bool contains(const atools::sql::SqlRecord& record, int column)
+  {
+    return index(record, column) != -1;
+  }
+
+  /* true if column is missing or null */
+  bool isNull(const atools::sql::SqlRecord& record, int column)
+  {
+    int idx = index(record, column);
+    return idx == -1 || record.value(idx).isNull();
+  }
+
+  QVariant value(const atools::sql::SqlRecord& record, int column)
+  {
+    int idx = index(record, column);
+    return idx == -1 ? QVariant() : record.value(idx);
+  }
+
+  QString valueStr(const atools::sql::SqlRecord& record, int column, const QString& defaultValue = QString())
+  {
+    int idx = index(record, column);
+    return idx == -1 ? defaultValue : record.value(idx).toString();
+  }
+
+  int valueInt(const atools::sql::SqlRecord& record, int column, int defaultValue = 0)
+  {
+    int idx = index(record, column);
+    return idx == -1 ? defaultValue : record.value(idx).toInt();
+  }
+
+  float valueFloat(const atools::sql::SqlRecord& record, int column, float defaultValue = 0.f)
+  {
+    int idx = index(record, column);
+    return idx == -1 ? defaultValue : record.value(idx).toFloat();
+  }
+
+  bool valueBool(const atools::sql::SqlRecord& record, int column, bool defaultValue = false)
+  {
+    int idx = index(record, column);
+    return idx == -1 ? defaultValue : record.value(idx).toBool();
+  }
+
+private:
+  /* Get cached index or resolve it by name. -1 if column is not present. */
+  int index(const atools::sql::SqlRecord& record, int column)
+  {
+    int& idx = indexes[column];
+    if(idx == UNRESOLVED)
+      idx = resolve(record, column);
+    return idx;
+  }
+
+  /* Look up index by name and print a warning if a required column is missing */
+  int resolve(const atools::sql::SqlRecord& record, int column);
+
+  const static int UNRESOLVED = -2;
+
+  QStringList names;
+  QVector<int> indexes;
+  QVector<bool> optional;
+};
+
+#endif // LITTLENAVMAP_SQLCOLUMNINDEX_H
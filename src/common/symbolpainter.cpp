@@ -27,8 +27,10 @@
 #include "fs/weather/metar.h"
 #include "fs/util/fsutil.h"
 #include "fs/weather/metarparser.h"
+#include "atools.h"
 
 #include <QPainter>
+#include <QPixmap>
 #include <QStringBuilder>
 #include <marble/GeoPainter.h>
 
@@ -43,6 +45,71 @@ const QVector<QLine> AIRCRAFTLINES({QLine(0, -20, 0, 16), // Body
                                     QLine(-10, 18, 0, 14), QLine(0, 14, 10, 18) // Horizontal stabilizer
                                    });
 
+/* Larger symbols like in airport diagrams are drawn directly */
+const static float MAX_CACHED_SYMBOL_SIZE = 64.f;
+
+void SymbolPainter::setCacheGeneration(int generation)
+{
+  cacheGeneration = generation;
+}
+
+void SymbolPainter::setLabelCollisionGrid(LabelCollisionGrid *grid)
+{
+  labelCollisionGrid = grid;
+}
+
+float SymbolPainter::symbolSize(float size)
+{
+  return atools::roundToInt(size * 2.f) / 2.f;
+}
+
+quint64 SymbolPainter::symbolKey(SymbolKind kind, quint32 variant, float size, const QColor& color, bool antialiasing)
+{
+  // Bits 32-63 color, 28-31 kind, 17-27 variant, 5-16 size in half pixels, 0 antialiasing
+  quint64 sizeBits = static_cast<quint64>(atools::minmax(0, 0xfff, atools::roundToInt(size * 2.f)));
+  return static_cast<quint64>(color.rgba()) << 32 |
+         static_cast<quint64>(kind & 0xf) << 28 |
+         static_cast<quint64>(variant & 0x7ff) << 17 |
+         sizeBits << 5 |
+         static_cast<quint64>(antialiasing);
+}
+
+template<typename DRAWFUNC>
+void SymbolPainter::drawSymbolFromCache(QPainter *painter, quint64 key, float x, float y, float extent, DRAWFUNC drawFunc)
+{
+  // Pixmaps are rendered in device resolution - drop all if screen or export changes resolution
+  qreal pixelRatio = painter->device() != nullptr ? painter->device()->devicePixelRatioF() : 1.;
+  if(pixelRatio < 1.)
+    pixelRatio = 1.;
+
+  if(atools::almostNotEqual(pixelRatio, symbolPixmapsPixelRatio) || symbolPixmapsGeneration != cacheGeneration)
+  {
+    symbolPixmaps.clear();
+    symbolPixmapsPixelRatio = pixelRatio;
+    symbolPixmapsGeneration = cacheGeneration;
+  }
+
+  const QPixmap *pixmap = symbolPixmaps.object(key);
+  if(pixmap == nullptr)
+  {
+    int pixelExtent = static_cast<int>(std::ceil(extent * pixelRatio));
+    QPixmap *newPixmap = new QPixmap(pixelExtent, pixelExtent);
+    newPixmap->setDevicePixelRatio(pixelRatio);
+    newPixmap->fill(Qt::transparent);
+
+    QPainter pixmapPainter(newPixmap);
+    pixmapPainter.setRenderHint(QPainter::Antialiasing, painter->testRenderHint(QPainter::Antialiasing));
+    drawFunc(&pixmapPainter, static_cast<float>(pixelExtent / pixelRatio / 2.));
+    pixmapPainter.end();
+
+    symbolPixmaps.insert(key, newPixmap);
+    pixmap = newPixmap;
+  }
+
+  float center = static_cast<float>(pixmap->width() / pixelRatio / 2.);
+  painter->drawPixmap(QPointF(x - center, y - center), *pixmap);
+}
+
 QIcon SymbolPainter::createAirportIcon(const map::MapAirport& airport, int size)
 {
   QPixmap pixmap(size, size);
@@ -50,7 +117,7 @@ QIcon SymbolPainter::createAirportIcon(const map::MapAirport& airport, int size)
   QPainter painter(&pixmap);
   prepareForIcon(painter);
 
-  SymbolPainter().drawAirportSymbol(&painter, airport, size / 2.f, size / 2.f, size * 7.f / 10.f, false, false, false);
+  SymbolPainter().drawAirportSymbolInternal(&painter, airport, size / 2.f, size / 2.f, size * 7.f / 10.f, false, false, false, true);
   return QIcon(pixmap);
 }
 
@@ -99,7 +166,7 @@ QIcon SymbolPainter::createVorIcon(const map::MapVor& vor, int size)
   QPainter painter(&pixmap);
   prepareForIcon(painter);
 
-  SymbolPainter().drawVorSymbol(&painter, vor, size / 2, size / 2, size * 7 / 10, false, false, false);
+  SymbolPainter().drawVorSymbolInternal(&painter, vor, size / 2, size / 2, size * 7 / 10, false, false, false);
   return QIcon(pixmap);
 }
 
@@ -110,7 +177,7 @@ QIcon SymbolPainter::createNdbIcon(int size)
   QPainter painter(&pixmap);
   prepareForIcon(painter);
 
-  SymbolPainter().drawNdbSymbol(&painter, size / 2, size / 2, size * 8 / 10, false, false);
+  SymbolPainter().drawNdbSymbolInternal(&painter, size / 2, size / 2, size * 8 / 10, false, false);
   return QIcon(pixmap);
 }
 
@@ -241,6 +308,44 @@ void SymbolPainter::drawAirportSymbol(QPainter *painter, const map::MapAirport&
     // Reduce size for airports without runways and without helipads
     size = size * 4.f / 5.f;
 
+  if(size > MAX_CACHED_SYMBOL_SIZE)
+  {
+    drawAirportSymbolInternal(painter, airport, x, y, size, isAirportDiagram, fast, addonHighlight, true);
+    return;
+  }
+
+  size = symbolSize(size);
+  bool hard = airport.flags.testFlag(AP_HARD), mil = airport.flags.testFlag(AP_MIL),
+       closed = airport.flags.testFlag(AP_CLOSED), details = (!fast || isAirportDiagram) && size > 5.f;
+
+  // All flags which change the symbol appearance - runway line is rotated and drawn separately
+  quint32 variant = (hard && !mil && !closed) |
+                    (details << 1) |
+                    ((airport.anyFuel() && !mil && !closed) << 2) |
+                    (mil << 3) |
+                    (airport.waterOnly() << 4) |
+                    (airport.helipadOnly() << 5) |
+                    (closed << 6) |
+                    ((airport.addon() && addonHighlight) << 7);
+
+  // Covers addon underlay and fuel spikes
+  float extent = size * 1.6f + 14.f;
+  drawSymbolFromCache(painter, symbolKey(SYMBOL_AIRPORT, variant, size, mapcolors::colorForAirport(airport),
+                                         painter->testRenderHint(QPainter::Antialiasing)),
+                      x, y, extent, [&](QPainter *pixmapPainter, float center) {
+        drawAirportSymbolInternal(pixmapPainter, airport, center, center, size, isAirportDiagram, fast, addonHighlight, false);
+      });
+
+  if(details)
+  {
+    atools::util::PainterContextSaver saver(painter);
+    drawAirportRunwayLine(painter, airport, x, y, size);
+  }
+}
+
+void SymbolPainter::drawAirportSymbolInternal(QPainter *painter, const map::MapAirport& airport, float x, float y, float size,
+                                              bool isAirportDiagram, bool fast, bool addonHighlight, bool runwayLine)
+{
   atools::util::PainterContextSaver saver(painter);
 
   painter->setBackgroundMode(Qt::OpaqueMode);
@@ -323,22 +428,42 @@ void SymbolPainter::drawAirportSymbol(QPainter *painter, const map::MapAirport&
     }
   }
 
-  if((!fast || isAirportDiagram) && size > 5.f)
+  if(runwayLine && (!fast || isAirportDiagram) && size > 5.f)
+    drawAirportRunwayLine(painter, airport, x, y, size);
+}
+
+void SymbolPainter::drawAirportRunwayLine(QPainter *painter, const map::MapAirport& airport, float x, float y, float size)
+{
+  if(airport.flags.testFlag(AP_HARD) && !airport.flags.testFlag(AP_MIL) &&
+     !airport.flags.testFlag(AP_CLOSED) && size > 6)
   {
-    if(airport.flags.testFlag(AP_HARD) && !airport.flags.testFlag(AP_MIL) &&
-       !airport.flags.testFlag(AP_CLOSED) && size > 6)
-    {
-      // Draw line inside circle
-      painter->translate(x, y);
-      painter->rotate(airport.longestRunwayHeading);
-      painter->setPen(QPen(QBrush(mapcolors::airportSymbolFillColor), size / 5.f, Qt::SolidLine, Qt::RoundCap));
-      painter->drawLine(QLineF(0, -radius + 2, 0, radius - 2));
-      painter->resetTransform();
-    }
+    // Draw line inside circle
+    float radius = size / 2.f;
+    painter->translate(x, y);
+    painter->rotate(airport.longestRunwayHeading);
+    painter->setPen(QPen(QBrush(mapcolors::airportSymbolFillColor), size / 5.f, Qt::SolidLine, Qt::RoundCap));
+    painter->drawLine(QLineF(0, -radius + 2, 0, radius - 2));
+    painter->resetTransform();
   }
 }
 
 void SymbolPainter::drawWaypointSymbol(QPainter *painter, const QColor& col, float x, float y, float size, bool fill)
+{
+  QColor color = col.isValid() ? col : mapcolors::waypointSymbolColor;
+  if(size > MAX_CACHED_SYMBOL_SIZE)
+  {
+    drawWaypointSymbolInternal(painter, color, x, y, size, fill);
+    return;
+  }
+
+  size = symbolSize(size);
+  drawSymbolFromCache(painter, symbolKey(SYMBOL_WAYPOINT, fill, size, color, painter->testRenderHint(QPainter::Antialiasing)),
+                      x, y, size * 1.5f + 10.f, [&](QPainter *pixmapPainter, float center) {
+        drawWaypointSymbolInternal(pixmapPainter, color, center, center, size, fill);
+      });
+}
+
+void SymbolPainter::drawWaypointSymbolInternal(QPainter *painter, const QColor& color, float x, float y, float size, bool fill)
 {
   atools::util::PainterContextSaver saver(painter);
   painter->setBackgroundMode(Qt::TransparentMode);
@@ -348,8 +473,6 @@ void SymbolPainter::drawWaypointSymbol(QPainter *painter, const QColor& col, flo
     painter->setBrush(Qt::NoBrush);
 
   float lineWidth = std::max(size / 6.f, 1.5f);
-
-  QColor color = col.isValid() ? col : mapcolors::waypointSymbolColor;
   double radius = size / 2.;
 
   // Draw a triangle
@@ -890,6 +1013,25 @@ void SymbolPainter::drawProcedureFaf(QPainter *painter, float x, float y, int si
 
 void SymbolPainter::drawVorSymbol(QPainter *painter, const map::MapVor& vor, float x, float y, float size, bool routeFill, bool fast,
                                   bool largeSize)
+{
+  if((largeSize && !vor.dmeOnly) || size > MAX_CACHED_SYMBOL_SIZE)
+  {
+    // Compass rose is rotated by magnetic variation - draw vector graphics
+    drawVorSymbolInternal(painter, vor, x, y, size, routeFill, fast, largeSize);
+    return;
+  }
+
+  size = symbolSize(size);
+  quint32 variant = vor.tacan | (vor.vortac << 1) | (vor.hasDme << 2) | (vor.dmeOnly << 3) | (routeFill << 4);
+  drawSymbolFromCache(painter, symbolKey(SYMBOL_VOR, variant, size, mapcolors::vorSymbolColor,
+                                         painter->testRenderHint(QPainter::Antialiasing)),
+                      x, y, size * 2.f + 12.f, [&](QPainter *pixmapPainter, float center) {
+        drawVorSymbolInternal(pixmapPainter, vor, center, center, size, routeFill, fast, largeSize);
+      });
+}
+
+void SymbolPainter::drawVorSymbolInternal(QPainter *painter, const map::MapVor& vor, float x, float y, float size, bool routeFill,
+                                          bool fast, bool largeSize)
 {
   atools::util::PainterContextSaver saver(painter);
 
@@ -1036,6 +1178,22 @@ void SymbolPainter::drawVorSymbol(QPainter *painter, const map::MapVor& vor, flo
 }
 
 void SymbolPainter::drawNdbSymbol(QPainter *painter, float x, float y, float size, bool routeFill, bool fast)
+{
+  if(size > MAX_CACHED_SYMBOL_SIZE)
+  {
+    drawNdbSymbolInternal(painter, x, y, size, routeFill, fast);
+    return;
+  }
+
+  size = symbolSize(size);
+  drawSymbolFromCache(painter, symbolKey(SYMBOL_NDB, routeFill | (fast << 1), size, mapcolors::ndbSymbolColor,
+                                         painter->testRenderHint(QPainter::Antialiasing)),
+                      x, y, size + 10.f, [&](QPainter *pixmapPainter, float center) {
+        drawNdbSymbolInternal(pixmapPainter, center, center, size, routeFill, fast);
+      });
+}
+
+void SymbolPainter::drawNdbSymbolInternal(QPainter *painter, float x, float y, float size, bool routeFill, bool fast)
 {
   atools::util::PainterContextSaver saver(painter);
 
@@ -1099,20 +1257,23 @@ void SymbolPainter::drawMarkerSymbol(QPainter *painter, const map::MapMarker& ma
 void SymbolPainter::drawNdbText(QPainter *painter, const map::MapNdb& ndb, float x, float y,
                                 textflags::TextFlags flags, int size, bool fill, const QStringList *addtionalText)
 {
-  QStringList texts;
-
-  if(flags & textflags::IDENT && flags & textflags::TYPE)
-  {
-    if(ndb.type.isEmpty())
-      texts.append(ndb.ident);
-    else
-      texts.append(tr("%1 (%2)").arg(ndb.ident).arg(ndb.type == "CP" ? tr("CL") : ndb.type));
-  }
-  else if(flags & textflags::IDENT)
-    texts.append(ndb.ident);
-
-  if(flags & textflags::FREQ)
-    texts.append(QString::number(ndb.frequency / 100., 'f', 1));
+  auto ndbTexts = [&ndb, flags]() -> QStringList {
+                    QStringList texts;
+
+                    if(flags & textflags::IDENT && flags & textflags::TYPE)
+                    {
+                      if(ndb.type.isEmpty())
+                        texts.append(ndb.ident);
+                      else
+                        texts.append(tr("%1 (%2)").arg(ndb.ident).arg(ndb.type == "CP" ? tr("CL") : ndb.type));
+                    }
+                    else if(flags & textflags::IDENT)
+                      texts.append(ndb.ident);
+
+                    if(flags & textflags::FREQ)
+                      texts.append(QString::number(ndb.frequency / 100., 'f', 1));
+                    return texts;
+                  };
 
   textatt::TextAttributes textAttrs = textatt::NONE;
   if(flags & textflags::ROUTE_TEXT)
@@ -1124,8 +1285,10 @@ void SymbolPainter::drawNdbText(QPainter *painter, const map::MapNdb& ndb, float
     textAttrs |= textatt::CENTER;
   }
 
+  int transparency = fill ? 255 : 0;
   if(addtionalText != nullptr && !addtionalText->isEmpty())
   {
+    QStringList texts = ndbTexts();
     if(flags.testFlag(textflags::ELLIPSE_IDENT))
     {
       if(!texts.isEmpty())
@@ -1134,34 +1297,44 @@ void SymbolPainter::drawNdbText(QPainter *painter, const map::MapNdb& ndb, float
     }
     else
       texts.append(*addtionalText);
+    textBoxF(painter, texts, mapcolors::ndbSymbolColor, x, y, textAttrs, transparency);
+  }
+  else
+  {
+    LabelKey key;
+    key.type = SYMBOL_NDB;
+    key.id = ndb.id;
+    key.identHash = qHash(ndb.ident);
+    key.flags = static_cast<int>(flags);
+    textBoxCached(painter, key, ndbTexts, mapcolors::ndbSymbolColor, x, y, textAttrs, transparency);
   }
-
-  int transparency = fill ? 255 : 0;
-  textBoxF(painter, texts, mapcolors::ndbSymbolColor, x, y, textAttrs, transparency);
 }
 
 void SymbolPainter::drawVorText(QPainter *painter, const map::MapVor& vor, float x, float y,
                                 textflags::TextFlags flags, float size, bool fill, const QStringList *addtionalText)
 {
-  QStringList texts;
-
-  if(flags & textflags::IDENT && flags & textflags::TYPE)
-  {
-    if(vor.type.isEmpty())
-      texts.append(vor.ident);
-    else
-      texts.append(tr("%1 (%2)").arg(vor.ident).arg(vor.type.at(0)));
-  }
-  else if(flags & textflags::IDENT)
-    texts.append(vor.ident);
-
-  if(flags & textflags::FREQ)
-  {
-    if(!vor.tacan)
-      texts.append(QString::number(vor.frequency / 1000., 'f', 2));
-    if(vor.tacan /*|| vor.vortac*/)
-      texts.append(vor.channel);
-  }
+  auto vorTexts = [&vor, flags]() -> QStringList {
+                    QStringList texts;
+
+                    if(flags & textflags::IDENT && flags & textflags::TYPE)
+                    {
+                      if(vor.type.isEmpty())
+                        texts.append(vor.ident);
+                      else
+                        texts.append(tr("%1 (%2)").arg(vor.ident).arg(vor.type.at(0)));
+                    }
+                    else if(flags & textflags::IDENT)
+                      texts.append(vor.ident);
+
+                    if(flags & textflags::FREQ)
+                    {
+                      if(!vor.tacan)
+                        texts.append(QString::number(vor.frequency / 1000., 'f', 2));
+                      if(vor.tacan /*|| vor.vortac*/)
+                        texts.append(vor.channel);
+                    }
+                    return texts;
+                  };
 
   textatt::TextAttributes textAttrs = textatt::NONE;
   if(flags & textflags::ROUTE_TEXT)
@@ -1173,8 +1346,10 @@ void SymbolPainter::drawVorText(QPainter *painter, const map::MapVor& vor, float
     textAttrs |= textatt::RIGHT;
   }
 
+  int transparency = fill ? 255 : 0;
   if(addtionalText != nullptr && !addtionalText->isEmpty())
   {
+    QStringList texts = vorTexts();
     if(flags.testFlag(textflags::ELLIPSE_IDENT))
     {
       if(!texts.isEmpty())
@@ -1183,19 +1358,28 @@ void SymbolPainter::drawVorText(QPainter *painter, const map::MapVor& vor, float
     }
     else
       texts.append(*addtionalText);
+    textBoxF(painter, texts, mapcolors::vorSymbolColor, x, y, textAttrs, transparency);
+  }
+  else
+  {
+    LabelKey key;
+    key.type = SYMBOL_VOR;
+    key.id = vor.id;
+    key.identHash = qHash(vor.ident);
+    key.flags = static_cast<int>(flags);
+    textBoxCached(painter, key, vorTexts, mapcolors::vorSymbolColor, x, y, textAttrs, transparency);
   }
-
-  int transparency = fill ? 255 : 0;
-  textBoxF(painter, texts, mapcolors::vorSymbolColor, x, y, textAttrs, transparency);
 }
 
 void SymbolPainter::drawWaypointText(QPainter *painter, const map::MapWaypoint& wp, float x, float y,
                                      textflags::TextFlags flags, float size, bool fill, const QStringList *addtionalText)
 {
-  QStringList texts;
-
-  if(flags.testFlag(textflags::IDENT))
-    texts.append(wp.ident);
+  auto waypointTexts = [&wp, flags]() -> QStringList {
+                         QStringList texts;
+                         if(flags.testFlag(textflags::IDENT))
+                           texts.append(wp.ident);
+                         return texts;
+                       };
 
   textatt::TextAttributes textAttrs = textatt::NONE;
   if(flags.testFlag(textflags::ROUTE_TEXT))
@@ -1207,8 +1391,10 @@ void SymbolPainter::drawWaypointText(QPainter *painter, const map::MapWaypoint&
     textAttrs |= textatt::LEFT;
   }
 
+  int transparency = fill ? 255 : 0;
   if(addtionalText != nullptr && !addtionalText->isEmpty())
   {
+    QStringList texts = waypointTexts();
     if(flags.testFlag(textflags::ELLIPSE_IDENT))
     {
       if(!texts.isEmpty())
@@ -1217,47 +1403,58 @@ void SymbolPainter::drawWaypointText(QPainter *painter, const map::MapWaypoint&
     }
     else
       texts.append(*addtionalText);
+    textBoxF(painter, texts, mapcolors::waypointSymbolColor, x, y, textAttrs, transparency);
+  }
+  else
+  {
+    LabelKey key;
+    key.type = SYMBOL_WAYPOINT;
+    key.id = wp.id;
+    key.identHash = qHash(wp.ident);
+    key.flags = static_cast<int>(flags);
+    textBoxCached(painter, key, waypointTexts, mapcolors::waypointSymbolColor, x, y, textAttrs, transparency);
   }
-
-  int transparency = fill ? 255 : 0;
-  textBoxF(painter, texts, mapcolors::waypointSymbolColor, x, y, textAttrs, transparency);
 }
 
 void SymbolPainter::drawAirportText(QPainter *painter, const map::MapAirport& airport, float x, float y,
                                     optsd::DisplayOptionsAirport dispOpts, textflags::TextFlags flags, float size,
                                     bool diagram, int maxTextLength)
 {
-  // Get layer and options dependent texts
-  QStringList texts = airportTexts(dispOpts, flags, airport, maxTextLength);
-
-  if(!texts.isEmpty())
-  {
-    textatt::TextAttributes atts = textatt::NONE;
-    if(airport.addon())
-      atts |= textatt::ITALIC | textatt::UNDERLINE;
-
-    if(airport.closed())
-      atts |= textatt::STRIKEOUT;
+  textatt::TextAttributes atts = textatt::NONE;
+  if(airport.addon())
+    atts |= textatt::ITALIC | textatt::UNDERLINE;
 
-    if(flags & textflags::ROUTE_TEXT)
-      atts |= textatt::ROUTE_BG_COLOR;
+  if(airport.closed())
+    atts |= textatt::STRIKEOUT;
 
-    if(flags & textflags::LOG_TEXT)
-      atts |= textatt::LOG_BG_COLOR;
-
-    int transparency = diagram ? 180 : 255;
-    // No background for empty airports except if they are part of the route or log
-    if(airport.emptyDraw() && !(flags & textflags::ROUTE_TEXT) && !(flags & textflags::LOG_TEXT))
-      transparency = 0;
+  if(flags & textflags::ROUTE_TEXT)
+    atts |= textatt::ROUTE_BG_COLOR;
 
-    if(!flags.testFlag(textflags::ABS_POS))
-      x += size + 2.f;
+  if(flags & textflags::LOG_TEXT)
+    atts |= textatt::LOG_BG_COLOR;
 
-    if(flags & textflags::NO_BACKGROUND)
-      transparency = 0;
+  int transparency = diagram ? 180 : 255;
+  // No background for empty airports except if they are part of the route or log
+  if(airport.emptyDraw() && !(flags & textflags::ROUTE_TEXT) && !(flags & textflags::LOG_TEXT))
+    transparency = 0;
 
-    textBoxF(painter, texts, mapcolors::colorForAirport(airport), x, y, atts, transparency);
-  }
+  if(!flags.testFlag(textflags::ABS_POS))
+    x += size + 2.f;
+
+  if(flags & textflags::NO_BACKGROUND)
+    transparency = 0;
+
+  // Get layer and options dependent texts only if not cached
+  LabelKey key;
+  key.type = SYMBOL_AIRPORT;
+  key.id = airport.id;
+  key.identHash = qHash(airport.ident);
+  key.flags = static_cast<int>(flags);
+  key.options = static_cast<int>(dispOpts);
+  key.maxLength = maxTextLength;
+  textBoxCached(painter, key, [this, dispOpts, flags, &airport, maxTextLength]() -> QStringList {
+          return airportTexts(dispOpts, flags, airport, maxTextLength);
+        }, mapcolors::colorForAirport(airport), x, y, atts, transparency);
 }
 
 QStringList SymbolPainter::airportTexts(optsd::DisplayOptionsAirport dispOpts, textflags::TextFlags flags,
@@ -1323,7 +1520,97 @@ void SymbolPainter::textBoxF(QPainter *painter, const QStringList& texts, QPen t
     return;
 
   atools::util::PainterContextSaver saver(painter);
+  textBoxPrepare(painter, textPen, atts, transparency, backgroundColor);
+
+  // Draw the text
+  QFontMetricsF metrics = painter->fontMetrics();
+  float height = static_cast<float>(metrics.height()) - 1.f;
+  float yoffset = textBoxYOffset(metrics, height * texts.size(), atts);
+
+  // Draw text in reverse order to avoid undercut
+  for(int i = texts.size() - 1; i >= 0; i--)
+  {
+    const QString& text = texts.at(i);
+    if(text.isEmpty())
+      continue;
+
+    float newx = textBoxX(x, static_cast<float>(metrics.horizontalAdvance(text)), atts);
+    painter->drawText(QPointF(newx, y + yoffset), text);
+    yoffset -= height;
+  }
+}
+
+template<typename TEXTFUNC>
+void SymbolPainter::textBoxCached(QPainter *painter, LabelKey key, TEXTFUNC textFunc, QPen textPen, float x, float y,
+                                  textatt::TextAttributes atts, int transparency)
+{
+  if(labelCacheGeneration != cacheGeneration)
+  {
+    labelCache.clear();
+    labelCacheGeneration = cacheGeneration;
+  }
+
+  atools::util::PainterContextSaver saver(painter);
+  textBoxPrepare(painter, textPen, atts, transparency, QColor());
+
+  // Font including attributes is part of the key
+  const QFont font = painter->font();
+  const LabelCache::Label *label = labelCache.label(key, font);
+  if(label == nullptr)
+    label = labelCache.insert(key, font, textFunc());
+
+  if(label->isEmpty())
+    return;
+
+  QFontMetricsF metrics(font);
+  float ascent = static_cast<float>(metrics.ascent());
+  float textHeight = ascent + static_cast<float>(metrics.descent());
+  float height = static_cast<float>(metrics.height()) - 1.f;
+  float yoffset = textBoxYOffset(metrics, height * label->size(), atts);
+
+  if(labelCollisionGrid != nullptr && !atts.testFlag(textatt::ROUTE_BG_COLOR) && !atts.testFlag(textatt::LOG_BG_COLOR))
+  {
+    // Drop label if it overlaps any other label drawn before in this frame
+    QRectF rect;
+    float lineYOffset = yoffset;
+    for(int i = label->size() - 1; i >= 0; i--)
+    {
+      const LabelCache::Line& line = label->at(i);
+      if(line.text.text().isEmpty())
+        continue;
 
+      rect |= QRectF(textBoxX(x, line.width, atts), y + lineYOffset - ascent, line.width, textHeight);
+      lineYOffset -= height;
+    }
+
+    if(!labelCollisionGrid->place(rect))
+      return;
+  }
+
+  // Static text is not filled in opaque mode - draw background manually
+  bool fillBackground = painter->backgroundMode() == Qt::OpaqueMode;
+  QBrush background = painter->background();
+
+  // Draw text in reverse order to avoid undercut
+  for(int i = label->size() - 1; i >= 0; i--)
+  {
+    const LabelCache::Line& line = label->at(i);
+    if(line.text.text().isEmpty())
+      continue;
+
+    // Static text is positioned by top left corner
+    QPointF pos(textBoxX(x, line.width, atts), y + yoffset - ascent);
+    if(fillBackground)
+      painter->fillRect(QRectF(pos, QSizeF(line.width, textHeight)), background);
+
+    painter->drawStaticText(pos, line.text);
+    yoffset -= height;
+  }
+}
+
+void SymbolPainter::textBoxPrepare(QPainter *painter, QPen& textPen, textatt::TextAttributes atts, int transparency,
+                                   const QColor& backgroundColor)
+{
   QColor backColor(backgroundColor);
   if(!backColor.isValid())
   {
@@ -1394,48 +1681,32 @@ void SymbolPainter::textBoxF(QPainter *painter, const QStringList& texts, QPen t
     painter->setFont(f);
   }
 
-  // Draw the text
-  QFontMetricsF metrics = painter->fontMetrics();
-  float height = static_cast<float>(metrics.height()) - 1.f;
-  float totalHeight = height * texts.size();
-  float yoffset = 0.f;
+  painter->setPen(textPen);
+}
 
+float SymbolPainter::textBoxYOffset(const QFontMetricsF& metrics, float totalHeight, textatt::TextAttributes atts)
+{
   if(atts.testFlag(textatt::VTOP))
-  {
     // Reference point at top to place text below an icon
-    yoffset = static_cast<float>(metrics.descent()) + totalHeight;
-
-  }
+    return static_cast<float>(metrics.descent()) + totalHeight;
   else if(atts.testFlag(textatt::VBOTTOM))
-  {
     // Reference point at bottom of text stack to place text on top of an icon
-    yoffset = -static_cast<float>(metrics.descent());
-  }
+    return -static_cast<float>(metrics.descent());
   else
     // Center text vertically
-    yoffset = totalHeight / 2.f - static_cast<float>(metrics.descent());
-
-  painter->setPen(textPen);
-
-  // Draw text in reverse order to avoid undercut
-  for(int i = texts.size() - 1; i >= 0; i--)
-  {
-    const QString& text = texts.at(i);
-    if(text.isEmpty())
-      continue;
-
-    float w = static_cast<float>(metrics.horizontalAdvance(text));
-    float newx = x;
-    if(atts.testFlag(textatt::RIGHT))
-      // Reference point is at the right of the text (right-aligned) to place text at the left of an icon
-      newx -= w;
-    else if(atts.testFlag(textatt::CENTER))
-      newx -= w / 2.f;
-    // else LEFT  Reference point is at the left of the text (left-aligned) to place text at the right of an icon
+    return totalHeight / 2.f - static_cast<float>(metrics.descent());
+}
 
-    painter->drawText(QPointF(newx, y + yoffset), text);
-    yoffset -= height;
-  }
+float SymbolPainter::textBoxX(float x, float width, textatt::TextAttributes atts)
+{
+  if(atts.testFlag(textatt::RIGHT))
+    // Reference point is at the right of the text (right-aligned) to place text at the left of an icon
+    return x - width;
+  else if(atts.testFlag(textatt::CENTER))
+    return x - width / 2.f;
+  else
+    // LEFT  Reference point is at the left of the text (left-aligned) to place text at the right of an icon
+    return x;
 }
 
 QRect SymbolPainter::textBoxSize(QPainter *painter, const QStringList& texts, textatt::TextAttributes atts)
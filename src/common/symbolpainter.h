@@ -21,6 +21,7 @@
 #include "options/optiondata.h"
 
 #include "common/mapflags.h"
+#include "common/labelcache.h"
 
 #include <QColor>
 #include <QIcon>
@@ -38,6 +39,7 @@ class MetarParser;
 
 class QPainter;
 class QPen;
+class QFontMetricsF;
 
 namespace Marble {
 class GeoPainter;
@@ -164,13 +166,75 @@ public:
   void drawWindBarbs(QPainter *painter, float wind, float gust, float dir, float x, float y, float size,
                      bool windBarbs, bool altWind, bool route, bool fast) const;
 
+  /* Pre-rendered symbols and prepared labels are dropped if generation differs from the last call.
+   * Generation is increased by the map widget if colors, symbol related options or the database change. */
+  void setCacheGeneration(int generation);
+
+  /* Set grid used to drop overlapping airport and navaid labels which are not part of the flight plan or log.
+   * Null disables the check. Grid is not owned. */
+  void setLabelCollisionGrid(LabelCollisionGrid *grid);
+
 private:
+  /* Symbol types for pre-rendered symbol cache key */
+  enum SymbolKind
+  {
+    SYMBOL_AIRPORT = 1,
+    SYMBOL_VOR = 2,
+    SYMBOL_NDB = 3,
+    SYMBOL_WAYPOINT = 4
+  };
+
+  /* Vector drawing methods used to fill the cache */
+  void drawAirportSymbolInternal(QPainter *painter, const map::MapAirport& airport, float x, float y, float size,
+                                 bool isAirportDiagram, bool fast, bool addonHighlight, bool runwayLine);
+  void drawAirportRunwayLine(QPainter *painter, const map::MapAirport& airport, float x, float y, float size);
+  void drawWaypointSymbolInternal(QPainter *painter, const QColor& color, float x, float y, float size, bool fill);
+  void drawVorSymbolInternal(QPainter *painter, const map::MapVor& vor, float x, float y, float size, bool routeFill,
+                             bool fast, bool largeSize);
+  void drawNdbSymbolInternal(QPainter *painter, float x, float y, float size, bool routeFill, bool fast);
+
+  /* Draw pre-rendered symbol centered at x/y. Symbol is created using drawFunc(painter, center) if not in cache.
+   * extent is the width and height of the pixmap in logical pixels. */
+  template<typename DRAWFUNC>
+  void drawSymbolFromCache(QPainter *painter, quint64 key, float x, float y, float extent, DRAWFUNC drawFunc);
+
+  /* Key is built from color, kind, variant bits, size rounded to half pixels and antialiasing */
+  static quint64 symbolKey(SymbolKind kind, quint32 variant, float size, const QColor& color, bool antialiasing);
+
+  /* Size rounded to the resolution used in the cache key */
+  static float symbolSize(float size);
+
+  /* Draw text box using prepared label from cache. textFunc returns a QStringList and is called only if the label
+   * is not cached. */
+  template<typename TEXTFUNC>
+  void textBoxCached(QPainter *painter, LabelKey key, TEXTFUNC textFunc, QPen textPen, float x, float y,
+                     textatt::TextAttributes atts, int transparency);
+
+  /* Set background, pen and font for text box */
+  void textBoxPrepare(QPainter *painter, QPen& textPen, textatt::TextAttributes atts, int transparency,
+                      const QColor& backgroundColor);
+
+  /* Baseline offset for the last line and x position of a line depending on alignment */
+  static float textBoxYOffset(const QFontMetricsF& metrics, float totalHeight, textatt::TextAttributes atts);
+  static float textBoxX(float x, float width, textatt::TextAttributes atts);
+
+
   QStringList airportTexts(optsd::DisplayOptionsAirport dispOpts, textflags::TextFlags flags,
                            const map::MapAirport& airport, int maxTextLength);
   const QPixmap *windPointerFromCache(int size);
   const QPixmap *trackLineFromCache(int size);
 
   QCache<int, QPixmap> windPointerPixmaps, trackLinePixmaps;
+
+  /* Pre-rendered symbols. Cleared on device pixel ratio change or if cache generation changes */
+  QCache<quint64, QPixmap> symbolPixmaps{1000};
+  qreal symbolPixmapsPixelRatio = 0.;
+  int symbolPixmapsGeneration = 0, cacheGeneration = 0;
+
+  /* Prepared label texts for airports and navaids. Cleared with symbol cache. */
+  LabelCache labelCache;
+  int labelCacheGeneration = 0;
+  LabelCollisionGrid *labelCollisionGrid = nullptr;
   static void prepareForIcon(QPainter& painter);
 
   void drawWindBarbs(QPainter *painter, const atools::fs::weather::MetarParser& parsedMetar, float x, float y,
@@ -129,6 +129,12 @@ QString TextPlacement::elideText(const QString& text, const QString& arrow, floa
 }
 
 void TextPlacement::drawTextAlongOneLine(const QString& text, float bearing, const QPointF& textCoord, float textLineLength)
+{
+  drawTextAlongOneLineInternal(text, bearing, textCoord, textLineLength, QFontMetricsF(painter->font()), true);
+}
+
+void TextPlacement::drawTextAlongOneLineInternal(const QString& text, float bearing, const QPointF& textCoord, float textLineLength,
+                                                 const QFontMetricsF& metrics, bool elide)
 {
   if(!text.isEmpty() || arrowForEmpty)
   {
@@ -151,9 +157,8 @@ void TextPlacement::drawTextAlongOneLine(const QString& text, float bearing, con
     }
 
     // Draw text
-    QFontMetricsF metrics = painter->fontMetrics();
-
-    newText = elideText(newText, arrow, textLineLength);
+    if(elide)
+      newText = elideText(newText, arrow, textLineLength);
 
     if(bearing < 180.)
       newText += arrow;
@@ -186,6 +191,10 @@ void TextPlacement::drawTextAlongLines()
 {
   if(!fast)
   {
+    // Texts were elided using the left arrow - no need to elide again if the right arrow is not wider
+    QFontMetricsF metrics(painter->font());
+    bool elide = metrics.horizontalAdvance(arrowRight) > metrics.horizontalAdvance(arrowLeft);
+
     // Draw text with direction arrow along lines
     int i = 0;
     for(const QPointF& textCoord : textCoords)
@@ -193,7 +202,7 @@ void TextPlacement::drawTextAlongLines()
       if(!colors2.isEmpty() && colors2.at(i).isValid())
         painter->setPen(colors2.at(i));
 
-      drawTextAlongOneLine(texts.at(i), textBearings.at(i), textCoord, textLineLengths.at(i));
+      drawTextAlongOneLineInternal(texts.at(i), textBearings.at(i), textCoord, textLineLengths.at(i), metrics, elide);
       i++;
     }
   }
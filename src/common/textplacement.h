@@ -36,6 +36,7 @@ class Pos;
 }
 
 class QPainter;
+class QFontMetricsF;
 class CoordinateConverter;
 
 /* Contains methods for text placement along line strings. */
@@ -151,6 +152,10 @@ private:
   /* Elide text with a buffer depending on font height */
   QString elideText(const QString& text, const QString& arrow, float lineLength);
 
+  /* Skips eliding if elide is false and text is already elided by calculateTextAlongLines() */
+  void drawTextAlongOneLineInternal(const QString& text, float bearing, const QPointF& textCoord, float textLineLength,
+                                    const QFontMetricsF& metrics, bool elide);
+
   QList<QPointF> textCoords;
   QList<float> textBearings;
   QStringList texts;
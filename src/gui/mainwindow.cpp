@@ -595,7 +595,7 @@ void MainWindow::debugActionTriggered7()
 
 void MainWindow::updateMap() const
 {
-  mapWidget->update();
+  mapWidget->updateAll();
 }
 
 void MainWindow::updateClock() const
@@ -2143,7 +2143,7 @@ void MainWindow::routeNew()
   if(routeCheckForChanges())
   {
     routeController->newFlightplan();
-    mapWidget->update();
+    mapWidget->updateAll();
     showFlightPlan();
     setStatusMessage(tr("Created new empty flight plan."));
   }
@@ -2157,7 +2157,7 @@ void MainWindow::routeNewFromAirports(map::MapAirport departure, map::MapAirport
     routeController->newFlightplan();
     routeController->routeSetDeparture(departure);
     routeController->routeSetDestination(destination);
-    mapWidget->update();
+    mapWidget->updateAll();
     showFlightPlan();
     routeCenter();
     setStatusMessage(tr("Created new flight plan with departure and destination airport."));
@@ -2619,14 +2619,45 @@ bool MainWindow::createMapImage(QPixmap& pixmap, const QString& dialogTitle, con
       }
       progress.setValue(numSeconds);
 
-      // Now draw the actual image including navaids
-      QGuiApplication::setOverrideCursor(Qt::WaitCursor);
-      pixmap = paintWidget.getPixmap(exportDialog.getSize());
-      QGuiApplication::restoreOverrideCursor();
-
-      if(json != nullptr)
-        // Create Avitab reference if needed
-        *json = paintWidget.createAvitabJson();
+      QSize size = exportDialog.getSize();
+      int tileSize = atools::settings::Settings::instance().getAndStoreValue(lnm::OPTIONS_MAP_EXPORT_TILE_SIZE, 2048).toInt();
+      if(tileSize > 0 && (size.width() > tileSize || size.height() > tileSize))
+      {
+        // Large image - draw in tiles to limit widget size and allow cancellation
+        if(json != nullptr)
+          // Create Avitab reference before the view is moved for the tiles
+          *json = paintWidget.createAvitabJson();
+
+        QProgressDialog tileProgress(tr("Drawing map ..."), tr("&Cancel"), 0, 0, this);
+        tileProgress.setWindowModality(Qt::WindowModal);
+        tileProgress.setMinimumDuration(0);
+
+        QImage image = paintWidget.getImageTiled(size, tileSize, [&tileProgress](int tile, int numTiles) -> bool {
+          tileProgress.setMaximum(numTiles);
+          tileProgress.setValue(tile);
+          tileProgress.setLabelText(tr("Drawing map tile %1 of %2 ...").arg(std::min(tile + 1, numTiles)).arg(numTiles));
+          QApplication::processEvents();
+          return !tileProgress.wasCanceled();
+        });
+
+        if(image.isNull())
+        {
+          setStatusMessage(tr("Map image canceled."));
+          return false;
+        }
+        pixmap = QPixmap::fromImage(image);
+      }
+      else
+      {
+        // Now draw the actual image including navaids
+        QGuiApplication::setOverrideCursor(Qt::WaitCursor);
+        pixmap = paintWidget.getPixmap(size);
+        QGuiApplication::restoreOverrideCursor();
+
+        if(json != nullptr)
+          // Create Avitab reference if needed
+          *json = paintWidget.createAvitabJson();
+      }
     }
     PrintSupport::drawWatermark(QPoint(0, pixmap.height()), &pixmap);
     return true;
@@ -2952,7 +2983,7 @@ void MainWindow::resetMapObjectsShown()
 
   mapWidget->updateMapObjectsShown();
 
-  mapWidget->update();
+  mapWidget->updateAll();
   profileWidget->update();
 
   setStatusMessage(tr("Map settings reset."));
@@ -3217,7 +3248,7 @@ void MainWindow::mainWindowShownDelayed()
 
   // Draw map ============================================================================
   // Map widget draws gray rectangle until main window is visible
-  mapWidget->update();
+  mapWidget->updateAll();
 
   // Check for missing simulators and databases ====================================================
   DatabaseManager *databaseManager = NavApp::getDatabaseManager();
@@ -64,7 +64,7 @@ void TimeDialog::buttonBoxClicked(QAbstractButton *button)
     NavApp::getMainUi()->actionMapShowSunShadingUserTime->setChecked(true);
     MapWidget *mapWidget = NavApp::getMapWidgetGui();
     mapWidget->setSunShadingDateTime(getDateTime());
-    mapWidget->update();
+    mapWidget->updateAll();
     mapWidget->updateSunShadingOption();
 
     if(button == ui->buttonBox->button(QDialogButtonBox::Ok))
@@ -0,0 +1,139 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/airportdiagramcache.h"
+
+#include "common/coordinateconverter.h"
+#include "common/maptypes.h"
+
+#include <marble/ViewportParams.h>
+
+AirportDiagramCache::AirportDiagramCache()
+  : diagramCache(CACHE_SIZE)
+{
+
+}
+
+AirportDiagramCache::~AirportDiagramCache()
+{
+  delete converter;
+}
+
+void AirportDiagramCache::clear()
+{
+  diagramCache.clear();
+}
+
+void AirportDiagramCache::setViewportParams(const Marble::ViewportParams *viewportParams)
+{
+  if(converter != nullptr)
+    delete converter;
+
+  // Create a new converter for the viewport
+  viewport = viewportParams;
+  converter = new CoordinateConverter(viewport);
+  diagramCache.clear();
+}
+
+QPointF AirportDiagramCache::getReferencePoint(const map::MapAirport& airport) const
+{
+  Q_ASSERT(converter != nullptr);
+
+  double x, y;
+  converter->wToS(airport.position, x, y);
+  return QPointF(x, y);
+}
+
+QPointF AirportDiagramCache::relative(const atools::geo::Pos& pos, const QPointF& ref) const
+{
+  double x, y;
+  converter->wToS(pos, x, y);
+  return QPointF(x - ref.x(), y - ref.y());
+}
+
+AirportDiagramCache::Diagram *AirportDiagramCache::diagram(const map::MapAirport& airport)
+{
+  Q_ASSERT(converter != nullptr);
+
+  Diagram *diag = diagramCache.object(airport.id);
+  if(diag != nullptr && (diag->projection != viewport->projection() || diag->radius != viewport->radius()))
+  {
+    // Zoom or projection changed - project again
+    diagramCache.remove(airport.id);
+    diag = nullptr;
+  }
+
+  if(diag == nullptr)
+  {
+    diag = new Diagram;
+    diag->projection = viewport->projection();
+    diag->radius = viewport->radius();
+    diagramCache.insert(airport.id, diag);
+  }
+  return diag;
+}
+
+const QVector<QPointF>& AirportDiagramCache::getTaxiPoints(const map::MapAirport& airport,
+                                                           const QList<map::MapTaxiPath>& taxipaths)
+{
+  Diagram *diag = diagram(airport);
+  if(!diag->taxiValid)
+  {
+    QPointF ref = getReferencePoint(airport);
+    diag->taxiPoints.clear();
+    diag->taxiPoints.reserve(taxipaths.size() * 2);
+    for(const map::MapTaxiPath& taxipath : taxipaths)
+    {
+      diag->taxiPoints.append(relative(taxipath.start, ref));
+      diag->taxiPoints.append(relative(taxipath.end, ref));
+    }
+    diag->taxiValid = true;
+  }
+  return diag->taxiPoints;
+}
+
+const QVector<QPointF>& AirportDiagramCache::getParkingPoints(const map::MapAirport& airport,
+                                                              const QList<map::MapParking>& parkings)
+{
+  Diagram *diag = diagram(airport);
+  if(!diag->parkingValid)
+  {
+    QPointF ref = getReferencePoint(airport);
+    diag->parkingPoints.clear();
+    diag->parkingPoints.reserve(parkings.size());
+    for(const map::MapParking& parking : parkings)
+      diag->parkingPoints.append(relative(parking.position, ref));
+    diag->parkingValid = true;
+  }
+  return diag->parkingPoints;
+}
+
+const QVector<QPointF>& AirportDiagramCache::getHelipadPoints(const map::MapAirport& airport,
+                                                              const QList<map::MapHelipad>& helipads)
+{
+  Diagram *diag = diagram(airport);
+  if(!diag->helipadValid)
+  {
+    QPointF ref = getReferencePoint(airport);
+    diag->helipadPoints.clear();
+    diag->helipadPoints.reserve(helipads.size());
+    for(const map::MapHelipad& helipad : helipads)
+      diag->helipadPoints.append(relative(helipad.position, ref));
+    diag->helipadValid = true;
+  }
+  return diag->helipadPoints;
+}
@@ -0,0 +1,99 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_AIRPORTDIAGRAMCACHE_H
+#define LITTLENAVMAP_AIRPORTDIAGRAMCACHE_H
+
+#include <QCache>
+#include <QPointF>
+#include <QVector>
+
+class CoordinateConverter;
+namespace Marble {
+class ViewportParams;
+}
+namespace map {
+struct MapAirport;
+struct MapTaxiPath;
+struct MapParking;
+struct MapHelipad;
+
+}
+
+namespace atools {
+namespace geo {
+class Pos;
+}
+}
+
+/*
+ * Caches projected airport diagram geometry like taxi paths, parking and helipads per airport.
+ *
+ * Points are stored relative to the screen position of the airport reference point and have to be
+ * translated by getReferencePoint() for drawing. This avoids projecting thousands of points for large
+ * airports on each frame while panning. Geometry is projected again if zoom or projection change.
+ */
+class AirportDiagramCache
+{
+public:
+  AirportDiagramCache();
+  ~AirportDiagramCache();
+
+  AirportDiagramCache(const AirportDiagramCache& other) = delete;
+  AirportDiagramCache& operator=(const AirportDiagramCache& other) = delete;
+
+  /* Screen position of the airport reference point for the current viewport */
+  QPointF getReferencePoint(const map::MapAirport& airport) const;
+
+  /* Start and end points of all taxi paths alternating and in order of the list */
+  const QVector<QPointF>& getTaxiPoints(const map::MapAirport& airport, const QList<map::MapTaxiPath>& taxipaths);
+
+  /* Parking and helipad positions in order of the list */
+  const QVector<QPointF>& getParkingPoints(const map::MapAirport& airport, const QList<map::MapParking>& parkings);
+  const QVector<QPointF>& getHelipadPoints(const map::MapAirport& airport, const QList<map::MapHelipad>& helipads);
+
+  /* Clear the cache */
+  void clear();
+
+  /* Has to be set before using it */
+  void setViewportParams(const Marble::ViewportParams *viewportParams);
+
+private:
+  /* Projected geometry of one airport */
+  struct Diagram
+  {
+    int projection, radius;
+    QVector<QPointF> taxiPoints, parkingPoints, helipadPoints;
+    bool taxiValid = false, parkingValid = false, helipadValid = false;
+  };
+
+  /* Get geometry for airport. Creates an empty entry if not found or if zoom or projection changed. */
+  Diagram *diagram(const map::MapAirport& airport);
+
+  /* Convert position to screen coordinates relative to reference */
+  QPointF relative(const atools::geo::Pos& pos, const QPointF& ref) const;
+
+  /* Number of airports */
+  static const int CACHE_SIZE = 50;
+
+  /* Used to convert world to screen coordinates */
+  CoordinateConverter *converter = nullptr;
+  const Marble::ViewportParams *viewport = nullptr;
+  QCache<int, Diagram> diagramCache;
+};
+
+#endif // LITTLENAVMAP_AIRPORTDIAGRAMCACHE_H
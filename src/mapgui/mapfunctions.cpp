@@ -22,6 +22,7 @@
 #include "mapgui/maplayer.h"
 #include "navapp.h"
 
+#include <QRectF>
 #include <QVector>
 
 namespace mapfunc {
@@ -43,4 +44,94 @@ bool aircraftVisible(const atools::fs::sc::SimConnectAircraft& ac, const MapLaye
   return show;
 }
 
+/* Clip polygon against one border of the rectangle */
+template<typename INSIDE, typename INTERSECT>
+void clipBorder(QPolygonF& out, const QPolygonF& in, INSIDE inside, INTERSECT intersect)
+{
+  out.clear();
+  if(in.isEmpty())
+    return;
+
+  QPointF prev = in.last();
+  bool prevInside = inside(prev);
+  for(const QPointF& cur : in)
+  {
+    bool curInside = inside(cur);
+    if(curInside != prevInside)
+      // Edge crosses the border
+      out.append(intersect(prev, cur));
+    if(curInside)
+      out.append(cur);
+
+    prev = cur;
+    prevInside = curInside;
+  }
+}
+
+QPolygonF clipPolygon(const QPolygonF& polygon, const QRectF& rect)
+{
+  const double left = rect.left(), right = rect.right(), top = rect.top(), bottom = rect.bottom();
+
+  // Intersection of edge p1 to p2 with vertical or horizontal line - only called if edge crosses
+  auto intersectX = [](const QPointF& p1, const QPointF& p2, double x) -> QPointF {
+                      return QPointF(x, p1.y() + (x - p1.x()) * (p2.y() - p1.y()) / (p2.x() - p1.x()));
+                    };
+  auto intersectY = [](const QPointF& p1, const QPointF& p2, double y) -> QPointF {
+                      return QPointF(p1.x() + (y - p1.y()) * (p2.x() - p1.x()) / (p2.y() - p1.y()), y);
+                    };
+
+  // Return polygon unchanged if completely inside
+  if(rect.contains(polygon.boundingRect()))
+    return polygon;
+
+  QPolygonF in(polygon), out;
+  out.reserve(polygon.size() + 4);
+
+  clipBorder(out, in, [left](const QPointF& p) -> bool {
+                return p.x() >= left;
+              }, [left, &intersectX](const QPointF& p1, const QPointF& p2) -> QPointF {
+                return intersectX(p1, p2, left);
+              });
+  std::swap(in, out);
+
+  clipBorder(out, in, [right](const QPointF& p) -> bool {
+                return p.x() <= right;
+              }, [right, &intersectX](const QPointF& p1, const QPointF& p2) -> QPointF {
+                return intersectX(p1, p2, right);
+              });
+  std::swap(in, out);
+
+  clipBorder(out, in, [top](const QPointF& p) -> bool {
+                return p.y() >= top;
+              }, [top, &intersectY](const QPointF& p1, const QPointF& p2) -> QPointF {
+                return intersectY(p1, p2, top);
+              });
+  std::swap(in, out);
+
+  clipBorder(out, in, [bottom](const QPointF& p) -> bool {
+                return p.y() <= bottom;
+              }, [bottom, &intersectY](const QPointF& p1, const QPointF& p2) -> QPointF {
+                return intersectY(p1, p2, bottom);
+              });
+
+  return out;
+}
+
+void simplifyPolygon(QPolygonF& polygon, double tolerance)
+{
+  if(polygon.size() < 4)
+    return;
+
+  const double toleranceSq = tolerance * tolerance;
+  int kept = 1;
+  for(int i = 1; i < polygon.size() - 1; i++)
+  {
+    QPointF diff = polygon.at(i) - polygon.at(kept - 1);
+    if(QPointF::dotProduct(diff, diff) >= toleranceSq)
+      polygon[kept++] = polygon.at(i);
+  }
+  polygon[kept++] = polygon.last();
+  polygon.resize(kept);
+}
+
 } // namespace mapfunc
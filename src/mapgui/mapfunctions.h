@@ -18,6 +18,8 @@
 #ifndef LNM_MAPFUNCTIONS_H
 #define LNM_MAPFUNCTIONS_H
 
+#include <QPolygonF>
+
 namespace atools {
 namespace fs {
 namespace sc {
@@ -36,6 +38,13 @@ namespace mapfunc {
 /* True if aircraft is visible for current layer and aicraft properties */
 bool aircraftVisible(const atools::fs::sc::SimConnectAircraft& ac, const MapLayer *layer);
 
+/* Clip polygon against rectangle using the Sutherland-Hodgman algorithm.
+ * Parts outside are replaced by points on the rectangle border. Returns an empty polygon if nothing is inside. */
+QPolygonF clipPolygon(const QPolygonF& polygon, const QRectF& rect);
+
+/* Remove all points which are closer than tolerance to the previous kept point. First and last point are kept. */
+void simplifyPolygon(QPolygonF& polygon, double tolerance);
+
 } // namespace mapfunc
 
 #endif // LNM_MAPFUNCTIONS_H
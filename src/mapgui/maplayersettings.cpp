@@ -19,6 +19,7 @@
 
 #include "common/constants.h"
 #include "exception.h"
+#include "mapgui/mappaintwidget.h"
 #include "settings/settings.h"
 #include "util/filesystemwatcher.h"
 #include "util/xmlstream.h"
@@ -27,7 +28,6 @@
 #include <functional>
 
 #include <QFileInfo>
-#include <QWidget>
 #include <QXmlStreamReader>
 
 MapLayerSettings::MapLayerSettings(bool verbose)
@@ -42,10 +42,10 @@ MapLayerSettings::~MapLayerSettings()
   delete fileWatcher;
 }
 
-void MapLayerSettings::connectMapSettingsUpdated(QWidget *mapWidget)
+void MapLayerSettings::connectMapSettingsUpdated(MapPaintWidget *mapWidget)
 {
   // Update widget on file change
-  connect(this, &MapLayerSettings::mapSettingsChanged, mapWidget, QOverload<>::of(&QWidget::update));
+  connect(this, &MapLayerSettings::mapSettingsChanged, mapWidget, &MapPaintWidget::updateAll);
 }
 
 MapLayerSettings& MapLayerSettings::append(const MapLayer& layer)
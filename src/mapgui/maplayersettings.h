@@ -30,6 +30,8 @@ class FileSystemWatcher;
 }
 }
 
+class MapPaintWidget;
+
 /*
  * A list of map layers that defines what is painted at what zoom distance.
  * The configuration is loaded from a XML file.
@@ -59,7 +61,7 @@ public:
   void loadFromFile();
 
   /* Connect a widget which is updated on file change */
-  void connectMapSettingsUpdated(QWidget *mapWidget);
+  void connectMapSettingsUpdated(MapPaintWidget *mapWidget);
 
   static Q_DECL_CONSTEXPR int MAP_DEFAULT_DETAIL_LEVEL = 10;
   static Q_DECL_CONSTEXPR int MAP_MAX_DETAIL_LEVEL = 15;
@@ -20,6 +20,7 @@
 #include "mapgui/mapthemehandler.h"
 #include "navapp.h"
 #include "mappainter/mappaintlayer.h"
+#include "mappainter/mappaintertop.h"
 #include "mapgui/mapscale.h"
 #include "common/maptools.h"
 #include "route/route.h"
@@ -30,6 +31,7 @@
 #include "common/unit.h"
 #include "common/aircrafttrack.h"
 #include "mapgui/aprongeometrycache.h"
+#include "mapgui/airportdiagramcache.h"
 #include "query/mapquery.h"
 #include "query/airwayquery.h"
 #include "query/airwaytrackquery.h"
@@ -46,12 +48,17 @@
 #include <marble/MarbleLocale.h>
 #include <marble/MarbleModel.h>
 #include <marble/AbstractFloatItem.h>
+#include <marble/AbstractProjection.h>
+#include <marble/ViewportParams.h>
 
 // KM
 const static double MINIMUM_DISTANCE_KM = 0.05;
 const static double MAXIMUM_DISTANCE_KM = 6000.;
 const static int MAXIMUM_ZOOM = 1120;
 
+/* Additional pixels around each tile for MapPaintWidget::getImageTiled to draw labels of objects outside */
+const static int TILE_MARGIN = 256;
+
 // Placemark files to remove or add
 const static QStringList PLACEMARK_FILES_CACHE({
   "baseplacemarks.cache", "boundaryplacemarks.cache", "cityplacemarks.cache", "elevplacemarks.cache",
@@ -96,6 +103,9 @@ MapPaintWidget::MapPaintWidget(QWidget *parent, bool visible)
   apronGeometryCache = new ApronGeometryCache();
   apronGeometryCache->setViewportParams(viewport());
 
+  airportDiagramCache = new AirportDiagramCache();
+  airportDiagramCache->setViewportParams(viewport());
+
   mapQuery = new MapQuery(NavApp::getDatabaseSim(), NavApp::getDatabaseNav(), NavApp::getDatabaseUser());
   mapQuery->initQueries();
 
@@ -138,6 +148,9 @@ MapPaintWidget::~MapPaintWidget()
   qDebug() << Q_FUNC_INFO << "delete apronGeometryCache";
   delete apronGeometryCache;
 
+  qDebug() << Q_FUNC_INFO << "delete airportDiagramCache";
+  delete airportDiagramCache;
+
   qDebug() << Q_FUNC_INFO << "delete mapQuery";
   delete mapQuery;
 }
@@ -293,6 +306,9 @@ void MapPaintWidget::optionsChanged()
 
   setFont(options.getMapFont());
 
+  // Redraw symbols using changed colors and sizes
+  symbolCacheGeneration++;
+
   unitsUpdated();
 
   // Updated sun shadow and force a tile refresh by changing the show status again
@@ -302,12 +318,26 @@ void MapPaintWidget::optionsChanged()
 
   // reloadMap();
   updateCacheSizes();
-  update();
+  updateAll();
+}
+
+void MapPaintWidget::updateAll()
+{
+  if(paintLayer != nullptr)
+    paintLayer->invalidateLayerCache();
+  MarbleWidget::update();
+}
+
+void MapPaintWidget::updateDynamic()
+{
+  MarbleWidget::update();
 }
 
 void MapPaintWidget::styleChanged()
 {
-  update();
+  // Symbol colors might have changed
+  symbolCacheGeneration++;
+  updateAll();
 }
 
 void MapPaintWidget::updateCacheSizes()
@@ -335,7 +365,7 @@ void MapPaintWidget::setShowMapSunShading(bool show)
 void MapPaintWidget::weatherUpdated()
 {
   if(paintLayer->getShownMapObjectDisplayTypes().testFlag(map::AIRPORT_WEATHER))
-    update();
+    updateAll();
 
   updateMapVisibleUi();
 }
@@ -344,7 +374,7 @@ void MapPaintWidget::windDisplayUpdated()
 {
   if(paintLayer->getShownMapObjectDisplayTypes().testFlag(map::WIND_BARBS) ||
      paintLayer->getShownMapObjectDisplayTypes().testFlag(map::WIND_BARBS_ROUTE))
-    update();
+    updateAll();
 
   updateMapVisibleUi();
 }
@@ -365,7 +395,7 @@ void MapPaintWidget::setSunShadingDateTime(const QDateTime& datetime)
   {
     // Update only if difference more than 5 minutes
     model()->setClockDateTime(datetime);
-    update();
+    updateAll();
   }
 }
 
@@ -497,6 +527,7 @@ void MapPaintWidget::preDatabaseLoad()
   cancelDragAll();
   databaseLoadStatus = true;
   apronGeometryCache->clear();
+  airportDiagramCache->clear();
   paintLayer->preDatabaseLoad();
   mapQuery->deInitQueries();
   airwayTrackQuery->deInitQueries();
@@ -511,8 +542,11 @@ void MapPaintWidget::postDatabaseLoad()
   waypointTrackQuery->initQueries();
   mapQuery->initQueries();
   paintLayer->postDatabaseLoad();
+
+  // Drop cached labels since ids might be reused
+  symbolCacheGeneration++;
   screenIndex->updateAllGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
   updateMapVisibleUi();
 }
 
@@ -624,6 +658,137 @@ QPixmap MapPaintWidget::getPixmap(const QSize& size)
   return getPixmap(size.width(), size.height());
 }
 
+QImage MapPaintWidget::getImageTiled(const QSize& size, int tileSize,
+                                     const std::function<bool(int tile, int numTiles)>& progress)
+{
+  // Update viewport to the size of the complete image
+  if(this->size() != size)
+    prepareDraw(size.width(), size.height());
+
+  if(projection() == Marble::Spherical)
+  {
+    if(!progress(0, 1))
+      return QImage();
+
+    QImage image = getPixmap(size).toImage();
+    progress(1, 1);
+    return image;
+  }
+
+  // Use even values to keep the center pixel of the tiles and the complete image consistent
+  tileSize = std::max(tileSize, 256) & ~1;
+  QSize tileWidgetSize(tileSize + 2 * TILE_MARGIN, tileSize + 2 * TILE_MARGIN);
+
+  // Get screen rows covered by the map in the complete view - e.g. limited by the Mercator latitude ==========
+  // Use a latitude slightly inside the limits to get valid coordinates at the edges
+  const Marble::AbstractProjection *proj = viewport()->currentProjection();
+  qreal maxLatDeg = proj->maxValidLat() * RAD2DEG - 0.001, minLatDeg = proj->minValidLat() * RAD2DEG + 0.001;
+  qreal xs, mapTop = 0., mapBottom = size.height() - 1;
+  screenCoordinates(centerLongitude(), maxLatDeg, xs, mapTop);
+  screenCoordinates(centerLongitude(), minLatDeg, xs, mapBottom);
+  int mapTopInt = static_cast<int>(std::ceil(mapTop)), mapBottomInt = static_cast<int>(std::floor(mapBottom));
+
+  // Get tile rectangles and the coordinates of the tile widget centers from the complete view ============
+  struct Tile
+  {
+    QRect rect;
+    QRect widgetRect; /* Area covered by the tile widget in coordinates of the complete image */
+    qreal lonX, latY;
+    bool valid;
+  };
+
+  QVector<Tile> tiles;
+  for(int y = 0; y < size.height(); y += tileSize)
+  {
+    for(int x = 0; x < size.width(); x += tileSize)
+    {
+      Tile tile;
+      tile.rect = QRect(x, y, std::min(tileSize, size.width() - x), std::min(tileSize, size.height() - y));
+
+      // Move the widget center onto the map if the tile center is beyond the latitude limits.
+      // The part of the tile which is on the map is still covered by the widget since the widget is larger
+      // than the tile and the center moves less than half a tile.
+      int centerX = x + tileSize / 2;
+      int centerY = atools::minmax(mapTopInt, mapBottomInt, y + tileSize / 2);
+      tile.widgetRect = QRect(centerX - tileWidgetSize.width() / 2, centerY - tileWidgetSize.height() / 2,
+                              tileWidgetSize.width(), tileWidgetSize.height());
+
+      // Skip only tiles which are completely off the map
+      tile.valid = tile.rect.bottom() >= mapTopInt && tile.rect.top() <= mapBottomInt &&
+                   geoCoordinates(centerX, centerY, tile.lonX, tile.latY, GeoDataCoordinates::Degree);
+      tiles.append(tile);
+    }
+  }
+
+  // Center tiles with the same zoom and copy them into the image ======================
+  bool keepWorldRectSaved = keepWorldRect;
+  keepWorldRect = false;
+
+  // Copyright is drawn once into the complete image and not into each tile
+  bool paintCopyrightSaved = paintCopyright;
+  paintCopyright = false;
+  qreal centerLonSaved = centerLongitude(), centerLatSaved = centerLatitude();
+  int radiusSaved = radius();
+
+  // Tiles off the map keep the background
+  qreal ratio = devicePixelRatioF();
+  QImage image(size * ratio, QImage::Format_RGB32);
+  image.setDevicePixelRatio(ratio);
+  image.fill(Qt::black);
+
+  QPainter painter(&image);
+  bool canceled = false;
+  for(int i = 0; i < tiles.size(); i++)
+  {
+    if(!progress(i, tiles.size()))
+    {
+      canceled = true;
+      break;
+    }
+
+    const Tile& tile = tiles.at(i);
+    if(!tile.valid)
+      continue;
+
+    centerOn(tile.lonX, tile.latY, false /* animated */);
+    setRadius(radiusSaved);
+    QPixmap pixmap = getPixmap(tileWidgetSize);
+
+    // Copy the part of the tile covered by the widget - all of it unless the center was moved onto the map
+    QRect target = tile.rect.intersected(tile.widgetRect);
+    QRect source = target.translated(-tile.widgetRect.topLeft());
+    qreal pixmapRatio = pixmap.devicePixelRatio();
+    painter.drawPixmap(QRectF(target), pixmap,
+                       QRectF(source.x() * pixmapRatio, source.y() * pixmapRatio,
+                              source.width() * pixmapRatio, source.height() * pixmapRatio));
+
+    if(verbose)
+      qDebug() << Q_FUNC_INFO << "tile" << i << "of" << tiles.size() << tile.rect;
+  }
+
+  paintCopyright = paintCopyrightSaved;
+  if(paintCopyright && !canceled)
+  {
+    QString mapCopyright = NavApp::getMapThemeHandler()->getTheme(currentThemeId).getCopyright();
+    if(!mapCopyright.isEmpty())
+      MapPainterTop::drawCopyright(&painter, mapCopyright, QRect(QPoint(0, 0), size), visibleWidget);
+  }
+
+  painter.end();
+
+  // Restore view of the complete image
+  resize(size);
+  centerOn(centerLonSaved, centerLatSaved, false /* animated */);
+  setRadius(radiusSaved);
+  keepWorldRect = keepWorldRectSaved;
+
+  if(canceled)
+    return QImage();
+
+  progress(tiles.size(), tiles.size());
+  return image;
+}
+
 atools::geo::Pos MapPaintWidget::getCurrentViewCenterPos() const
 {
   return atools::geo::Pos(centerLongitude(), centerLatitude(), distance());
@@ -887,7 +1052,7 @@ void MapPaintWidget::showAircraft(bool centerAircraftChecked)
 void MapPaintWidget::changeRouteHighlights(const QList<int>& routeHighlight)
 {
   screenIndex->setRouteHighlights(routeHighlight);
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::routeChanged(bool geometryChanged)
@@ -900,7 +1065,7 @@ void MapPaintWidget::routeChanged(bool geometryChanged)
     screenIndex->updateRouteScreenGeometry(getCurrentViewBoundingBox());
   }
   screenIndex->updateIlsScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::routeAltitudeChanged(float)
@@ -910,14 +1075,14 @@ void MapPaintWidget::routeAltitudeChanged(float)
 
   qDebug() << Q_FUNC_INFO;
   screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::connectedToSimulator()
 {
   qDebug() << Q_FUNC_INFO;
   jumpBackToAircraftCancel();
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::disconnectedFromSimulator()
@@ -927,7 +1092,7 @@ void MapPaintWidget::disconnectedFromSimulator()
   screenIndex->clearSimData();
   updateMapVisibleUi();
   jumpBackToAircraftCancel();
-  update();
+  updateAll();
 }
 
 bool MapPaintWidget::addKmlFile(const QString& kmlFile)
@@ -962,21 +1127,21 @@ void MapPaintWidget::clearSearchHighlights()
 
   screenIndex->updateLogEntryScreenGeometry(getCurrentViewBoundingBox());
   screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::clearAirspaceHighlights()
 {
   screenIndex->changeAirspaceHighlights(QList<map::MapAirspace>());
   screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::clearAirwayHighlights()
 {
   screenIndex->changeAirwayHighlights(QList<QList<map::MapAirway> >());
   screenIndex->updateAirwayScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 bool MapPaintWidget::hasHighlights() const
@@ -1024,7 +1189,7 @@ void MapPaintWidget::changeProcedureHighlights(const QVector<proc::MapProcedureL
   cancelDragAll();
   screenIndex->setProcedureHighlights(procedures);
   screenIndex->updateRouteScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 const proc::MapProcedureLegs& MapPaintWidget::getProcedureHighlight() const
@@ -1041,13 +1206,13 @@ void MapPaintWidget::changeProcedureHighlight(const proc::MapProcedureLegs& proc
   cancelDragAll();
   screenIndex->setProcedureHighlight(procedure);
   screenIndex->updateRouteScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::changeProcedureLegHighlight(const proc::MapProcedureLeg& procedureLeg)
 {
   screenIndex->setProcedureLegHighlight(procedureLeg);
-  update();
+  updateAll();
 }
 
 /* Also clicked airspaces in the info window */
@@ -1055,7 +1220,7 @@ void MapPaintWidget::changeAirspaceHighlights(const QList<map::MapAirspace>& air
 {
   screenIndex->changeAirspaceHighlights(airspaces);
   screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 /* Also clicked airways in the info window */
@@ -1063,7 +1228,7 @@ void MapPaintWidget::changeAirwayHighlights(const QList<QList<map::MapAirway> >&
 {
   screenIndex->changeAirwayHighlights(airways);
   screenIndex->updateAirwayScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::updateLogEntryScreenGeometry()
@@ -1079,7 +1244,7 @@ void MapPaintWidget::changeSearchHighlights(const map::MapResult& newHighlights,
     screenIndex->updateLogEntryScreenGeometry(getCurrentViewBoundingBox());
   if(updateAirspace)
     screenIndex->updateAirspaceScreenGeometry(getCurrentViewBoundingBox());
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::changeProfileHighlight(const atools::geo::Pos& pos)
@@ -1087,7 +1252,7 @@ void MapPaintWidget::changeProfileHighlight(const atools::geo::Pos& pos)
   if(pos != screenIndex->getProfileHighlight())
   {
     screenIndex->setProfileHighlight(pos);
-    update();
+    updateAll();
   }
 }
 
@@ -1332,12 +1497,12 @@ bool MapPaintWidget::loadKml(const QString& filename, bool center)
 void MapPaintWidget::onlineClientAndAtcUpdated()
 {
   screenIndex->updateAirspaceScreenGeometry(currentViewBoundingBox);
-  update();
+  updateAll();
 }
 
 void MapPaintWidget::onlineNetworkChanged()
 {
   screenIndex->resetAirspaceOnlineScreenGeometry();
   screenIndex->updateAirspaceScreenGeometry(currentViewBoundingBox);
-  update();
+  updateAll();
 }
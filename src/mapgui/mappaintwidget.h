@@ -24,6 +24,8 @@
 #include <marble/GeoDataLatLonAltBox.h>
 #include <marble/MarbleWidget.h>
 
+#include <functional>
+
 namespace map {
 struct MapResult;
 struct MapObjectRef;
@@ -59,6 +61,7 @@ class MainWindow;
 class MapPaintLayer;
 class MapScreenIndex;
 class ApronGeometryCache;
+class AirportDiagramCache;
 class MapQuery;
 class AirwayTrackQuery;
 class WaypointTrackQuery;
@@ -100,6 +103,14 @@ public:
   /* Copies the bounding rectangle to this one which will be centered on next resize. */
   void copyView(const MapPaintWidget& other);
 
+  /* Drops the cached static map layers and redraws the map since anything might have changed.
+   * Use this instead of QWidget::update() which only repaints and might reuse cached layers. */
+  void updateAll();
+
+  /* Redraw map for changes in user aircraft, AI, trail and marks only.
+   * Static layers like airports and navaids are reused if the view did not change. */
+  void updateDynamic();
+
   /* streamlined for webmapcontroller from showPosInternal(pos, distanceKm, doubleClick, false) */
   void showPosNotAdjusted(const atools::geo::Pos& pos, float distanceKm);
 
@@ -321,6 +332,13 @@ public:
   /* Prepare Marble widget drawing with a dummy paint event without drawing navaids */
   void prepareDraw(int width, int height);
 
+  /* Render the current view into an image of the given size by drawing tiles with the given maximum size
+   * and copying them together. Limits the widget size and allows progress and cancellation for large images.
+   * Tiles are rendered with a margin to avoid cut off labels at the seams.
+   * progress is called with tile index and number of tiles before each tile. Returns a null image if it returns false.
+   * Falls back to a single image for the spherical projection since tiles cannot be aligned there. */
+  QImage getImageTiled(const QSize& size, int tileSize, const std::function<bool(int tile, int numTiles)>& progress);
+
   bool isAvoidBlurredMap() const
   {
     return avoidBlurredMap;
@@ -350,6 +368,12 @@ public:
     return paintCopyright;
   }
 
+  /* Increased if pre-rendered symbols and labels of all painters of this widget have to be dropped */
+  int getSymbolCacheGeneration() const
+  {
+    return symbolCacheGeneration;
+  }
+
   void setPaintCopyright(bool value)
   {
     paintCopyright = value;
@@ -357,6 +381,11 @@ public:
 
   ApronGeometryCache *getApronGeometryCache();
 
+  AirportDiagramCache *getAirportDiagramCache()
+  {
+    return airportDiagramCache;
+  }
+
   /* true if real map display widget - false if hidden for online services or other applications */
   bool isVisibleWidget() const
   {
@@ -506,6 +535,9 @@ protected:
   /* Caches complex X-Plane apron geometry as objects in screen coordinates for faster painting. */
   ApronGeometryCache *apronGeometryCache;
 
+  /* Caches projected taxi paths, parking and helipads of airport diagrams for faster painting. */
+  AirportDiagramCache *airportDiagramCache;
+
   /* Keep the the overlays for the GUI widget from updating */
   bool ignoreOverlayUpdates = false;
 
@@ -519,7 +551,7 @@ protected:
   /* Loaded KML file paths */
   QStringList kmlFilePaths;
 
-  MapPaintLayer *paintLayer;
+  MapPaintLayer *paintLayer = nullptr;
 
   /* Do not draw while database is unavailable */
   bool databaseLoadStatus = false;
@@ -548,6 +580,9 @@ protected:
   /* Paint copyright note into image */
   bool paintCopyright = true;
 
+  /* Passed to painters through the paint context. Increased on options, style and database changes. */
+  int symbolCacheGeneration = 0;
+
   /* Map theme id. */
   QString currentThemeId;
 
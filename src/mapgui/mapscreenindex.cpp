@@ -52,6 +52,9 @@ using atools::fs::sc::SimConnectData;
 // Calculate averages for ground speed and turn speed for 2 seconds
 const static qint64 TURN_PATH_AVERAGE_TIME_MS = 2000L;
 
+/* Airspace outline points closer than this are merged for the mouse over index */
+const static double AIRSPACE_SIMPLIFY_PIXEL = 2.;
+
 template<typename TYPE>
 void assignIdAndInsert(const QString& settingsName, QHash<int, TYPE>& hash)
 {
@@ -119,14 +122,23 @@ void MapScreenIndex::copy(const MapScreenIndex& other)
   airwayLines = other.airwayLines;
   logEntryLines = other.logEntryLines;
   airspacePolygons = other.airspacePolygons;
+  airspacePolygonsValid = other.airspacePolygonsValid;
+  airspacePolygonsBox = other.airspacePolygonsBox;
   ilsPolygons = other.ilsPolygons;
   ilsLines = other.ilsLines;
   routePointsEditable = other.routePointsEditable;
   routePointsAll = other.routePointsAll;
+
+  routeLinesGrid = other.routeLinesGrid;
+  airwayLinesGrid = other.airwayLinesGrid;
+  logEntryLinesGrid = other.logEntryLinesGrid;
+  airspacePolygonsGrid = other.airspacePolygonsGrid;
+  ilsPolygonsGrid = other.ilsPolygonsGrid;
+  ilsLinesGrid = other.ilsLinesGrid;
 }
 
 void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids, map::MapAirspaceSources source,
-                                                          const Marble::GeoDataLatLonBox& curBox, bool highlights)
+                                                          const Marble::GeoDataLatLonBox& curBox, bool highlights) const
 {
   const MapScale *scale = paintLayer->getMapScale();
   AirspaceController *controller = NavApp::getAirspaceController();
@@ -159,6 +171,7 @@ void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceI
     }
 
     CoordinateConverter conv(mapWidget->viewport());
+    const QRectF screenRect(mapWidget->rect());
     for(const map::MapAirspace *airspace : airspaces)
     {
       if(!(airspace->type & mapWidget->getShownAirspaceTypesByLayer().types) && !highlights)
@@ -175,10 +188,13 @@ void MapScreenIndex::updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceI
         {
           QVector<QPolygonF> polygons = conv.wToS(*lines);
 
-          for(const QPolygonF& poly : polygons)
+          for(QPolygonF& poly : polygons)
           {
-            // Cut off all polygon parts that are not visible on screen
-            airspacePolygons.append(std::make_pair(airspace->combinedId(), poly.intersected(QPolygon(mapWidget->rect())).toPolygon()));
+            // Drop points which are too close to be relevant for hovering and cut off all parts not visible on screen
+            mapfunc::simplifyPolygon(poly, AIRSPACE_SIMPLIFY_PIXEL);
+            QPolygonF clipped = mapfunc::clipPolygon(poly, screenRect);
+            if(clipped.size() > 2)
+              airspacePolygons.append(std::make_pair(airspace->combinedId(), clipped.toPolygon()));
             ids.insert(airspace->combinedId());
           }
         }
@@ -197,14 +213,34 @@ void MapScreenIndex::resetIlsScreenGeometry()
 {
   ilsPolygons.clear();
   ilsLines.clear();
+  ilsPolygonsGrid.clear();
+  ilsLinesGrid.clear();
 }
 
 void MapScreenIndex::updateAirspaceScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
 {
+  // Defer expensive projection and clipping until the index is needed for mouse over
   airspacePolygons.clear();
+  airspacePolygonsGrid.clear();
+  airspacePolygonsBox = curBox;
+  airspacePolygonsValid = false;
+}
+
+void MapScreenIndex::buildAirspaceScreenGeometry() const
+{
+  if(airspacePolygonsValid)
+    return;
+
+  airspacePolygonsValid = true;
   if(paintLayer == nullptr || paintLayer->getMapLayer() == nullptr)
     return;
 
+  updateAirspaceScreenGeometryAll(airspacePolygonsBox);
+  airspacePolygonsGrid.build(mapWidget->rect(), airspacePolygons);
+}
+
+void MapScreenIndex::updateAirspaceScreenGeometryAll(const Marble::GeoDataLatLonBox& curBox) const
+{
   // Use ID set to check for duplicates between calls
   QSet<map::MapAirspaceId> ids;
 
@@ -304,11 +340,15 @@ void MapScreenIndex::updateIlsScreenGeometry(const Marble::GeoDataLatLonBox& cur
         ilsPolygons.append(std::make_pair(ils.id, polygon));
     }
   }
+
+  ilsPolygonsGrid.build(mapWidget->rect(), ilsPolygons);
+  ilsLinesGrid.build(mapWidget->rect(), ilsLines);
 }
 
 void MapScreenIndex::updateLogEntryScreenGeometry(const Marble::GeoDataLatLonBox& curBox)
 {
   logEntryLines.clear();
+  logEntryLinesGrid.clear();
 
   const MapScale *scale = paintLayer->getMapScale();
 
@@ -338,6 +378,7 @@ void MapScreenIndex::updateLogEntryScreenGeometry(const Marble::GeoDataLatLonBox
           }
         }
       }
+      logEntryLinesGrid.build(mapWidget->rect(), logEntryLines);
     }
   }
 }
@@ -357,6 +398,8 @@ void MapScreenIndex::updateAirwayScreenGeometry(const Marble::GeoDataLatLonBox&
 
   // Get geometry from visible airways
   updateAirwayScreenGeometryInternal(ids, curBox, false /* highlight */);
+
+  airwayLinesGrid.build(mapWidget->rect(), airwayLines);
 }
 
 void MapScreenIndex::updateAirwayScreenGeometryInternal(QSet<int>& ids, const Marble::GeoDataLatLonBox& curBox, bool highlight)
@@ -699,6 +742,7 @@ void MapScreenIndex::updateRouteScreenGeometry(const Marble::GeoDataLatLonBox& c
   bool missed = shown.testFlag(map::MISSED_APPROACH);
 
   routeLines.clear();
+  routeLinesGrid.clear();
   routePointsEditable.clear();
   routePointsAll.clear();
 
@@ -751,6 +795,8 @@ void MapScreenIndex::updateRouteScreenGeometry(const Marble::GeoDataLatLonBox& c
     routePointsAll.append(airportPoints);
     routePointsAll.append(otherPointsEditable);
     routePointsAll.append(otherPointsNotEditable);
+
+    routeLinesGrid.build(mapWidget->rect(), routeLines);
   }
 }
 
@@ -1103,7 +1149,12 @@ void MapScreenIndex::updateAllGeometry(const Marble::GeoDataLatLonBox& curBox)
 /* Get all airways near cursor position */
 void MapScreenIndex::getNearestAirspaces(int xs, int ys, map::MapResult& result) const
 {
-  for(int i = 0; i < airspacePolygons.size(); i++)
+  buildAirspaceScreenGeometry();
+
+  QVector<int> candidates;
+  airspacePolygonsGrid.candidates(candidates, xs, ys, 0);
+
+  for(int i : candidates)
   {
     const std::pair<map::MapAirspaceId, QPolygon>& polyPair = airspacePolygons.at(i);
 
@@ -1116,11 +1167,14 @@ void MapScreenIndex::getNearestAirspaces(int xs, int ys, map::MapResult& result)
   }
 }
 
-QSet<int> MapScreenIndex::nearestLineIds(const QList<std::pair<int, QLine> >& lineList, int xs, int ys,
-                                         int maxDistance, bool lineDistanceOnly) const
+QSet<int> MapScreenIndex::nearestLineIds(const QList<std::pair<int, QLine> >& lineList, const ScreenIndexGrid& grid,
+                                         int xs, int ys, int maxDistance, bool lineDistanceOnly) const
 {
   QSet<int> ids;
-  for(int i = 0; i < lineList.size(); i++)
+  QVector<int> candidates;
+  grid.candidates(candidates, xs, ys, maxDistance);
+
+  for(int i : candidates)
   {
     const std::pair<int, QLine>& linePair = lineList.at(i);
     const QLine& line = linePair.second;
@@ -1151,7 +1205,7 @@ void MapScreenIndex::getNearestLogEntries(int xs, int ys, int maxDistance, map::
   if(paintLayer->getShownMapObjectDisplayTypes().testFlag(map::LOGBOOK_DIRECT) ||
      paintLayer->getShownMapObjectDisplayTypes().testFlag(map::LOGBOOK_ROUTE))
   {
-    for(int id : nearestLineIds(logEntryLines, xs, ys, maxDistance, false /* also distance to points */))
+    for(int id : nearestLineIds(logEntryLines, logEntryLinesGrid, xs, ys, maxDistance, false /* also distance to points */))
       maptools::insertSortedByDistance(conv, result.logbookEntries, &ids, xs, ys,
                                        NavApp::getLogdataController()->getLogEntryById(id));
   }
@@ -1164,10 +1218,12 @@ void MapScreenIndex::getNearestIls(int xs, int ys, int maxDistance, map::MapResu
     return;
 
   // Get nearest center lines (also considering buffer)
-  QSet<int> ilsIds = nearestLineIds(ilsLines, xs, ys, maxDistance, false /* lineDistanceOnly */);
+  QSet<int> ilsIds = nearestLineIds(ilsLines, ilsLinesGrid, xs, ys, maxDistance, false /* lineDistanceOnly */);
 
   // Get nearest ILS by geometry - duplicates are removed in set
-  for(int i = 0; i < ilsPolygons.size(); i++)
+  QVector<int> candidates;
+  ilsPolygonsGrid.candidates(candidates, xs, ys, 0);
+  for(int i : candidates)
   {
     const std::pair<int, QPolygon>& polyPair = ilsPolygons.at(i);
     if(polyPair.second.containsPoint(QPoint(xs, ys), Qt::OddEvenFill))
@@ -1187,7 +1243,7 @@ void MapScreenIndex::getNearestIls(int xs, int ys, int maxDistance, map::MapResu
 void MapScreenIndex::getNearestAirways(int xs, int ys, int maxDistance, map::MapResult& result) const
 {
   AirwayTrackQuery *airwayTrackQuery = mapWidget->getAirwayTrackQuery();
-  for(int id : nearestLineIds(airwayLines, xs, ys, maxDistance, true /* lineDistanceOnly */))
+  for(int id : nearestLineIds(airwayLines, airwayLinesGrid, xs, ys, maxDistance, true /* lineDistanceOnly */))
     result.airways.append(airwayTrackQuery->getAirwayById(id));
 }
 
@@ -1199,7 +1255,9 @@ int MapScreenIndex::getNearestRouteLegIndex(int xs, int ys, int maxDistance) con
   int minIndex = -1;
   float minDist = std::numeric_limits<float>::max();
 
-  for(int i = 0; i < routeLines.size(); i++)
+  QVector<int> candidates;
+  routeLinesGrid.candidates(candidates, xs, ys, maxDistance);
+  for(int i : candidates)
   {
     const std::pair<int, QLine>& line = routeLines.at(i);
 
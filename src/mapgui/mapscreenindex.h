@@ -19,6 +19,9 @@
 #define LITTLENAVMAP_MAPSCREENINDEX_H
 
 #include "common/mapflags.h"
+#include "mapgui/screenindexgrid.h"
+
+#include <marble/GeoDataLatLonBox.h>
 
 #include <QDateTime>
 #include <QHash>
@@ -69,10 +72,6 @@ struct PatternMarker;
 struct RangeMarker;
 }
 
-namespace Marble {
-class GeoDataLatLonBox;
-}
-
 class MapPaintWidget;
 class AirwayTrackQuery;
 class AirportQuery;
@@ -126,6 +125,7 @@ public:
   void updateRouteScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateAirwayScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
 
+  /* Only invalidates the airspace geometry. It is built on demand when calling getAllNearest */
   void updateAirspaceScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateIlsScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
   void updateLogEntryScreenGeometry(const Marble::GeoDataLatLonBox& curBox);
@@ -305,8 +305,11 @@ private:
   void getNearestProcedureHighlights(int xs, int ys, int maxDistance, map::MapResult& result, map::MapObjectQueryTypes types) const;
   void nearestProcedureHighlightsInternal(int xs, int ys, int maxDistance, map::MapResult& result, map::MapObjectQueryTypes types,
                                           const QVector<proc::MapProcedureLegs>& procedureLegs, bool previewAll) const;
+  /* Build airspace geometry and grid if invalidated by updateAirspaceScreenGeometry */
+  void buildAirspaceScreenGeometry() const;
+  void updateAirspaceScreenGeometryAll(const Marble::GeoDataLatLonBox& curBox) const;
   void updateAirspaceScreenGeometryInternal(QSet<map::MapAirspaceId>& ids, map::MapAirspaceSources source,
-                                            const Marble::GeoDataLatLonBox& curBox, bool highlights);
+                                            const Marble::GeoDataLatLonBox& curBox, bool highlights) const;
   void updateAirwayScreenGeometryInternal(QSet<int>& ids, const Marble::GeoDataLatLonBox& curBox, bool highlight);
 
   void updateLineScreenGeometry(QList<std::pair<int, QLine> >& index, int id, const atools::geo::Line& line,
@@ -315,7 +318,8 @@ private:
   /* Fill average values for ground speed and turn speed for turn path display. */
   void updateAverageTurn();
 
-  QSet<int> nearestLineIds(const QList<std::pair<int, QLine> >& lineList, int xs, int ys, int maxDistance, bool lineDistanceOnly) const;
+  QSet<int> nearestLineIds(const QList<std::pair<int, QLine> >& lineList, const ScreenIndexGrid& grid, int xs, int ys,
+                           int maxDistance, bool lineDistanceOnly) const;
 
   template<typename TYPE>
   int getNearestId(int xs, int ys, int maxDistance, const QHash<int, TYPE>& typeList) const;
@@ -377,10 +381,19 @@ private:
 
   /* Collects logbook entry route and direct line geometry */
   QList<std::pair<int, QLine> > logEntryLines;
-  QList<std::pair<map::MapAirspaceId, QPolygon> > airspacePolygons;
+
+  /* Clipped and simplified airspace outlines. Built lazily on first mouse over after a map change. */
+  mutable QList<std::pair<map::MapAirspaceId, QPolygon> > airspacePolygons;
+  mutable ScreenIndexGrid airspacePolygonsGrid;
+  mutable bool airspacePolygonsValid = true;
+  Marble::GeoDataLatLonBox airspacePolygonsBox;
+
   QList<std::pair<int, QPolygon> > ilsPolygons;
   QList<std::pair<int, QLine> > ilsLines; /* Index ILS center lines separately to allow
                                            * tooltips when getting the cursor near a line */
+
+  /* Screen grids for the geometry lists above. Rebuilt whenever the respective list is updated. */
+  ScreenIndexGrid routeLinesGrid, airwayLinesGrid, logEntryLinesGrid, ilsPolygonsGrid, ilsLinesGrid;
 };
 
 #endif // LITTLENAVMAP_MAPSCREENINDEX_H
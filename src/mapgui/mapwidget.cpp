@@ -854,7 +854,7 @@ void MapWidget::mouseReleaseEvent(QMouseEvent *event)
     cancelDragRoute();
     mouseState = mw::NONE;
     setViewContext(Marble::Still);
-    update();
+    updateAll();
   }
   else if(mouseState & mw::DRAG_DISTANCE || mouseState & mw::DRAG_CHANGE_DISTANCE)
   {
@@ -881,7 +881,7 @@ void MapWidget::mouseReleaseEvent(QMouseEvent *event)
 
     mouseState = mw::NONE;
     setViewContext(Marble::Still);
-    update();
+    updateAll();
   }
   else if(mouseState & mw::DRAG_USER_POINT)
   {
@@ -905,7 +905,7 @@ void MapWidget::mouseReleaseEvent(QMouseEvent *event)
     // End all dragging
     mouseState = mw::NONE;
     setViewContext(Marble::Still);
-    update();
+    updateAll();
   }
   else if(touchArea && !mouseMove)
     // Touch/navigation areas are enabled and cursor is within a touch area - scroll, zoom, etc.
@@ -1464,7 +1464,7 @@ void MapWidget::cancelDragAll()
 
   mouseState = mw::NONE;
   setViewContext(Marble::Still);
-  update();
+  updateAll();
 }
 
 /* Stop userpoint editing and reset coordinates and pixmap */
@@ -1638,7 +1638,7 @@ void MapWidget::mouseMoveEvent(QMouseEvent *event)
   {
     // Set context for fast redraw
     setViewContext(Marble::Animation);
-    update();
+    updateAll();
 
     // Start timer to call resetPaintForDrag later to do a full redraw to avoid missing map objects
     resetPaintForDragTimer.start();
@@ -1652,7 +1652,7 @@ void MapWidget::resetPaintForDrag()
   {
     // Do a full redraw with all details and reload
     setViewContext(Marble::Still);
-    update();
+    updateAll();
   }
 }
 
@@ -2615,8 +2615,8 @@ void MapWidget::simDataChanged(const atools::fs::sc::SimConnectData& simulatorDa
     // touchdownDetected = false;
 
     if((dataHasChanged || aiVisible) && !contextMenuActive)
-      // Not scrolled or zoomed but needs a redraw
-      update();
+      // Not scrolled or zoomed but needs a redraw - static layers are reused if view is unchanged
+      updateDynamic();
 
     if(!updatesEnabled())
       setUpdatesEnabled(true);
@@ -3190,7 +3190,7 @@ void MapWidget::updateMapObjectsShown()
   emit shownMapFeaturesChanged(paintLayer->getShownMapObjects());
 
   // Update widget
-  update();
+  updateAll();
 }
 
 void MapWidget::showResultInSearch(const map::MapBase *base)
@@ -3303,7 +3303,7 @@ void MapWidget::addPatternMark(const map::MapAirport& airport)
     dialog.fillPatternMarker(pattern);
     getScreenIndex()->addPatternMark(pattern);
     mainWindow->updateMarkActionStates();
-    update();
+    updateAll();
     mainWindow->setStatusMessage(tr("Added airport traffic pattern for %1.").arg(airport.displayIdent()));
   }
 }
@@ -3314,7 +3314,7 @@ void MapWidget::removePatternMark(int id)
 
   getScreenIndex()->removePatternMark(id);
   mainWindow->updateMarkActionStates();
-  update();
+  updateAll();
   mainWindow->setStatusMessage(QString(tr("Traffic pattern removed from map.")));
 }
 
@@ -3336,7 +3336,7 @@ void MapWidget::addHold(const map::MapResult& result, const atools::geo::Pos& po
 
     mainWindow->updateMarkActionStates();
 
-    update();
+    updateAll();
     mainWindow->setStatusMessage(tr("Added hold."));
   }
 }
@@ -3347,7 +3347,7 @@ void MapWidget::removeHoldMark(int id)
 
   getScreenIndex()->removeHoldingMark(id);
   mainWindow->updateMarkActionStates();
-  update();
+  updateAll();
   mainWindow->setStatusMessage(QString(tr("Holding removed from map.")));
 }
 
@@ -3367,7 +3367,7 @@ void MapWidget::addMsaMark(map::MapAirportMsa airportMsa)
     getScreenIndex()->addMsaMark(msa);
     mainWindow->updateMarkActionStates();
 
-    update();
+    updateAll();
     mainWindow->setStatusMessage(tr("Added MSA diagram."));
   }
 }
@@ -3378,7 +3378,7 @@ void MapWidget::removeMsaMark(int id)
 
   getScreenIndex()->removeMsaMark(id);
   mainWindow->updateMarkActionStates();
-  update();
+  updateAll();
   mainWindow->setStatusMessage(QString(tr("Airport MSA removed from map.")));
 }
 
@@ -3446,7 +3446,7 @@ void MapWidget::changeSearchMark(const atools::geo::Pos& pos)
 
   // Will update any active distance search
   emit searchMarkChanged(searchMarkPos);
-  update();
+  updateAll();
   mainWindow->setStatusMessage(tr("Distance search center position changed."));
 }
 
@@ -3454,7 +3454,7 @@ void MapWidget::changeHome()
 {
   homePos = Pos(centerLongitude(), centerLatitude());
   homeDistance = distance();
-  update();
+  updateAll();
   mainWindow->setStatusMessage(QString(tr("Changed home position.")));
 }
 
@@ -3492,7 +3492,7 @@ void MapWidget::addNavRangeMark(const atools::geo::Pos& pos, map::MapTypes type,
     getScreenIndex()->addRangeMark(marker);
     qDebug() << "navaid range" << marker.position;
 
-    update();
+    updateAll();
     mainWindow->updateMarkActionStates();
     mainWindow->setStatusMessage(tr("Added range rings for %1.").arg(displayIdent));
   }
@@ -3528,7 +3528,7 @@ void MapWidget::addRangeMark(const atools::geo::Pos& pos, bool showDialog)
     getScreenIndex()->addRangeMark(marker);
 
     qDebug() << "range rings" << marker.position;
-    update();
+    updateAll();
     mainWindow->updateMarkActionStates();
     mainWindow->setStatusMessage(tr("Added range rings for position."));
   }
@@ -3578,7 +3578,7 @@ void MapWidget::removeRangeMark(int id)
 {
   getScreenIndex()->removeRangeMark(id);
   mainWindow->updateMarkActionStates();
-  update();
+  updateAll();
   mainWindow->setStatusMessage(QString(tr("Range ring removed from map.")));
 }
 
@@ -3586,14 +3586,14 @@ void MapWidget::removeDistanceMark(int id)
 {
   getScreenIndex()->removeDistanceMark(id);
   mainWindow->updateMarkActionStates();
-  update();
+  updateAll();
   mainWindow->setStatusMessage(QString(tr("Measurement line removed from map.")));
 }
 
 void MapWidget::setMapDetail(int level)
 {
   setDetailLevel(level);
-  update();
+  updateAll();
 
   int levelUi = level - MapLayerSettings::MAP_DEFAULT_DETAIL_LEVEL; // -2 -> 0 -> 5
   QString detStr;
@@ -3618,7 +3618,7 @@ void MapWidget::clearAllMarkers(map::MapTypes types)
   if(types.testFlag(map::MARK_DISTANCE))
     currentDistanceMarkerId = -1;
 
-  update();
+  updateAll();
   mainWindow->updateMarkActionStates();
   mainWindow->setStatusMessage(tr("User features removed from map."));
 }
@@ -3627,7 +3627,7 @@ void MapWidget::deleteAircraftTrack()
 {
   aircraftTrack->clearTrack();
   emit updateActionStates();
-  update();
+  updateAll();
 }
 
 void MapWidget::deleteAircraftTrackLogbook()
@@ -0,0 +1,80 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mapgui/screenindexgrid.h"
+
+#include "atools.h"
+
+#include <algorithm>
+
+/* Size of a cell in pixels */
+const static int CELL_SIZE = 64;
+
+void ScreenIndexGrid::init(const QRect& rect)
+{
+  gridRect = rect;
+  columns = std::max(1, (rect.width() + CELL_SIZE - 1) / CELL_SIZE);
+  rows = std::max(1, (rect.height() + CELL_SIZE - 1) / CELL_SIZE);
+
+  cells.clear();
+  cells.resize(columns * rows);
+}
+
+void ScreenIndexGrid::clear()
+{
+  gridRect = QRect();
+  columns = rows = 0;
+  cells.clear();
+}
+
+int ScreenIndexGrid::column(int xs) const
+{
+  return atools::minmax(0, columns - 1, (xs - gridRect.left()) / CELL_SIZE);
+}
+
+int ScreenIndexGrid::row(int ys) const
+{
+  return atools::minmax(0, rows - 1, (ys - gridRect.top()) / CELL_SIZE);
+}
+
+void ScreenIndexGrid::insert(int index, const QRect& rect)
+{
+  int colMax = column(rect.right()), rowMax = row(rect.bottom());
+  for(int r = row(rect.top()); r <= rowMax; r++)
+  {
+    for(int c = column(rect.left()); c <= colMax; c++)
+      cells[r * columns + c].append(index);
+  }
+}
+
+void ScreenIndexGrid::candidates(QVector<int>& indexes, int xs, int ys, int radius) const
+{
+  indexes.clear();
+  if(cells.isEmpty())
+    return;
+
+  int colMax = column(xs + radius), rowMax = row(ys + radius);
+  for(int r = row(ys - radius); r <= rowMax; r++)
+  {
+    for(int c = column(xs - radius); c <= colMax; c++)
+      indexes.append(cells.at(r * columns + c));
+  }
+
+  // Objects spanning more than one cell are found more than once
+  std::sort(indexes.begin(), indexes.end());
+  indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+}
@@ -0,0 +1,76 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_SCREENINDEXGRID_H
+#define LITTLENAVMAP_SCREENINDEXGRID_H
+
+#include <QLine>
+#include <QList>
+#include <QPolygon>
+#include <QRect>
+#include <QVector>
+
+/*
+ * Uniform grid in screen coordinates which maps cells to indexes of a geometry list in MapScreenIndex.
+ * Used to limit mouse over lookups to geometry near the cursor instead of checking all lines and polygons.
+ *
+ * Objects outside of the grid rectangle are assigned to the border cells.
+ */
+class ScreenIndexGrid
+{
+public:
+  /* Clear grid and build it for all geometry in list. Index in grid is the list index. */
+  template<typename ID, typename GEO>
+  void build(const QRect& rect, const QList<std::pair<ID, GEO> >& list)
+  {
+    init(rect);
+    for(int i = 0; i < list.size(); i++)
+      insert(i, bounding(list.at(i).second));
+  }
+
+  /* Get sorted and unique list indexes of all objects which have their bounding rectangle
+   * within radius of the given point. Candidates have to be checked by caller. */
+  void candidates(QVector<int>& indexes, int xs, int ys, int radius) const;
+
+  void clear();
+
+private:
+  void init(const QRect& rect);
+  void insert(int index, const QRect& rect);
+
+  /* Get clamped cell column and row for screen coordinates */
+  int column(int xs) const;
+  int row(int ys) const;
+
+  static QRect bounding(const QLine& line)
+  {
+    return QRect(line.p1(), line.p2()).normalized();
+  }
+
+  static QRect bounding(const QPolygon& polygon)
+  {
+    return polygon.boundingRect();
+  }
+
+  QRect gridRect;
+  int columns = 0, rows = 0;
+
+  /* Row major list of cells with list indexes */
+  QVector<QVector<int> > cells;
+};
+
+#endif // LITTLENAVMAP_SCREENINDEXGRID_H
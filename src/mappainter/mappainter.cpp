@@ -34,6 +34,7 @@
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoDataLinearRing.h>
 #include <marble/GeoPainter.h>
+#include <marble/ViewportParams.h>
 
 #include <QPixmapCache>
 #include <QPainterPath>
@@ -151,6 +152,12 @@ MapPainter::~MapPainter()
   delete symbolPainter;
 }
 
+void MapPainter::prepareRender()
+{
+  symbolPainter->setCacheGeneration(context->symbolCacheGeneration);
+  symbolPainter->setLabelCollisionGrid(context->labelCollisionGrid);
+}
+
 bool MapPainter::wToSBuf(const Pos& coords, int& x, int& y, QSize size, const QMargins& margins,
                          bool *hidden) const
 {
@@ -177,6 +184,71 @@ bool MapPainter::wToSBuf(const Pos& coords, float& x, float& y, QSize size, cons
   return visible;
 }
 
+bool MapPainter::wToSBuf(const CoordinateBatch& batch, int index, float& x, float& y, QSize size, const QMargins& margins,
+                         bool *hidden) const
+{
+  x = batch.getX(index);
+  y = batch.getY(index);
+
+  bool hid = batch.isHidden(index);
+  if(hidden != nullptr)
+    *hidden = hid;
+
+  if(hid)
+    return false;
+
+  // Check visibility using the object size and extended rectangle
+  QRect rect = context->screenRect.marginsAdded(margins).adjusted(-size.width() / 2, -size.height() / 2,
+                                                                  size.width() / 2, size.height() / 2);
+  return batch.isVisible(index) || rect.contains(atools::roundToInt(x), atools::roundToInt(y));
+}
+
+bool MapPainter::lineStringToScreen(QPolygonF& polygon, const atools::geo::LineString& linestring)
+{
+  // Segments shorter than this are drawn as straight lines in screen coordinates
+  const float MAX_SEGMENT_DEG = 0.5f;
+
+  coordBatch.clear();
+  coordBatch.reserve(linestring.size());
+  const Pos *last = nullptr;
+  for(const Pos& pos : linestring)
+  {
+    if(last != nullptr && (std::abs(pos.getLonX() - last->getLonX()) > MAX_SEGMENT_DEG ||
+                           std::abs(pos.getLatY() - last->getLatY()) > MAX_SEGMENT_DEG))
+      return false;
+
+    coordBatch.append(pos);
+    last = &pos;
+  }
+
+  if(!coordBatch.project(*this))
+    // No closed formula for this projection
+    return false;
+
+  // Screen jump larger than half the world width in Mercator projection - same as in drawLineStringScreen()
+  const float maxJump = static_cast<float>(context->viewport->radius() * 2);
+
+  polygon.resize(0);
+  polygon.reserve(coordBatch.size());
+  for(int i = 0; i < coordBatch.size(); i++)
+  {
+    if(coordBatch.isHidden(i))
+      return false;
+
+    if(!polygon.isEmpty() && std::abs(coordBatch.getX(i) - polygon.constLast().x()) > maxJump)
+      // Wraps around at the Mercator seam - let GeoPainter split the polygon
+      return false;
+
+    polygon.append(coordBatch.getPointF(i));
+  }
+
+  // Check closing segment too since the result is also drawn as closed polygon
+  if(polygon.size() > 1 && std::abs(polygon.constFirst().x() - polygon.constLast().x()) > maxJump)
+    return false;
+
+  return true;
+}
+
 void MapPainter::paintArc(GeoPainter *painter, const Pos& centerPos, float radiusNm, float angleDegStart, float angleDegEnd, bool fast)
 {
   if(radiusNm > atools::geo::EARTH_CIRCUMFERENCE_METER / 4.f)
@@ -461,6 +533,9 @@ void MapPainter::drawLineString(Marble::GeoPainter *painter, const atools::geo::
   if(linestring.size() < 2)
     return;
 
+  if(drawLineStringScreen(painter, linestring))
+    return;
+
   const float LATY_CORRECTION = 0.00001f;
   LineString splitLines = linestring.splitAtAntiMeridian();
   splitLines.removeDuplicates();
@@ -511,6 +586,146 @@ void MapPainter::drawLineString(Marble::GeoPainter *painter, const atools::geo::
   }
 }
 
+bool MapPainter::drawLineStringScreen(Marble::GeoPainter *painter, const atools::geo::LineString& linestring)
+{
+  // Build tessellated great circle points ======================================
+  lineBatch.clear();
+  const Pos *last = nullptr;
+  for(const Pos& pos : linestring)
+  {
+    if(!pos.isValid())
+      return false;
+
+    if(last == nullptr)
+      lineBatch.append(pos);
+    else if(pos != *last)
+      // Skip duplicates
+      appendGreatCircle(*last, pos);
+    last = &pos;
+  }
+
+  if(lineBatch.size() < 2 || !lineBatch.project(*this))
+    return false;
+
+  // Build polylines and break at hidden points or Mercator wrap around ===========================
+  // Screen jump larger than half the world width in Mercator projection
+  const float maxJump = static_cast<float>(context->viewport->radius() * 2);
+
+  auto flush = [this, painter]() -> void {
+                 if(linePolyline.size() > 1)
+                   painter->drawPolyline(linePolyline);
+                 linePolyline.resize(0);
+               };
+
+  // Tessellated points are close enough to find the horizon crossing on the globe by bisection
+  bool interpolateHorizon = context->viewport->projection() == Marble::Spherical;
+
+  linePolyline.resize(0);
+  for(int i = 0; i < lineBatch.size(); i++)
+  {
+    if(lineBatch.isHidden(i))
+    {
+      // End polyline at the horizon
+      if(interpolateHorizon && i > 0 && !lineBatch.isHidden(i - 1))
+        linePolyline.append(horizonPoint(i - 1, i));
+      flush();
+      continue;
+    }
+
+    // Start polyline at the horizon
+    if(interpolateHorizon && i > 0 && lineBatch.isHidden(i - 1))
+      linePolyline.append(horizonPoint(i, i - 1));
+
+    if(!linePolyline.isEmpty() && std::abs(lineBatch.getX(i) - linePolyline.constLast().x()) > maxJump)
+      flush();
+
+    linePolyline.append(lineBatch.getPointF(i));
+  }
+  flush();
+  return true;
+}
+
+QPointF MapPainter::horizonPoint(int visibleIndex, int hiddenIndex) const
+{
+  // Number of bisection steps - resolves half a degree to about 200 meters
+  const int STEPS = 8;
+
+  float lonVisible = lineBatch.getLonX(visibleIndex), latVisible = lineBatch.getLatY(visibleIndex);
+  float lonHidden = lineBatch.getLonX(hiddenIndex), latHidden = lineBatch.getLatY(hiddenIndex);
+
+  // Avoid bisecting the long way around at the anti-meridian
+  if(lonHidden - lonVisible > 180.f)
+    lonHidden -= 360.f;
+  else if(lonVisible - lonHidden > 180.f)
+    lonHidden += 360.f;
+
+  QPointF point = lineBatch.getPointF(visibleIndex);
+  for(int i = 0; i < STEPS; i++)
+  {
+    float lon = (lonVisible + lonHidden) / 2.f, lat = (latVisible + latHidden) / 2.f;
+    float x, y;
+    bool hidden = false;
+    wToS(Pos(lon, lat).normalized(), x, y, DEFAULT_WTOS_SIZE, &hidden);
+
+    if(hidden)
+    {
+      lonHidden = lon;
+      latHidden = lat;
+    }
+    else
+    {
+      lonVisible = lon;
+      latVisible = lat;
+      point = QPointF(x, y);
+    }
+  }
+  return point;
+}
+
+void MapPainter::appendGreatCircle(const Pos& pos1, const Pos& pos2)
+{
+  // Maximum distance between tessellated points in degree
+  const float MAX_STEP_DEG = 0.5f;
+  const int MAX_STEPS = 400;
+
+  float diffLon = std::abs(pos2.getLonX() - pos1.getLonX());
+  if(diffLon > 180.f)
+    diffLon = 360.f - diffLon;
+  int steps = std::min(static_cast<int>(std::ceil((diffLon + std::abs(pos2.getLatY() - pos1.getLatY())) / MAX_STEP_DEG)),
+                       MAX_STEPS);
+
+  if(steps > 1)
+  {
+    // Spherical linear interpolation between unit vectors
+    double lon1 = atools::geo::toRadians(static_cast<double>(pos1.getLonX())),
+           lat1 = atools::geo::toRadians(static_cast<double>(pos1.getLatY()));
+    double lon2 = atools::geo::toRadians(static_cast<double>(pos2.getLonX())),
+           lat2 = atools::geo::toRadians(static_cast<double>(pos2.getLatY()));
+
+    double x1 = std::cos(lat1) * std::cos(lon1), y1 = std::cos(lat1) * std::sin(lon1), z1 = std::sin(lat1);
+    double x2 = std::cos(lat2) * std::cos(lon2), y2 = std::cos(lat2) * std::sin(lon2), z2 = std::sin(lat2);
+
+    double angle = std::acos(atools::minmax(-1., 1., x1 * x2 + y1 * y2 + z1 * z2));
+    double sinAngle = std::sin(angle);
+
+    // Antipodal or equal points have no defined great circle
+    if(sinAngle > 1.e-9)
+    {
+      for(int i = 1; i < steps; i++)
+      {
+        double fraction = static_cast<double>(i) / steps;
+        double a = std::sin((1. - fraction) * angle) / sinAngle;
+        double b = std::sin(fraction * angle) / sinAngle;
+        double x = a * x1 + b * x2, y = a * y1 + b * y2, z = a * z1 + b * z2;
+
+        lineBatch.append(static_cast<float>(atools::geo::toDegree(std::atan2(y, x))),
+                         static_cast<float>(atools::geo::toDegree(std::atan2(z, std::sqrt(x * x + y * y)))));
+      }
+    }
+  }
+  lineBatch.append(pos2);
+}
+
 void MapPainter::drawLineStringRadial(Marble::GeoPainter *painter, const atools::geo::LineString& linestring)
 {
   if(linestring.size() < 2)
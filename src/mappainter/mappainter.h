@@ -48,6 +48,7 @@ class MapWidget;
 class SymbolPainter;
 class WaypointTrackQuery;
 class AircraftTrack;
+class LabelCollisionGrid;
 class Route;
 
 namespace map {
@@ -108,6 +109,12 @@ struct PaintContext
   bool visibleWidget;
   bool paintCopyright = true;
   int mimimumRunwayLengthFt = -1;
+
+  /* Generation of pre-rendered symbols and labels. Increased by the map widget to drop cached symbols. */
+  int symbolCacheGeneration = 0;
+
+  /* Grid to drop overlapping labels for this frame. Null if disabled. */
+  LabelCollisionGrid *labelCollisionGrid = nullptr;
   QVector<map::MapObjectRef> *routeDrawnNavaids; /* All navaids drawn for route and procedures. Points to vector in MapScreenIndex */
 
   /* Text sizes and line thickness in percent / 100 as set in options dialog */
@@ -283,6 +290,10 @@ public:
 
   virtual void render() = 0;
 
+  /* Pass per frame state like label collision grid and cache generation from the paint context to the
+   * symbol painter. Has to be called before render(). */
+  void prepareRender();
+
   bool sortAirportFunction(const PaintAirportType& pap1, const PaintAirportType& pap2);
 
   void initQueries();
@@ -304,6 +315,20 @@ protected:
     return wToSBuf(coords, x, y, DEFAULT_WTOS_SIZE, margins, hidden);
   }
 
+  /* Same as above for a point at index of an already projected batch */
+  bool wToSBuf(const CoordinateBatch& batch, int index, float& x, float& y, QSize size, const QMargins& margins,
+               bool *hidden = nullptr) const;
+
+  bool wToSBuf(const CoordinateBatch& batch, int index, float& x, float& y, const QMargins& margins, bool *hidden = nullptr) const
+  {
+    return wToSBuf(batch, index, x, y, DEFAULT_WTOS_SIZE, margins, hidden);
+  }
+
+  /* Convert line string to screen coordinates using batch conversion. Returns false if the line string cannot be
+   * drawn as straight screen lines: points hidden behind the globe, long segments which need great circle
+   * tessellation or points jumping across the Mercator seam. Caller has to use drawLineString or drawPolygon then. */
+  bool lineStringToScreen(QPolygonF& polygon, const atools::geo::LineString& linestring);
+
   /* Draw a circle and return text placement hints (xtext and ytext). Number of points used
    * for the circle depends on the zoom distance. Optimized for large circles. */
   void paintCircle(Marble::GeoPainter *painter, const atools::geo::Pos& centerPos, float radiusNm, bool fast, QPoint *textPos);
@@ -311,6 +336,7 @@ protected:
   void paintArc(Marble::GeoPainter *painter, const atools::geo::Pos& centerPos, float radiusNm, float angleDegStart, float angleDegEnd,
                 bool fast);
 
+  /* Draw great circle line string. Uses direct tessellation into screen coordinates if the projection allows it. */
   void drawLineString(Marble::GeoPainter *painter, const atools::geo::LineString& linestring);
   void drawLineStringRadial(Marble::GeoPainter *painter, const atools::geo::LineString& linestring);
   void drawLine(Marble::GeoPainter *painter, const atools::geo::Line& line, bool noRecurse = false);
@@ -394,6 +420,25 @@ protected:
   WaypointTrackQuery *waypointQuery = nullptr;
   AirportQuery *airportQuery = nullptr;
   MapScale *scale = nullptr;
+
+  /* Reused buffer for batch conversion of positions */
+  CoordinateBatch coordBatch;
+
+private:
+  /* Tessellate great circle segments directly into screen coordinates. Returns false if not possible for
+   * the current projection. */
+  bool drawLineStringScreen(Marble::GeoPainter *painter, const atools::geo::LineString& linestring);
+
+  /* Find the screen position where the segment between a visible and a hidden point of lineBatch crosses
+   * the horizon of the globe */
+  QPointF horizonPoint(int visibleIndex, int hiddenIndex) const;
+
+  /* Append great circle points between the two positions excluding pos1 to lineBatch */
+  void appendGreatCircle(const atools::geo::Pos& pos1, const atools::geo::Pos& pos2);
+
+  /* Scratch buffers for drawLineString kept between calls to avoid allocations */
+  CoordinateBatch lineBatch;
+  QPolygonF linePolyline;
 };
 
 #endif // LITTLENAVMAP_MAPPAINTER_H
@@ -31,6 +31,7 @@
 #include "route/routecontroller.h"
 #include "util/paintercontextsaver.h"
 #include "mapgui/aprongeometrycache.h"
+#include "mapgui/airportdiagramcache.h"
 #include "atools.h"
 #include "navapp.h"
 
@@ -125,14 +126,23 @@ void MapPainterAirport::render()
 
   // Collect all airports that are visible ===========================
   QVector<PaintAirportType> visibleAirports;
+
+  coordBatch.clear();
+  for(const MapAirport& airport : airports)
+    coordBatch.append(airport.position);
+  coordBatch.project(*this);
+
+  int index = 0;
   for(const MapAirport& airport : airports)
   {
+    int batchIndex = index++;
+
     // Either part of the route or enabled in the actions/menus/toolbar
     if(airport.isVisible(context->objectTypes, minRunwayLength, context->mapLayer) || context->routeProcIdMap.contains(airport.getRef()))
     {
       float x, y;
       bool hidden;
-      bool visibleOnMap = wToSBuf(airport.position, x, y, scale->getScreeenSizeForRect(airport.bounding), margins, &hidden);
+      bool visibleOnMap = wToSBuf(coordBatch, batchIndex, x, y, scale->getScreeenSizeForRect(airport.bounding), margins, &hidden);
 
       if(!hidden)
       {
@@ -251,13 +261,11 @@ void MapPainterAirport::drawAirportDiagramBackground(const map::MapAirport& airp
   {
     // For taxipaths
     const QList<MapTaxiPath> *taxipaths = airportQuery->getTaxiPaths(airport.id);
-    for(const MapTaxiPath& taxipath : *taxipaths)
-    {
-      bool visible;
-      QPoint start = wToS(taxipath.start, DEFAULT_WTOS_SIZE, &visible);
-      QPoint end = wToS(taxipath.end, DEFAULT_WTOS_SIZE, &visible);
-      painter->drawLine(start, end);
-    }
+    AirportDiagramCache *diagramCache = mapPaintWidget->getAirportDiagramCache();
+    QPointF ref = diagramCache->getReferencePoint(airport);
+    const QVector<QPointF>& taxiPoints = diagramCache->getTaxiPoints(airport, *taxipaths);
+    for(int i = 0; i < taxiPoints.size(); i += 2)
+      painter->drawLine(taxiPoints.at(i) + ref, taxiPoints.at(i + 1) + ref);
   }
 
   // Apron only for full diagram and not the runway overview ==================
@@ -377,14 +385,22 @@ void MapPainterAirport::drawAirportDiagram(const map::MapAirport& airport)
     QVector<QPoint> startPts, endPts;
     QVector<int> pathThickness;
 
-    // Collect coordinates first
+    // Collect coordinates first - get points relative to airport from cache and move them into place
     const QList<MapTaxiPath> *taxipaths = airportQuery->getTaxiPaths(airport.id);
-    for(const MapTaxiPath& taxipath : *taxipaths)
+    AirportDiagramCache *diagramCache = mapPaintWidget->getAirportDiagramCache();
+    QPointF ref = diagramCache->getReferencePoint(airport);
+    const QVector<QPointF>& taxiPoints = diagramCache->getTaxiPoints(airport, *taxipaths);
+    startPts.reserve(taxipaths->size());
+    endPts.reserve(taxipaths->size());
+    pathThickness.reserve(taxipaths->size());
+
+    for(int i = 0; i < taxipaths->size(); i++)
     {
-      bool visible;
+      const MapTaxiPath& taxipath = taxipaths->at(i);
+
       // Do not do any clipping here
-      startPts.append(wToS(taxipath.start, DEFAULT_WTOS_SIZE, &visible));
-      endPts.append(wToS(taxipath.end, DEFAULT_WTOS_SIZE, &visible));
+      startPts.append((taxiPoints.at(i * 2) + ref).toPoint());
+      endPts.append((taxiPoints.at(i * 2 + 1) + ref).toPoint());
 
       if(taxipath.width == 0)
         // Special X-Plane case - width is not given for path
@@ -452,25 +468,20 @@ void MapPainterAirport::drawAirportDiagram(const map::MapAirport& airport)
       painter->setBackgroundMode(Qt::TransparentMode);
       painter->setPen(QPen(mapcolors::taxiwayNameColor, 2, Qt::SolidLine, Qt::FlatCap));
 
-      // Map all visible names to paths
-      QMultiMap<QString, MapTaxiPath> map;
-      for(const MapTaxiPath& taxipath : *taxipaths)
+      // Map all visible names to path indexes
+      QMultiMap<QString, int> map;
+      for(int i = 0; i < taxipaths->size(); i++)
       {
-        if(!taxipath.name.isEmpty())
-        {
-          bool visible;
-          wToS(taxipath.start, DEFAULT_WTOS_SIZE, &visible);
-          wToS(taxipath.end, DEFAULT_WTOS_SIZE, &visible);
-          if(visible)
-            map.insert(taxipath.name, taxipath);
-        }
+        const MapTaxiPath& taxipath = taxipaths->at(i);
+        if(!taxipath.name.isEmpty() && context->screenRect.contains(endPts.at(i)))
+          map.insert(taxipath.name, i);
       }
 
       painter->setBackgroundMode(Qt::OpaqueMode);
       painter->setBackground(mapcolors::taxiwayNameBackgroundColor);
 
-      QVector<MapTaxiPath> pathsToLabel;
-      QList<MapTaxiPath> paths;
+      QVector<int> pathsToLabel;
+      QList<int> paths;
 
       for(const QString& taxiname : map.uniqueKeys())
       {
@@ -484,11 +495,10 @@ void MapPainterAirport::drawAirportDiagram(const map::MapAirport& airport)
           pathsToLabel.append(paths.at(paths.size() / 2));
         pathsToLabel.append(paths.constLast());
 
-        for(const MapTaxiPath& taxipath : pathsToLabel)
+        for(int index : pathsToLabel)
         {
-          bool visible;
-          QPoint start = wToS(taxipath.start, DEFAULT_WTOS_SIZE, &visible);
-          QPoint end = wToS(taxipath.end, DEFAULT_WTOS_SIZE, &visible);
+          const QPoint& start = startPts.at(index);
+          const QPoint& end = endPts.at(index);
 
           QRect textrect = taxiMetrics.boundingRect(taxiname);
 
@@ -650,12 +660,21 @@ void MapPainterAirport::drawAirportDiagram(const map::MapAirport& airport)
     QMargins margins(size, size, size, size);
     QMargins marginsSmall(30, 30, 30, 30);
 
+    // Get points relative to airport from cache
+    AirportDiagramCache *diagramCache = mapPaintWidget->getAirportDiagramCache();
+    QPointF ref = diagramCache->getReferencePoint(airport);
+    QRect screenRectMargins = context->screenRect.marginsAdded(margins);
+    QRect screenRectMarginsSmall = context->screenRect.marginsAdded(marginsSmall);
+
     const QList<MapParking> *parkings = airportQuery->getParkingsForAirport(airport.id);
-    for(const MapParking& parking : *parkings)
+    const QVector<QPointF>& parkingPoints = diagramCache->getParkingPoints(airport, *parkings);
+    for(int i = 0; i < parkings->size(); i++)
     {
-      float x, y;
-      if(wToSBuf(parking.position, x, y, margins))
+      const MapParking& parking = parkings->at(i);
+      QPointF pt = parkingPoints.at(i) + ref;
+      if(screenRectMargins.contains(pt.toPoint()))
       {
+        qreal x = pt.x(), y = pt.y();
         // Calculate approximate screen width and height
 
         int radius = parking.getRadius();
@@ -692,11 +711,14 @@ void MapPainterAirport::drawAirportDiagram(const map::MapAirport& airport)
     const QList<MapHelipad> *helipads = airportQuery->getHelipads(airport.id);
     if(!helipads->isEmpty())
     {
-      for(const MapHelipad& helipad : *helipads)
+      const QVector<QPointF>& helipadPoints = diagramCache->getHelipadPoints(airport, *helipads);
+      for(int i = 0; i < helipads->size(); i++)
       {
-        float x, y;
-        if(wToSBuf(helipad.position, x, y, margins))
+        const MapHelipad& helipad = helipads->at(i);
+        QPointF pt = helipadPoints.at(i) + ref;
+        if(screenRectMargins.contains(pt.toPoint()))
         {
+          float x = static_cast<float>(pt.x()), y = static_cast<float>(pt.y());
           int w = scale->getPixelIntForFeet(helipad.width, 90) / 2;
           int h = scale->getPixelIntForFeet(helipad.length, 0) / 2;
           symbolPainter->drawHelipadSymbol(painter, helipad, x, y, w, h, fast);
@@ -736,13 +758,15 @@ void MapPainterAirport::drawAirportDiagram(const map::MapAirport& airport)
     QFontMetrics metrics = painter->fontMetrics();
     if(!fast && mapLayerEffective->isAirportDiagramDetail())
     {
-      for(const MapParking& parking : *parkings)
+      for(int i = 0; i < parkings->size(); i++)
       {
+        const MapParking& parking = parkings->at(i);
         if(mapLayerEffective->isAirportDiagramDetail2() || parking.getRadius() > 20)
         {
-          float x, y;
-          if(wToSBuf(parking.position, x, y, marginsSmall))
+          QPointF pt = parkingPoints.at(i) + ref;
+          if(screenRectMarginsSmall.contains(pt.toPoint()))
           {
+            qreal x = pt.x(), y = pt.y();
             // Use different text pen for better readability depending on background
             painter->setPen(QPen(mapcolors::colorTextForParkingType(parking.type), 2, Qt::SolidLine, Qt::FlatCap));
 
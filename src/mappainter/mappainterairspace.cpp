@@ -74,6 +74,7 @@ void MapPainterAirspace::render()
 
     painter->setBackgroundMode(Qt::TransparentMode);
 
+    QPolygonF screenPolygon;
     for(const MapAirspace *airspace : airspaces)
     {
       if(!(airspace->type & context->airspaceFilterByLayer.types))
@@ -104,7 +105,13 @@ void MapPainterAirspace::render()
         const LineString *lines = controller->getAirspaceGeometry(airspace->combinedId());
 
         if(lines != nullptr)
-          drawPolygon(painter, *lines);
+        {
+          // Use faster batch conversion for small segments and fall back to tessellated drawing otherwise
+          if(lineStringToScreen(screenPolygon, *lines))
+            painter->drawPolygon(screenPolygon);
+          else
+            drawPolygon(painter, *lines);
+        }
 
         if(airspace->isOnline())
         {
@@ -31,6 +31,7 @@
 
 #include <marble/GeoDataLineString.h>
 #include <marble/GeoPainter.h>
+#include <marble/ViewportParams.h>
 
 using namespace Marble;
 using namespace atools::geo;
@@ -66,68 +67,16 @@ void MapPainterAltitude::render()
       pen.setColor(gridCol);
       context->painter->setPen(pen);
 
-      // Get covered one degree coordinate rectangles
-      const GeoDataLatLonBox& curBox = context->viewport->viewLatLonAltBox();
-      int west = static_cast<int>(curBox.west(DEG));
-      int east = static_cast<int>(curBox.east(DEG));
-      int north = static_cast<int>(curBox.north(DEG));
-      int south = static_cast<int>(curBox.south(DEG));
-
-      // Split at anit-meridian if needed
-      QVector<std::pair<int, int> > ranges;
-      if(west <= east)
-        ranges.append(std::make_pair(west - 1, east));
-      else
-      {
-        ranges.append(std::make_pair(west - 1, 179));
-        ranges.append(std::make_pair(-180, east));
-      }
+      // Rebuild grid only if viewport has changed
+      updateGrid(moraReader);
 
-      // Altitude values
-      QVector<int> altitudes;
-      // Minimum rectangle width on screen in pixel
-      float minWidth = std::numeric_limits<float>::max();
-      // Center points for rectangles for text placement
-      QVector<GeoDataCoordinates> centers;
-
-      // Draw rectangles and collect other values for text placement ================================
-      for(int laty = south; laty <= north + 1; laty++)
-      {
-        // Iterate over anti-meridian split
-        for(const std::pair<int, int>& range : ranges)
-        {
-          for(int lonx = range.first; lonx <= range.second; lonx++)
-          {
-            int moraFt100 = moraReader->getMoraFt(lonx, laty);
-            if(moraFt100 > 10 && moraFt100 != MoraReader::OCEAN && moraFt100 != MoraReader::UNKNOWN &&
-               moraFt100 != MoraReader::ERROR)
-            {
-              // Build rectangle
-              float lonxF = static_cast<float>(lonx);
-              float latyF = static_cast<float>(laty);
-              drawLine(context->painter, Line(lonxF, latyF, lonxF + 1.f, latyF));
-              drawLine(context->painter, Line(lonxF + 1.f, latyF, lonxF + 1, latyF - 1.f));
-              drawLine(context->painter, Line(lonxF + 1.f, latyF - 1, lonxF, latyF - 1.f));
-              drawLine(context->painter, Line(lonxF, latyF - 1.f, lonxF, latyF));
-
-              if(!context->drawFast)
-              {
-                // Calculate rectangle screen width
-                bool visibleDummy;
-                QPointF leftPt = wToSF(GeoDataCoordinates(lonx, laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
-                QPointF rightPt = wToSF(GeoDataCoordinates(lonx + 1., laty - .5, 0, DEG), DEFAULT_WTOS_SIZE, &visibleDummy);
-
-                minWidth = std::min(static_cast<float>(QLineF(leftPt, rightPt).length()), minWidth);
-
-                centers.append(GeoDataCoordinates(lonx + .5, laty - .5, 0, DEG));
-                altitudes.append(moraFt100);
-              }
-            }
-          } // for(int lonx = range.first; lonx <= range.second; lonx++)
-        } // for(const std::pair<int, int>& range : ranges)
-      } // for(int laty = south; laty <= north + 1; laty++)
+      // Draw all cell borders at once ================================
+      context->painter->drawLines(gridLines);
+      for(const Line& line : gridLinesHorizon)
+        drawLine(context->painter, line);
 
       // Draw texts =================================================================
+      float minWidth = gridMinWidth;
       if(!context->drawFast && minWidth > 20.f)
       {
         // Adjust minimum and maximum font height based on rectangle width
@@ -150,23 +99,17 @@ void MapPainterAltitude::render()
         if(fontmetrics.height() > 4)
         {
           // Draw big thousands numbers ===============================
-          bool visible, hidden;
           QVector<QPointF> baseline;
-          for(int i = 0; i < centers.size(); i++)
+          baseline.reserve(labelPoints.size());
+          for(int i = 0; i < labelPoints.size(); i++)
           {
-            QPointF pt = wToSF(centers.at(i), DEFAULT_WTOS_SIZE, &visible, &hidden);
-
-            if(!hidden)
-            {
-              QString numTxt = QString::number(altitudes.at(i) / 10);
-              qreal w = fontmetrics.width(numTxt);
-              pt += QPointF(-w * 0.7, fontmetrics.height() / 2. - fontmetrics.descent());
-
-              context->painter->drawText(pt, numTxt);
-              baseline.append(QPointF(pt.x() + w, pt.y()));
-            }
-            else
-              baseline.append(QPointF());
+            QPointF pt = labelPoints.at(i);
+            QString numTxt = QString::number(labelAltitudes.at(i) / 10);
+            qreal w = fontmetrics.width(numTxt);
+            pt += QPointF(-w * 0.7, fontmetrics.height() / 2. - fontmetrics.descent());
+
+            context->painter->drawText(pt, numTxt);
+            baseline.append(QPointF(pt.x() + w, pt.y()));
           }
 
           // Draw smaller hundreds numbers ==============================
@@ -174,19 +117,187 @@ void MapPainterAltitude::render()
           context->painter->setFont(font);
           fontmetrics = context->painter->fontMetrics();
 
-          for(int i = 0; i < centers.size(); i++)
+          for(int i = 0; i < baseline.size(); i++)
           {
             QPointF pt = baseline.at(i);
-            if(!pt.isNull())
-            {
-              int alt = altitudes.at(i);
-              QString smallNumTxt = QString::number(alt - (alt / 10 * 10));
-              pt.setY(pt.y() + fontmetrics.ascent() / 3.f);
-              context->painter->drawText(pt, smallNumTxt);
-            }
+            int alt = labelAltitudes.at(i);
+            QString smallNumTxt = QString::number(alt - (alt / 10 * 10));
+            pt.setY(pt.y() + fontmetrics.ascent() / 3.f);
+            context->painter->drawText(pt, smallNumTxt);
           }
         } // if(fontmetrics.height() > ...)
       } // if(!context->drawFast)
     } // if(moraReader->isDataAvailable())
   } // if(context->mapLayer->isMinimumAltitude())
 }
+
+void MapPainterAltitude::clearGrid()
+{
+  gridValid = false;
+  gridLines.clear();
+  gridLinesHorizon.clear();
+  labelPoints.clear();
+  labelAltitudes.clear();
+}
+
+void MapPainterAltitude::updateGrid(atools::fs::common::MoraReader *moraReader)
+{
+  using atools::fs::common::MoraReader;
+
+  const ViewportParams *viewport = context->viewport;
+  GridKey key;
+  key.size = QSize(viewport->width(), viewport->height());
+  key.projection = viewport->projection();
+  key.radius = viewport->radius();
+  key.centerLon = viewport->centerLongitude();
+  key.centerLat = viewport->centerLatitude();
+
+  if(gridValid && key == gridKey)
+    return;
+
+  clearGrid();
+  gridKey = key;
+  gridValid = true;
+  gridMinWidth = std::numeric_limits<float>::max();
+
+  // Get covered one degree coordinate rectangles
+  const GeoDataLatLonBox& curBox = viewport->viewLatLonAltBox();
+  int west = static_cast<int>(curBox.west(DEG));
+  int east = static_cast<int>(curBox.east(DEG));
+  int north = static_cast<int>(curBox.north(DEG));
+  int south = static_cast<int>(curBox.south(DEG));
+
+  // Split at anit-meridian if needed
+  QVector<std::pair<int, int> > ranges;
+  if(west <= east)
+    ranges.append(std::make_pair(west - 1, east));
+  else
+  {
+    ranges.append(std::make_pair(west - 1, 179));
+    ranges.append(std::make_pair(-180, east));
+  }
+
+  auto validMora = [](int moraFt100) -> bool {
+                     return moraFt100 > 10 && moraFt100 != MoraReader::OCEAN && moraFt100 != MoraReader::UNKNOWN &&
+                            moraFt100 != MoraReader::ERROR;
+                   };
+
+  // Cells have the top left corner at lonx/laty
+  int rows = north + 1 - south + 1;
+  QVector<bool> valid;
+  QVector<int> altitudes;
+
+  // Iterate over anti-meridian split
+  for(const std::pair<int, int>& range : ranges)
+  {
+    int columns = range.second - range.first + 1;
+    valid.fill(false, columns * rows);
+    altitudes.fill(0, columns * rows);
+
+    // Collect valid cells =====================================
+    for(int row = 0; row < rows; row++)
+    {
+      for(int col = 0; col < columns; col++)
+      {
+        int moraFt100 = moraReader->getMoraFt(range.first + col, south + row);
+        if(validMora(moraFt100))
+        {
+          valid[row * columns + col] = true;
+          altitudes[row * columns + col] = moraFt100;
+        }
+      }
+    }
+
+    // Right border of the last column at 180° is drawn as left border of the first column at -180° in the
+    // second range if that cell is valid
+    bool splitAtAntiMeridian = ranges.size() > 1 && range.second == 179;
+
+    // Project all cell corners and centers in one batch ==========================
+    // Corner at column and row is the top left corner of the cell - last row is the bottom border
+    int cornerColumns = columns + 1;
+    int numCorners = cornerColumns * (rows + 1);
+    coordBatch.clear();
+    coordBatch.reserve(numCorners + columns * rows);
+    for(int row = -1; row < rows; row++)
+    {
+      for(int col = 0; col < cornerColumns; col++)
+        coordBatch.append(static_cast<float>(range.first + col), static_cast<float>(south + row));
+    }
+
+    for(int row = 0; row < rows; row++)
+    {
+      for(int col = 0; col < columns; col++)
+        coordBatch.append(range.first + col + .5f, south + row - .5f);
+    }
+    coordBatch.project(*this);
+
+    // Index of corner. Row -1 is the bottom border of the lowest cells.
+    auto corner = [cornerColumns](int col, int row) -> int {
+                    return (row + 1) * cornerColumns + col;
+                  };
+
+    // A border spans one degree of longitude at most. Flat projections show the world 4 * radius wide. A
+    // horizontal distance of more than half of this is a line jumping across the screen at the anti-meridian
+    // or in a wrapped Mercator map. This cannot happen on the globe.
+    double maxDx = viewport->radius() * 2.;
+    auto addLine = [this, maxDx, &range, south, &corner](int col1, int row1, int col2, int row2) {
+                     int index1 = corner(col1, row1), index2 = corner(col2, row2);
+                     bool hidden1 = coordBatch.isHidden(index1), hidden2 = coordBatch.isHidden(index2);
+
+                     if(!hidden1 && !hidden2)
+                     {
+                       QLineF line(coordBatch.getPointF(index1), coordBatch.getPointF(index2));
+                       if(std::abs(line.dx()) <= maxDx)
+                         gridLines.append(line);
+                     }
+                     else if(hidden1 != hidden2)
+                       // One corner is behind the globe - let the geo painter clip the line at the horizon
+                       gridLinesHorizon.append(Line(static_cast<float>(range.first + col1),
+                                                    static_cast<float>(south + row1),
+                                                    static_cast<float>(range.first + col2),
+                                                    static_cast<float>(south + row2)));
+                   };
+
+    // Add unique cell borders ==========================
+    for(int row = 0; row < rows; row++)
+    {
+      for(int col = 0; col < columns; col++)
+      {
+        if(!valid.at(row * columns + col))
+          continue;
+
+        int topLeft = corner(col, row), topRight = corner(col + 1, row);
+        int bottomLeft = corner(col, row - 1), bottomRight = corner(col + 1, row - 1);
+
+        // Top and left border are always drawn by this cell
+        addLine(col, row, col + 1, row);
+        addLine(col, row - 1, col, row);
+
+        // Bottom and right border only if not drawn by the neighbor as top or left border
+        if(row == 0 || !valid.at((row - 1) * columns + col))
+          addLine(col, row - 1, col + 1, row - 1);
+
+        if(col == columns - 1)
+        {
+          if(!splitAtAntiMeridian || !validMora(moraReader->getMoraFt(-180, south + row)))
+            addLine(col + 1, row, col + 1, row - 1);
+        }
+        else if(!valid.at(row * columns + col + 1))
+          addLine(col + 1, row, col + 1, row - 1);
+
+        // Collect label positions and minimum cell width ==================
+        int center = numCorners + row * columns + col;
+        if(!coordBatch.isHidden(center))
+        {
+          float width = static_cast<float>((QLineF(coordBatch.getPointF(topLeft), coordBatch.getPointF(topRight)).length() +
+                                            QLineF(coordBatch.getPointF(bottomLeft),
+                                                   coordBatch.getPointF(bottomRight)).length()) / 2.);
+          gridMinWidth = std::min(width, gridMinWidth);
+
+          labelPoints.append(coordBatch.getPointF(center));
+          labelAltitudes.append(altitudes.at(row * columns + col));
+        }
+      }
+    }
+  }
+}
@@ -19,9 +19,18 @@
 #define LITTLENAVMAP_MAPPAINTERALTITUDE_H
 
 #include "mappainter/mappainter.h"
+#include "geo/line.h"
 
 class SymbolPainter;
 
+namespace atools {
+namespace fs {
+namespace common {
+class MoraReader;
+}
+}
+}
+
 /*
  * Draws MORA (minimum off route altitude) data and grid on the map
  */
@@ -34,6 +43,43 @@ public:
 
   virtual void render() override;
 
+  /* Drop grid after loading a new database */
+  void clearGrid();
+
+private:
+  /* Build grid lines and label positions in screen coordinates if viewport has changed */
+  void updateGrid(atools::fs::common::MoraReader *moraReader);
+
+  /* Viewport values which require rebuilding of the grid */
+  struct GridKey
+  {
+    QSize size;
+    int projection = 0, radius = 0;
+    qreal centerLon = 0., centerLat = 0.;
+
+    bool operator==(const GridKey& other) const
+    {
+      return size == other.size && projection == other.projection && radius == other.radius &&
+             centerLon == other.centerLon && centerLat == other.centerLat;
+    }
+
+  };
+
+  GridKey gridKey;
+  bool gridValid = false;
+
+  /* Unique cell borders in screen coordinates */
+  QVector<QLineF> gridLines;
+
+  /* Cell borders with one corner hidden behind the globe which are clipped by the geo painter */
+  QVector<atools::geo::Line> gridLinesHorizon;
+
+  /* Visible cell centers in screen coordinates and altitude in 100 ft */
+  QVector<QPointF> labelPoints;
+  QVector<int> labelAltitudes;
+
+  /* Minimum cell width on screen in pixel used for font size */
+  float gridMinWidth = 0.f;
 };
 
 #endif // LITTLENAVMAP_MAPPAINTERALTITUDE_H
@@ -353,13 +353,20 @@ void MapPainterNav::paintWaypoints(const QHash<int, map::MapWaypoint>& waypoints
   // Use margins for text placed on the right side of the object to avoid disappearing at the left screen border
   QMargins margins(50, 10, 10, 10);
 
+  coordBatch.clear();
+  for(const MapWaypoint& waypoint : waypoints)
+    coordBatch.append(waypoint.position);
+  coordBatch.project(*this);
+
+  int index = 0;
   for(const MapWaypoint& waypoint : waypoints)
   {
+    int batchIndex = index++;
     if(context->routeProcIdMap.contains(waypoint.getRef()) || context->routeProcIdMapRec.contains(waypoint.getRef()))
       continue;
 
     float x, y;
-    if(wToSBuf(waypoint.position, x, y, margins))
+    if(wToSBuf(coordBatch, batchIndex, x, y, margins))
     {
       if(context->objCount())
         return;
@@ -395,13 +402,20 @@ void MapPainterNav::paintVors(const QHash<int, map::MapVor>& vors, bool drawFast
   int margin = std::max(vorSize, size);
   QMargins margins(margin, margin, std::max(margin, 50), margin);
 
+  coordBatch.clear();
+  for(const MapVor& vor : vors)
+    coordBatch.append(vor.position);
+  coordBatch.project(*this);
+
+  int index = 0;
   for(const MapVor& vor : vors)
   {
+    int batchIndex = index++;
     if(context->routeProcIdMap.contains(vor.getRef()) || context->routeProcIdMapRec.contains(vor.getRef()))
       continue;
 
     float x, y;
-    if(wToSBuf(vor.position, x, y, margins))
+    if(wToSBuf(coordBatch, batchIndex, x, y, margins))
     {
       if(context->objCount())
         return;
@@ -429,13 +443,20 @@ void MapPainterNav::paintNdbs(const QHash<int, map::MapNdb>& ndbs, bool drawFast
   // Use margins for text placed on the bottom of the object to avoid disappearing at the top screen border
   QMargins margins(size, std::max(size, 50), size, size);
 
+  coordBatch.clear();
+  for(const MapNdb& ndb : ndbs)
+    coordBatch.append(ndb.position);
+  coordBatch.project(*this);
+
+  int index = 0;
   for(const MapNdb& ndb : ndbs)
   {
+    int batchIndex = index++;
     if(context->routeProcIdMap.contains(ndb.getRef()) || context->routeProcIdMapRec.contains(ndb.getRef()))
       continue;
 
     float x, y;
-    if(wToSBuf(ndb.position, x, y, margins))
+    if(wToSBuf(coordBatch, batchIndex, x, y, margins))
     {
       if(context->objCount())
         return;
@@ -461,10 +482,16 @@ void MapPainterNav::paintMarkers(const QList<map::MapMarker> *markers, bool draw
   int size = context->sz(context->symbolSizeNavaid, context->mapLayer->getMarkerSymbolSize());
   QMargins margins(size, size, size, size);
 
+  coordBatch.clear();
   for(const MapMarker& marker : *markers)
+    coordBatch.append(marker.position);
+  coordBatch.project(*this);
+
+  for(int i = 0; i < markers->size(); i++)
   {
+    const MapMarker& marker = markers->at(i);
     float x, y;
-    bool visible = wToSBuf(marker.position, x, y, margins);
+    bool visible = wToSBuf(coordBatch, i, x, y, margins);
 
     if(visible)
     {
@@ -150,25 +150,27 @@ void MapPainterTop::paintCopyright()
 {
   QString mapCopyright = NavApp::getMapThemeHandler()->getTheme(mapPaintWidget->getCurrentThemeId()).getCopyright();
   if(!mapCopyright.isEmpty() && context->paintCopyright)
-  {
-    Marble::GeoPainter *painter = context->painter;
-    atools::util::PainterContextSaver saver(painter);
+    drawCopyright(context->painter, mapCopyright, context->painter->viewport(), context->visibleWidget);
+}
+
+void MapPainterTop::drawCopyright(QPainter *painter, const QString& copyright, const QRect& rect, bool visibleWidget)
+{
+  atools::util::PainterContextSaver saver(painter);
 
-    painter->setFont(OptionData::instance().getGuiFont());
-    mapcolors::scaleFont(painter, 0.9f);
+  painter->setFont(OptionData::instance().getGuiFont());
+  mapcolors::scaleFont(painter, 0.9f);
 
-    // Move text more into the center for web apps
-    int rightOffset = context->visibleWidget ? 0 : 20;
-    int bottomOffset = context->visibleWidget ? 0 : 4;
+  // Move text more into the center for web apps
+  int rightOffset = visibleWidget ? 0 : 20;
+  int bottomOffset = visibleWidget ? 0 : 4;
 
-    // Draw text
-    painter->setPen(Qt::black);
-    painter->setBackground(QColor("#b0ffffff"));
-    painter->setBrush(Qt::NoBrush);
-    painter->setBackgroundMode(Qt::OpaqueMode);
-    painter->drawText(painter->viewport().width() - painter->fontMetrics().width(mapCopyright) - rightOffset,
-                      painter->viewport().height() - painter->fontMetrics().descent() - bottomOffset, mapCopyright);
-  }
+  // Draw text
+  painter->setPen(Qt::black);
+  painter->setBackground(QColor("#b0ffffff"));
+  painter->setBrush(Qt::NoBrush);
+  painter->setBackgroundMode(Qt::OpaqueMode);
+  painter->drawText(rect.right() + 1 - painter->fontMetrics().width(copyright) - rightOffset,
+                    rect.bottom() + 1 - painter->fontMetrics().descent() - bottomOffset, copyright);
 }
 
 void MapPainterTop::drawTouchIcons(int iconSize)
@@ -32,6 +32,9 @@ public:
 
   virtual void render() override;
 
+  /* Draw copyright message into the right bottom corner of rect. Also used for tiled images. */
+  static void drawCopyright(QPainter *painter, const QString& copyright, const QRect& rect, bool visibleWidget);
+
 private:
   /* Highlight click/touch areas */
   void drawTouchMarks(int lineSize, int areaSize);
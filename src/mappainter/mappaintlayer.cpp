@@ -18,6 +18,7 @@
 #include "mappainter/mappaintlayer.h"
 
 #include "common/constants.h"
+#include "common/labelcache.h"
 #include "common/mapcolors.h"
 #include "connect/connectclient.h"
 #include "geo/calculations.h"
@@ -40,6 +41,7 @@
 #include "mappainter/mappainteruser.h"
 #include "mappainter/mappainterweather.h"
 #include "mappainter/mappainterwind.h"
+#include "mappainter/renderprofiler.h"
 #include "navapp.h"
 #include "options/optiondata.h"
 #include "route/route.h"
@@ -49,14 +51,37 @@
 #include <QElapsedTimer>
 
 #include <marble/GeoPainter.h>
+#include <marble/ViewportParams.h>
 
 using namespace Marble;
 using namespace atools::geo;
 
+/* Delay for a complete frame after painters were skipped due to the frame budget */
+const static int FRAME_BUDGET_FOLLOW_UP_MS = 250;
+
+/* Number of painters at the start of painterPriority which are always drawn */
+const static int FRAME_BUDGET_MANDATORY = 5;
+
+/* Estimates of skipped painters are reduced by this factor per frame to retry them eventually */
+const static float FRAME_BUDGET_DECAY = 0.9f;
+
 MapPaintLayer::MapPaintLayer(MapPaintWidget *widget)
   : mapWidget(widget)
 {
-  verbose = atools::settings::Settings::instance().getAndStoreValue(lnm::OPTIONS_MAP_LAYER_DEBUG, false).toBool();
+  atools::settings::Settings& settings = atools::settings::Settings::instance();
+  verbose = settings.getAndStoreValue(lnm::OPTIONS_MAP_LAYER_DEBUG, false).toBool();
+
+  if(settings.getAndStoreValue(lnm::OPTIONS_RENDER_PROFILER, false).toBool())
+  {
+    renderProfiler = new RenderProfiler();
+    renderProfilerOverlay = settings.getAndStoreValue(lnm::OPTIONS_RENDER_PROFILER_OVERLAY, false).toBool();
+  }
+
+  layerCacheEnabled = settings.getAndStoreValue(lnm::OPTIONS_MAP_LAYER_CACHE, true).toBool();
+  frameBudgetMs = settings.getAndStoreValue(lnm::OPTIONS_MAP_FRAME_BUDGET, 50).toInt();
+
+  if(settings.getAndStoreValue(lnm::OPTIONS_MAP_LABEL_COLLISION, false).toBool())
+    labelCollisionGrid = new LabelCollisionGrid();
 
   // Create the layer configuration
   initMapLayerSettings();
@@ -80,6 +105,23 @@ MapPaintLayer::MapPaintLayer(MapPaintWidget *widget)
   mapPainterWind = new MapPainterWind(mapWidget, mapScale, &context);
   mapPainterTop = new MapPainterTop(mapWidget, mapScale, &context);
 
+  // Route, aircraft and marks first - then airports, navaids, airspaces and the rest
+  painterPriority = {mapPainterRoute, mapPainterAircraft, mapPainterTrack, mapPainterMark, mapPainterTop,
+                     mapPainterAirport, mapPainterNav, mapPainterIls, mapPainterUser, mapPainterAirspace,
+                     mapPainterMsa, mapPainterWeather, mapPainterWind, mapPainterAltitude, mapPainterShip};
+
+  frameBudgetTimer.setSingleShot(true);
+  frameBudgetTimer.setInterval(FRAME_BUDGET_FOLLOW_UP_MS);
+  QObject::connect(&frameBudgetTimer, &QTimer::timeout, mapWidget, [this]() {
+    // Nothing to do if a frame after the timer start already painted all layers
+    if(skippedPainters.isEmpty())
+      return;
+
+    // Repaint without dropping the static layer cache - cache is not used in animation frames anyway
+    frameBudgetFollowUp = true;
+    mapWidget->updateDynamic();
+  });
+
   // Default for visible object types
   objectTypes = map::MapTypes(map::AIRPORT_ALL_AND_ADDON) | map::MapTypes(map::VOR) | map::MapTypes(map::NDB) | map::MapTypes(map::AP_ILS) |
                 map::MapTypes(map::MARKER) | map::MapTypes(map::WAYPOINT);
@@ -106,6 +148,202 @@ MapPaintLayer::~MapPaintLayer()
 
   delete layers;
   delete mapScale;
+
+  if(renderProfiler != nullptr && !renderProfiler->isEmpty())
+  {
+    // Write profile next to configuration file
+    renderProfiler->writeCsv(atools::settings::Settings::getConfigFilename("_renderprofile.csv"));
+    renderProfiler->writeJson(atools::settings::Settings::getConfigFilename("_renderprofile.json"));
+  }
+  delete renderProfiler;
+  delete labelCollisionGrid;
+}
+
+void MapPaintLayer::renderStaticLayers(bool drawShip)
+{
+  // Altitude below all others
+  renderPainter(mapPainterAltitude, "Altitude");
+
+  // Ship below other navaids and airports
+  if(drawShip)
+    renderPainter(mapPainterShip, "Ship");
+
+  if(mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT_KM)
+  {
+    if(!context.isObjectOverflow())
+      renderPainter(mapPainterAirspace, "Airspace");
+
+    if(!context.isObjectOverflow())
+      renderPainter(mapPainterIls, "ILS");
+
+    if(context.mapLayer->isAirportDiagram())
+    {
+      if(!context.isObjectOverflow())
+        renderPainter(mapPainterAirport, "Airport");
+
+      if(!context.isObjectOverflow())
+        renderPainter(mapPainterNav, "Navaid");
+    }
+    else
+    {
+      if(!context.isObjectOverflow())
+        renderPainter(mapPainterMsa, "MSA");
+
+      if(!context.isObjectOverflow())
+        renderPainter(mapPainterNav, "Navaid");
+
+      if(!context.isObjectOverflow())
+        renderPainter(mapPainterAirport, "Airport");
+    }
+  }
+
+  if(!context.isObjectOverflow())
+    renderPainter(mapPainterUser, "Userpoint");
+
+  if(!context.isObjectOverflow())
+    renderPainter(mapPainterWind, "Wind");
+
+  // if(!context.isOverflow()) always paint route even if number of objects is too large
+  renderPainter(mapPainterRoute, "Route");
+
+  if(!context.isObjectOverflow())
+    renderPainter(mapPainterWeather, "Weather");
+
+  if(context.mapLayer->isAirportDiagram() && !context.isObjectOverflow())
+    renderPainter(mapPainterMsa, "MSA");
+}
+
+void MapPaintLayer::renderDynamicLayers()
+{
+  if(!context.isObjectOverflow())
+    renderPainter(mapPainterTrack, "Trail");
+
+  renderPainter(mapPainterAircraft, "Aircraft");
+
+  renderPainter(mapPainterMark, "Mark");
+
+  renderPainter(mapPainterTop, "Top");
+}
+
+MapPaintLayer::LayerCacheKey MapPaintLayer::currentLayerCacheKey(const GeoPainter *painter, const ViewportParams *viewport) const
+{
+  LayerCacheKey key;
+  key.size = QSize(viewport->width(), viewport->height());
+  key.pixelRatio = painter->device() != nullptr ? painter->device()->devicePixelRatioF() : 1.;
+  key.projection = viewport->projection();
+  key.radius = viewport->radius();
+  key.centerLon = viewport->centerLongitude();
+  key.centerLat = viewport->centerLatitude();
+  key.mapLayer = context.mapLayer;
+  key.mapLayerRoute = context.mapLayerRoute;
+  key.mapLayerEffective = context.mapLayerEffective;
+  key.objectTypes = context.objectTypes;
+  key.objectDisplayTypes = context.objectDisplayTypes;
+  key.airspaceFilter = context.airspaceFilterByLayer;
+  key.weatherSource = context.weatherSource;
+  key.activeLegIndex = context.route->isActiveValid() ? context.route->getActiveLegIndex() : -1;
+  return key;
+}
+
+bool MapPaintLayer::LayerCacheKey::operator==(const LayerCacheKey& other) const
+{
+  return size == other.size && atools::almostEqual(pixelRatio, other.pixelRatio) &&
+         projection == other.projection && radius == other.radius &&
+         centerLon == other.centerLon && centerLat == other.centerLat &&
+         mapLayer == other.mapLayer && mapLayerRoute == other.mapLayerRoute && mapLayerEffective == other.mapLayerEffective &&
+         objectTypes == other.objectTypes && objectDisplayTypes == other.objectDisplayTypes &&
+         airspaceFilter.types == other.airspaceFilter.types && airspaceFilter.flags == other.airspaceFilter.flags &&
+         airspaceFilter.minAltitudeFt == other.airspaceFilter.minAltitudeFt &&
+         airspaceFilter.maxAltitudeFt == other.airspaceFilter.maxAltitudeFt &&
+         weatherSource == other.weatherSource && activeLegIndex == other.activeLegIndex;
+}
+
+void MapPaintLayer::renderPainter(MapPainter *painter, const char *name)
+{
+  if(skippedPainters.contains(painter))
+    return;
+
+  QElapsedTimer timer;
+  if(measurePainters)
+    timer.start();
+
+  painter->prepareRender();
+
+  if(profileFrame)
+  {
+    renderProfiler->beginPainter(name, context.getObjectCount());
+    painter->render();
+    renderProfiler->endPainter(context.getObjectCount(), context.isObjectOverflow() || context.isQueryOverflow());
+  }
+  else
+    painter->render();
+
+  if(measurePainters)
+  {
+    float timeMs = timer.nsecsElapsed() / 1000000.f;
+    float& estimate = painterTimeMs[painter];
+    estimate = estimate > 0.f ? estimate * 0.7f + timeMs * 0.3f : timeMs;
+  }
+}
+
+void MapPaintLayer::planFrameBudget()
+{
+  skippedPainters.clear();
+
+  // Budget applies only to the visible map while moving or zooming
+  measurePainters = frameBudgetMs > 0 && mapWidget->isVisibleWidget() && !mapWidget->isPrinting() &&
+                    mapWidget->viewContext() == Marble::Animation;
+
+  if(!measurePainters)
+  {
+    frameBudgetDrawFast = false;
+    frameBudgetFollowUp = false;
+    return;
+  }
+
+  if(frameBudgetFollowUp)
+  {
+    // Draw all layers once after the timer fired
+    frameBudgetFollowUp = false;
+    return;
+  }
+
+  // Reduce detail for all painters if the last frames took too long - switch back only
+  // if well below budget to avoid toggling between frames
+  float totalMs = 0.f;
+  for(const MapPainter *painter : painterPriority)
+    totalMs += painterTimeMs.value(painter, 0.f);
+
+  if(totalMs > frameBudgetMs)
+    frameBudgetDrawFast = true;
+  else if(totalMs < frameBudgetMs / 2.f)
+    frameBudgetDrawFast = false;
+  context.drawFast |= frameBudgetDrawFast;
+
+  // Drop layers by priority which are not expected to fit into the remaining budget
+  float usedMs = 0.f;
+  for(int i = 0; i < painterPriority.size(); i++)
+  {
+    const MapPainter *painter = painterPriority.at(i);
+    float estimateMs = painterTimeMs.value(painter, 0.f);
+
+    if(i >= FRAME_BUDGET_MANDATORY && usedMs + estimateMs > frameBudgetMs)
+    {
+      skippedPainters.insert(painter);
+      painterTimeMs.insert(painter, estimateMs * FRAME_BUDGET_DECAY);
+    }
+    else
+      usedMs += estimateMs;
+  }
+
+  if(!skippedPainters.isEmpty())
+  {
+    if(verbose)
+      qDebug() << Q_FUNC_INFO << "skipped" << skippedPainters.size() << "painters" << "estimated" << totalMs << "ms";
+
+    // Restarted by each frame - fires once the map does not change anymore
+    frameBudgetTimer.start();
+  }
 }
 
 void MapPaintLayer::copySettings(const MapPaintLayer& other)
@@ -128,6 +366,7 @@ void MapPaintLayer::preDatabaseLoad()
 void MapPaintLayer::postDatabaseLoad()
 {
   databaseLoadStatus = false;
+  mapPainterAltitude->clearGrid();
 }
 
 void MapPaintLayer::setShowMapObjects(map::MapTypes type, map::MapTypes mask)
@@ -282,9 +521,6 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
       qDebug() << Q_FUNC_INFO << "layer" << *mapLayer;
 #endif
 
-      // Clear the airport id cache
-      shownDetailAirportIds.clear();
-
       // Prepare context =====================================================
       context = PaintContext();
       context.shownDetailAirportIds = &shownDetailAirportIds;
@@ -310,6 +546,8 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
       context.zoomDistanceMeter = static_cast<float>(mapWidget->distance() * 1000.);
       context.darkMap = NavApp::getMapThemeHandler()->isDarkTheme(mapWidget->getCurrentThemeId());
       context.paintCopyright = mapWidget->isPaintCopyright();
+      context.symbolCacheGeneration = mapWidget->getSymbolCacheGeneration();
+      context.labelCollisionGrid = nullptr;
 
       context.mimimumRunwayLengthFt = minimumRunwayLenghtFt;
 
@@ -372,7 +610,6 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
 
       // Prepare index for all navaids drawn by route - needed for context menu and tooltips
       context.routeDrawnNavaids = mapWidget->getRouteDrawnNavaids();
-      context.routeDrawnNavaids->clear();
 
       // ====================================
       // Get all waypoints from the route and add them to the map to avoid duplicate drawing
@@ -496,67 +733,88 @@ bool MapPaintLayer::render(GeoPainter *painter, ViewportParams *viewport, const
         painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
       }
 
+      // Drop low priority layers and reduce detail if the last frames took too long
+      planFrameBudget();
+
       // =========================================================================
       // Draw ====================================
-
-      // Altitude below all others
-      mapPainterAltitude->render();
-
-      // Ship below other navaids and airports
-      mapPainterShip->render();
-
-      if(mapWidget->distance() < layer::DISTANCE_CUT_OFF_LIMIT_KM)
+      profileFrame = renderProfiler != nullptr && mapWidget->isVisibleWidget();
+      if(profileFrame)
+        renderProfiler->beginFrame(context.distanceKm);
+
+      // Static layers are painted into an image and reused if only dynamic layers like the aircraft changed
+      bool cacheLayers = layerCacheEnabled && mapWidget->isVisibleWidget() && !mapWidget->isPrinting() &&
+                         mapWidget->viewContext() == Marble::Still;
+      LayerCacheKey cacheKey;
+      if(cacheLayers)
+        cacheKey = currentLayerCacheKey(painter, viewport);
+      bool reuseLayers = cacheLayers && layerCacheValid && cacheKey == layerCacheKey;
+
+      if(!reuseLayers)
       {
-        if(!context.isObjectOverflow())
-          mapPainterAirspace->render();
+        // Clear the airport id cache and the route navaids which are filled by the static painters
+        shownDetailAirportIds.clear();
+        context.routeDrawnNavaids->clear();
+      }
 
-        if(!context.isObjectOverflow())
-          mapPainterIls->render();
+      if(labelCollisionGrid != nullptr)
+      {
+        labelCollisionGrid->reset(context.screenRect);
+        context.labelCollisionGrid = labelCollisionGrid;
+      }
 
-        if(context.mapLayer->isAirportDiagram())
+      if(cacheLayers)
+      {
+        if(!reuseLayers)
         {
-          if(!context.isObjectOverflow())
-            mapPainterAirport->render();
-
-          if(!context.isObjectOverflow())
-            mapPainterNav->render();
+          QSize imageSize = cacheKey.size * cacheKey.pixelRatio;
+          if(layerCacheImage.size() != imageSize)
+            layerCacheImage = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+          layerCacheImage.setDevicePixelRatio(cacheKey.pixelRatio);
+          layerCacheImage.fill(Qt::transparent);
+
+          // Paint static layers into image using the same viewport and settings
+          GeoPainter imagePainter(&layerCacheImage, viewport, painter->mapQuality());
+          imagePainter.setRenderHints(painter->renderHints());
+          imagePainter.setFont(painter->font());
+          context.painter = &imagePainter;
+          renderStaticLayers(false /* drawShip */);
+          context.painter = painter;
+          imagePainter.end();
+
+          layerCacheKey = cacheKey;
+          layerCacheValid = true;
+          layerCacheObjectCount = context.objectCount;
+          layerCacheQueryOverflow = context.queryOverflow;
         }
         else
         {
-          if(!context.isObjectOverflow())
-            mapPainterMsa->render();
-
-          if(!context.isObjectOverflow())
-            mapPainterNav->render();
-
-          if(!context.isObjectOverflow())
-            mapPainterAirport->render();
+          // Restore overflow status for top layer messages
+          context.objectCount = layerCacheObjectCount;
+          context.queryOverflow = layerCacheQueryOverflow;
         }
-      }
 
-      if(!context.isObjectOverflow())
-        mapPainterUser->render();
-
-      if(!context.isObjectOverflow())
-        mapPainterWind->render();
-
-      // if(!context.isOverflow()) always paint route even if number of objects is too large
-      mapPainterRoute->render();
-
-      if(!context.isObjectOverflow())
-        mapPainterWeather->render();
-
-      if(context.mapLayer->isAirportDiagram() && !context.isObjectOverflow())
-        mapPainterMsa->render();
+        painter->drawImage(QPointF(0., 0.), layerCacheImage);
 
-      if(!context.isObjectOverflow())
-        mapPainterTrack->render();
+        // Ships move and are drawn above cached layers
+        renderPainter(mapPainterShip, "Ship");
+      }
+      else
+      {
+        layerCacheValid = false;
+        renderStaticLayers(true /* drawShip */);
+      }
 
-      mapPainterAircraft->render();
+      renderDynamicLayers();
 
-      mapPainterMark->render();
+      context.labelCollisionGrid = nullptr;
 
-      mapPainterTop->render();
+      if(profileFrame)
+      {
+        renderProfiler->endFrame();
+        if(renderProfilerOverlay)
+          renderProfiler->paintOverlay(painter);
+      }
     } // if(!noRender())
 
     if(!mapWidget->isPrinting() && mapWidget->isVisibleWidget())
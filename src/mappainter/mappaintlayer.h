@@ -20,7 +20,10 @@
 
 #include "mappainter/mappainter.h"
 
+#include <QHash>
+#include <QImage>
 #include <QPen>
+#include <QTimer>
 
 #include <marble/LayerInterface.h>
 
@@ -51,6 +54,8 @@ class MapPainterAltitude;
 class MapPainterWeather;
 class MapPainterWind;
 class MapPaintWidget;
+class RenderProfiler;
+class LabelCollisionGrid;
 
 /*
  * Implements the Marble layer interface that paints upon the Marble map. Contains all painter instances
@@ -178,6 +183,12 @@ public:
 
   void dumpMapLayers() const;
 
+  /* Drop cached static layers. Next render call paints all layers. */
+  void invalidateLayerCache()
+  {
+    layerCacheValid = false;
+  }
+
   /* Airports actually drawn having parking spots which require tooltips and more */
   const QSet<int>& getShownDetailAirportIds() const
   {
@@ -187,6 +198,41 @@ public:
 private:
   void initMapLayerSettings();
 
+  /* Values which require repainting of the static layers if changed.
+   * All other changes are covered by invalidateLayerCache() */
+  struct LayerCacheKey
+  {
+    QSize size;
+    qreal pixelRatio = 1.;
+    int projection = 0, radius = 0;
+    qreal centerLon = 0., centerLat = 0.;
+    const MapLayer *mapLayer = nullptr, *mapLayerRoute = nullptr, *mapLayerEffective = nullptr;
+    map::MapTypes objectTypes = map::NONE;
+    map::MapObjectDisplayTypes objectDisplayTypes = map::DISPLAY_TYPE_NONE;
+    map::MapAirspaceFilter airspaceFilter;
+    map::MapWeatherSource weatherSource = map::WEATHER_SOURCE_SIMULATOR;
+    int activeLegIndex = -1;
+
+    bool operator==(const LayerCacheKey& other) const;
+
+  };
+
+  LayerCacheKey currentLayerCacheKey(const Marble::GeoPainter *painter, const Marble::ViewportParams *viewport) const;
+
+  /* Call render of painter and record values in profiler if enabled.
+   * Does nothing if the painter was dropped by the frame budget. */
+  void renderPainter(MapPainter *painter, const char *name);
+
+  /* Select painters to skip in this frame by priority based on the measured painter times
+   * and start the timer for a complete follow-up frame if any were dropped. */
+  void planFrameBudget();
+
+  /* Airspaces, airports, navaids, route and more. Ships are drawn below airspaces if drawShip is true. */
+  void renderStaticLayers(bool drawShip);
+
+  /* Trail, aircraft, marks and top layer */
+  void renderDynamicLayers();
+
   /* Implemented from LayerInterface: We  draw above all but below user tools */
   virtual QStringList renderPosition() const override
   {
@@ -239,6 +285,38 @@ private:
   const MapLayer *mapLayer = nullptr, *mapLayerRoute = nullptr, *mapLayerEffective = nullptr;
   bool verbose = false;
 
+  /* Not null if enabled in configuration. Records only frames of the visible map widget. */
+  RenderProfiler *renderProfiler = nullptr;
+  bool renderProfilerOverlay = false, profileFrame = false;
+
+  /* Not null if enabled in configuration. Drops overlapping airport and navaid labels. */
+  LabelCollisionGrid *labelCollisionGrid = nullptr;
+
+  /* Static layers painted into an image and reused if only dynamic layers like the user aircraft changed.
+   * Used only for the visible map widget while the map is still. */
+  QImage layerCacheImage;
+  LayerCacheKey layerCacheKey;
+  bool layerCacheEnabled = true, layerCacheValid = false;
+
+  /* Context values of the cached frame */
+  int layerCacheObjectCount = 0;
+  bool layerCacheQueryOverflow = false;
+
+  /* Maximum time for painters in milliseconds while the map is moving. 0 disables the budget. */
+  int frameBudgetMs = 0;
+
+  /* Painters in order of priority. The first ones are never skipped. */
+  QVector<MapPainter *> painterPriority;
+
+  /* Moving average of painter times in milliseconds in animation frames */
+  QHash<const MapPainter *, float> painterTimeMs;
+
+  /* Painters dropped for the current or last frame */
+  QSet<const MapPainter *> skippedPainters;
+
+  /* Draws all layers if painters were skipped and the map stops moving without leaving the animation state */
+  QTimer frameBudgetTimer;
+  bool frameBudgetFollowUp = false, frameBudgetDrawFast = false, measurePainters = false;
 };
 
 #endif // LITTLENAVMAP_MAPPAINTLAYER_H
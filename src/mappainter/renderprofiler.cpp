@@ -0,0 +1,252 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "mappainter/renderprofiler.h"
+
+#include "query/querytypes.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QTextStream>
+
+#include <algorithm>
+
+/* Number of frames used to calculate averages for the overlay */
+const static int OVERLAY_FRAMES = 20;
+
+RenderProfiler::RenderProfiler(int maxFramesParam)
+  : maxFrames(maxFramesParam)
+{
+  frames.resize(maxFrames);
+}
+
+void RenderProfiler::beginFrame(float distanceKm)
+{
+  currentFrame = Frame();
+  currentFrame.timestamp = QDateTime::currentDateTimeUtc();
+  currentFrame.distanceKm = distanceKm;
+  frameTimer.start();
+}
+
+void RenderProfiler::endFrame()
+{
+  currentFrame.timeUs = frameTimer.nsecsElapsed() / 1000L;
+
+  frames[nextFrame] = currentFrame;
+  nextFrame = (nextFrame + 1) % maxFrames;
+  numFrames = std::min(numFrames + 1, maxFrames);
+}
+
+void RenderProfiler::beginPainter(const char *name, int objectCount)
+{
+  const query::RectCacheStats& stats = query::rectCacheStats();
+  painterName = name;
+  painterObjects = objectCount;
+  painterCacheHits = stats.hits;
+  painterCacheMisses = stats.misses;
+  painterTimer.start();
+}
+
+void RenderProfiler::endPainter(int objectCount, bool overflow)
+{
+  const query::RectCacheStats& stats = query::rectCacheStats();
+  PainterSample sample;
+  sample.name = painterName;
+  sample.timeUs = painterTimer.nsecsElapsed() / 1000L;
+  sample.objects = objectCount - painterObjects;
+  sample.cacheHits = stats.hits - painterCacheHits;
+  sample.cacheMisses = stats.misses - painterCacheMisses;
+  sample.overflow = overflow;
+  currentFrame.painters.append(sample);
+}
+
+QVector<RenderProfiler::Frame> RenderProfiler::getFrames() const
+{
+  QVector<Frame> retval;
+  retval.reserve(numFrames);
+
+  // Oldest frame is at nextFrame if buffer is full
+  int first = numFrames < maxFrames ? 0 : nextFrame;
+  for(int i = 0; i < numFrames; i++)
+    retval.append(frames.at((first + i) % maxFrames));
+  return retval;
+}
+
+void RenderProfiler::paintOverlay(QPainter *painter) const
+{
+  if(numFrames == 0)
+    return;
+
+  // Sum up values per painter name over the last frames ===========================
+  struct Sum
+  {
+    const char *name;
+    qint64 timeUs;
+    int objects;
+    quint32 cacheHits, cacheMisses;
+    bool overflow;
+  };
+
+  QVector<Sum> sums;
+  qint64 frameTimeUs = 0;
+  int count = std::min(numFrames, OVERLAY_FRAMES);
+  for(int i = 0; i < count; i++)
+  {
+    const Frame& frame = frames.at((nextFrame - 1 - i + maxFrames) % maxFrames);
+    frameTimeUs += frame.timeUs;
+
+    for(const PainterSample& sample : frame.painters)
+    {
+      auto it = std::find_if(sums.begin(), sums.end(), [&sample](const Sum& sum) -> bool {
+                  return sum.name == sample.name;
+                });
+      if(it == sums.end())
+        sums.append({sample.name, sample.timeUs, sample.objects, sample.cacheHits, sample.cacheMisses, sample.overflow});
+      else
+      {
+        it->timeUs += sample.timeUs;
+        it->objects += sample.objects;
+        it->cacheHits += sample.cacheHits;
+        it->cacheMisses += sample.cacheMisses;
+        it->overflow |= sample.overflow;
+      }
+    }
+  }
+
+  // Build text lines ===========================
+  QStringList lines;
+  lines.append(QString("Frame %1 ms (%2 frames)").arg(frameTimeUs / 1000. / count, 0, 'f', 2).arg(count));
+  for(const Sum& sum : sums)
+    lines.append(QString("%1 %2 ms, %3 obj, cache %4/%5%6").
+                 arg(QString(sum.name), -10).
+                 arg(sum.timeUs / 1000. / count, 6, 'f', 2).
+                 arg(sum.objects / count).
+                 arg(sum.cacheHits).arg(sum.cacheMisses).
+                 arg(sum.overflow ? QString(", overflow") : QString()));
+
+  // Draw ===========================
+  painter->save();
+  QFont font("Monospace");
+  font.setStyleHint(QFont::TypeWriter);
+  // Point size is -1 for pixel sized fonts
+  if(painter->font().pointSizeF() > 0.)
+    font.setPointSizeF(painter->font().pointSizeF());
+  else if(painter->font().pixelSize() > 0)
+    font.setPixelSize(painter->font().pixelSize());
+  painter->setFont(font);
+  QFontMetricsF metrics(font);
+
+  double width = 0.;
+  for(const QString& line : lines)
+    width = std::max(width, metrics.horizontalAdvance(line));
+
+  painter->setPen(Qt::NoPen);
+  painter->setBrush(QColor(255, 255, 255, 200));
+  painter->drawRect(QRectF(0., 0., width + 10., metrics.height() * lines.size() + 10.));
+
+  painter->setPen(Qt::black);
+  double y = 5. + metrics.ascent();
+  for(const QString& line : lines)
+  {
+    painter->drawText(QPointF(5., y), line);
+    y += metrics.height();
+  }
+  painter->restore();
+}
+
+QString RenderProfiler::toCsv() const
+{
+  QString csv;
+  QTextStream stream(&csv);
+  stream << "timestamp,frame_time_us,distance_km,painter,painter_time_us,objects,cache_hits,cache_misses,overflow\n";
+
+  for(const Frame& frame : getFrames())
+  {
+    for(const PainterSample& sample : frame.painters)
+      stream << frame.timestamp.toString(Qt::ISODateWithMs) << "," << frame.timeUs << "," << frame.distanceKm << ","
+             << sample.name << "," << sample.timeUs << "," << sample.objects << ","
+             << sample.cacheHits << "," << sample.cacheMisses << "," << (sample.overflow ? 1 : 0) << "\n";
+  }
+  stream.flush();
+  return csv;
+}
+
+QByteArray RenderProfiler::toJson() const
+{
+  QJsonArray frameArr;
+  for(const Frame& frame : getFrames())
+  {
+    QJsonArray painterArr;
+    for(const PainterSample& sample : frame.painters)
+    {
+      QJsonObject painterObj;
+      painterObj.insert("painter", QString(sample.name));
+      painterObj.insert("time_us", sample.timeUs);
+      painterObj.insert("objects", sample.objects);
+      painterObj.insert("cache_hits", static_cast<qint64>(sample.cacheHits));
+      painterObj.insert("cache_misses", static_cast<qint64>(sample.cacheMisses));
+      painterObj.insert("overflow", sample.overflow);
+      painterArr.append(painterObj);
+    }
+
+    QJsonObject frameObj;
+    frameObj.insert("timestamp", frame.timestamp.toString(Qt::ISODateWithMs));
+    frameObj.insert("time_us", frame.timeUs);
+    frameObj.insert("distance_km", static_cast<double>(frame.distanceKm));
+    frameObj.insert("painters", painterArr);
+    frameArr.append(frameObj);
+  }
+  return QJsonDocument(frameArr).toJson();
+}
+
+bool RenderProfiler::writeCsv(const QString& filename) const
+{
+  QFile file(filename);
+  if(file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    file.write(toCsv().toUtf8());
+    file.close();
+    qDebug() << Q_FUNC_INFO << "Wrote" << numFrames << "frames to" << filename;
+    return true;
+  }
+  else
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot open" << filename << file.errorString();
+    return false;
+  }
+}
+
+bool RenderProfiler::writeJson(const QString& filename) const
+{
+  QFile file(filename);
+  if(file.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    file.write(toJson());
+    file.close();
+    qDebug() << Q_FUNC_INFO << "Wrote" << numFrames << "frames to" << filename;
+    return true;
+  }
+  else
+  {
+    qWarning() << Q_FUNC_INFO << "Cannot open" << filename << file.errorString();
+    return false;
+  }
+}
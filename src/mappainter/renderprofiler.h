@@ -0,0 +1,99 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_RENDERPROFILER_H
+#define LITTLENAVMAP_RENDERPROFILER_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QVector>
+
+class QPainter;
+
+/*
+ * Records wall time, number of drawn objects, rect cache hits and misses and overflow status
+ * for each painter called by MapPaintLayer::render. The last frames are kept in a ring buffer.
+ *
+ * Can be shown as an overlay in the top left corner of the map and exported as CSV or JSON.
+ * Enabled by options "Options/RenderProfiler" and "Options/RenderProfilerOverlay" in the configuration file.
+ */
+class RenderProfiler
+{
+public:
+  /* Values for one painter call */
+  struct PainterSample
+  {
+    const char *name;
+    qint64 timeUs;
+    int objects;
+    quint32 cacheHits, cacheMisses;
+    bool overflow;
+  };
+
+  /* One call of MapPaintLayer::render */
+  struct Frame
+  {
+    QDateTime timestamp;
+    qint64 timeUs = 0;
+    float distanceKm = 0.f;
+    QVector<PainterSample> painters;
+  };
+
+  explicit RenderProfiler(int maxFramesParam = 500);
+
+  /* Start and stop frame. Frame is added to the ring buffer on end */
+  void beginFrame(float distanceKm);
+  void endFrame();
+
+  /* Has to be called around each painter. Object count is the total number of drawn objects from PaintContext */
+  void beginPainter(const char *name, int objectCount);
+  void endPainter(int objectCount, bool overflow);
+
+  /* Draw a table with average values per painter over the last frames */
+  void paintOverlay(QPainter *painter) const;
+
+  /* All frames in chronological order */
+  QVector<Frame> getFrames() const;
+
+  /* One line per painter and frame */
+  QString toCsv() const;
+
+  /* Array of frames with nested painters */
+  QByteArray toJson() const;
+
+  bool writeCsv(const QString& filename) const;
+  bool writeJson(const QString& filename) const;
+
+  bool isEmpty() const
+  {
+    return numFrames == 0;
+  }
+
+private:
+  QVector<Frame> frames;
+  int maxFrames, nextFrame = 0, numFrames = 0;
+
+  Frame currentFrame;
+  QElapsedTimer frameTimer, painterTimer;
+
+  /* Values at begin of current painter */
+  const char *painterName = nullptr;
+  int painterObjects = 0;
+  quint32 painterCacheHits = 0, painterCacheMisses = 0;
+};
+
+#endif // LITTLENAVMAP_RENDERPROFILER_H
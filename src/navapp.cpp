@@ -513,7 +513,7 @@ const atools::geo::Pos& NavApp::getUserAircraftPos()
 void NavApp::updateAllMaps()
 {
   if(mainWindow->getMapWidget() != nullptr)
-    mainWindow->getMapWidget()->update();
+    mainWindow->getMapWidget()->updateAll();
 
   if(mainWindow->getProfileWidget() != nullptr)
     mainWindow->getProfileWidget()->update();
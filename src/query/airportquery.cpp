@@ -19,6 +19,7 @@
 
 #include "common/constants.h"
 #include "common/maptypesfactory.h"
+#include "common/sqlcolumnindex.h"
 #include "query/querytypes.h"
 #include "common/mapresult.h"
 #include "fs/common/binarygeometry.h"
@@ -558,12 +559,13 @@ const QList<map::MapParking> *AirportQuery::getParkingsForAirport(int airportId)
     parkingQuery->exec();
 
     QList<map::MapParking> *ps = new QList<map::MapParking>;
+    SqlColumnIndex columns = MapTypesFactory::parkingColumns();
     while(parkingQuery->next())
     {
       map::MapParking p;
 
       // Vehicle paths are filtered out in the compiler
-      mapTypesFactory->fillParking(parkingQuery->record(), p);
+      mapTypesFactory->fillParking(parkingQuery->record(), p, &columns);
       ps->append(p);
     }
     parkingCache.insert(airportId, ps);
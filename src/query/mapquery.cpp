@@ -22,6 +22,7 @@
 #include "common/mapresult.h"
 #include "common/maptools.h"
 #include "common/maptypesfactory.h"
+#include "common/sqlcolumnindex.h"
 #include "fs/util/fsutil.h"
 #include "logbook/logdatacontroller.h"
 #include "mapgui/mapairporthandler.h"
@@ -30,12 +31,15 @@
 #include "online/onlinedatacontroller.h"
 #include "query/airportquery.h"
 #include "query/airwaytrackquery.h"
+#include "query/userpointindex.h"
 #include "query/waypointtrackquery.h"
 #include "settings/settings.h"
 #include "sql/sqldatabase.h"
 #include "sql/sqlutil.h"
 #include "userdata/userdatacontroller.h"
 
+#include <QElapsedTimer>
+
 using namespace Marble;
 using namespace atools::sql;
 using namespace atools::geo;
@@ -975,55 +979,15 @@ const QList<map::MapUserpoint> MapQuery::getUserdataPoints(const GeoDataLatLonBo
 {
   QList<MapUserpoint> retval;
 
-  if(!query::valid(Q_FUNC_INFO, userdataPointByRectQuery))
-    return retval;
+  // Points are kept in memory by the index which is updated by the controller on changes
+  UserpointIndex *userpointIndex = NavApp::getUserdataController()->getUserpointIndex();
+  for(const GeoDataLatLonBox& r : query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
+    userpointIndex->getPoints(retval, r, types, typesAll, unknownType, distanceNm, queryMaxRows);
 
-  // No caching here since points can change and the dataset is usually small
+  // Cache has to be kept for map screen index
   userpointCache.clear();
+  userpointCache.list = retval;
 
-  // Display either unknown or any type
-  if(unknownType || !types.isEmpty())
-  {
-    bool allTypesSelected = types == typesAll;
-
-    for(const GeoDataLatLonBox& r : query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
-    {
-      query::bindRect(r, userdataPointByRectQuery);
-      userdataPointByRectQuery->bindValue(":dist", distanceNm);
-
-      QStringList queryTypes;
-      if(unknownType || (allTypesSelected && unknownType))
-        // Either query all unknows too and filter later or all and unknown are selected
-        queryTypes.append("%");
-      else
-        queryTypes = types;
-
-      for(const QString& queryType : queryTypes)
-      {
-        userdataPointByRectQuery->bindValue(":type", queryType);
-        userdataPointByRectQuery->exec();
-        while(userdataPointByRectQuery->next())
-        {
-          if(unknownType && !allTypesSelected)
-          {
-            // Need to filter manually here
-            QString pointType = userdataPointByRectQuery->valueStr("type");
-
-            // Ignore if not unknown and not in selected types
-            if(typesAll.contains(pointType) && !types.contains(pointType))
-              continue;
-          }
-
-          MapUserpoint userPoint;
-          mapTypesFactory->fillUserdataPoint(userdataPointByRectQuery->record(), userPoint);
-          retval.append(userPoint);
-
-          // Cache has to be kept for map screen index
-          userpointCache.list.append(userPoint);
-        }
-      }
-    }
-  }
   return retval;
 }
 
@@ -1228,6 +1192,14 @@ const QList<map::MapAirport> *MapQuery::fetchAirports(const Marble::GeoDataLatLo
   {
     bool navdata = NavApp::isNavdataAll();
 
+#ifdef DEBUG_INFORMATION
+    QElapsedTimer timer;
+    timer.start();
+#endif
+
+    // Column indexes are resolved once for all rows of each query
+    SqlColumnIndex columns = MapTypesFactory::airportColumns(), addonColumns = MapTypesFactory::airportColumns();
+
     for(const GeoDataLatLonBox& r : query::splitAtAntiMeridian(rect, queryRectInflationFactor, queryRectInflationIncrement))
     {
       // Avoid duplicates between both queries
@@ -1243,9 +1215,11 @@ const QList<map::MapAirport> *MapQuery::fetchAirports(const Marble::GeoDataLatLo
           MapAirport ap;
           if(overview)
             // Fill only a part of the object
-            mapTypesFactory->fillAirportForOverview(query->record(), ap, navdata, NavApp::isAirportDatabaseXPlane(navdata));
+            mapTypesFactory->fillAirportForOverview(query->record(), ap, navdata, NavApp::isAirportDatabaseXPlane(navdata),
+                                                    &columns);
           else
-            mapTypesFactory->fillAirport(query->record(), ap, true /* complete */, navdata, NavApp::isAirportDatabaseXPlane(navdata));
+            mapTypesFactory->fillAirport(query->record(), ap, true /* complete */, navdata,
+                                         NavApp::isAirportDatabaseXPlane(navdata), &columns);
 
           ids.insert(ap.id);
           airportCache.list.append(ap);
@@ -1263,15 +1237,21 @@ const QList<map::MapAirport> *MapQuery::fetchAirports(const Marble::GeoDataLatLo
           if(overview)
             // Fill only a part of the object
             mapTypesFactory->fillAirportForOverview(airportAddonByRectQuery->record(), ap, navdata,
-                                                    NavApp::isAirportDatabaseXPlane(navdata));
+                                                    NavApp::isAirportDatabaseXPlane(navdata), &addonColumns);
           else
             mapTypesFactory->fillAirport(airportAddonByRectQuery->record(), ap, true /* complete */, navdata,
-                                         NavApp::isAirportDatabaseXPlane(navdata));
+                                         NavApp::isAirportDatabaseXPlane(navdata), &addonColumns);
           if(!ids.contains(ap.id))
             airportCache.list.append(ap);
         }
       }
     }
+
+#ifdef DEBUG_INFORMATION
+    qint64 elapsedUs = std::max(timer.nsecsElapsed() / 1000L, static_cast<qint64>(1));
+    qDebug() << Q_FUNC_INFO << airportCache.list.size() << "airports in" << elapsedUs << "us,"
+             << airportCache.list.size() * 1000000L / elapsedUs << "rows per second";
+#endif
   }
   overflow = airportCache.validate(queryMaxRows);
   return &airportCache.list;
@@ -1491,11 +1471,6 @@ void MapQuery::initQueries()
     airportMsaByIdQuery->prepare("select " + msaQueryBase + " from airport_msa where airport_msa_id = :id");
   }
 
-  userdataPointByRectQuery = new SqlQuery(dbUser);
-  userdataPointByRectQuery->prepare("select * from userdata "
-                                    "where " + whereRect + " and visible_from > :dist and type like :type " +
-                                    whereLimit);
-
   markersByRectQuery = new SqlQuery(dbSim);
   markersByRectQuery->prepare(
     "select marker_id, type, ident, heading, lonx, laty "
@@ -1537,9 +1512,6 @@ void MapQuery::deInitQueries()
   delete holdingByRectQuery;
   holdingByRectQuery = nullptr;
 
-  delete userdataPointByRectQuery;
-  userdataPointByRectQuery = nullptr;
-
   delete vorByIdentQuery;
   vorByIdentQuery = nullptr;
   delete ndbByIdentQuery;
@@ -229,7 +229,7 @@ public:
   /* Get a partially filled runway list for the overview */
   const QList<map::MapRunway> *getRunwaysForOverview(int airportId);
 
-  /* Similar to getAirports but no caching since user points can change */
+  /* Similar to getAirports but uses the in memory userpoint index from UserdataController instead of SQL queries */
   const QList<map::MapUserpoint> getUserdataPoints(const Marble::GeoDataLatLonBox& rect, const QStringList& types,
                                                    const QStringList& typesAll, bool unknownType, float distanceNm);
 
@@ -298,7 +298,7 @@ private:
                         *airportMsaByRectQuery = nullptr, *airportMsaByIdentQuery = nullptr, *airportMsaByIdQuery = nullptr;
 
   atools::sql::SqlQuery *vorsByRectQuery = nullptr, *ndbsByRectQuery = nullptr, *markersByRectQuery = nullptr,
-                        *ilsByRectQuery = nullptr, *holdingByRectQuery = nullptr, *userdataPointByRectQuery = nullptr;
+                        *ilsByRectQuery = nullptr, *holdingByRectQuery = nullptr;
 
   atools::sql::SqlQuery *vorByIdentQuery = nullptr, *ndbByIdentQuery = nullptr, *ilsByIdentQuery = nullptr;
 
@@ -19,6 +19,7 @@
 
 #include "common/constants.h"
 #include "common/proctypes.h"
+#include "common/sqlcolumnindex.h"
 #include "common/unit.h"
 #include "fs/pln/flightplan.h"
 #include "fs/util/fsutil.h"
@@ -31,7 +32,10 @@
 #include "sql/sqlrecord.h"
 #include "sql/sqlquery.h"
 
+#include <QElapsedTimer>
 #include <QStringBuilder>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
 
 using atools::sql::SqlQuery;
 using atools::geo::Pos;
@@ -51,6 +55,31 @@ using proc::MapSpeedRestriction;
 namespace pln = atools::fs::pln;
 namespace ageo = atools::geo;
 
+/* Columns of approach_leg and transition_leg used by SqlColumnIndex. Order has to match LEG_COLUMN_NAMES. */
+enum LegColumn
+{
+  LEG_COL_APPROACH_LEG_ID, LEG_COL_TRANSITION_LEG_ID, LEG_COL_IS_MISSED, LEG_COL_TYPE, LEG_COL_TURN_DIRECTION,
+  LEG_COL_ARINC_DESCR_CODE, LEG_COL_FIX_TYPE, LEG_COL_FIX_IDENT, LEG_COL_FIX_REGION, LEG_COL_FIX_LONX,
+  LEG_COL_FIX_LATY, LEG_COL_RECOMMENDED_FIX_TYPE, LEG_COL_RECOMMENDED_FIX_IDENT, LEG_COL_RECOMMENDED_FIX_REGION,
+  LEG_COL_RECOMMENDED_FIX_LONX, LEG_COL_RECOMMENDED_FIX_LATY, LEG_COL_IS_FLYOVER, LEG_COL_IS_TRUE_COURSE,
+  LEG_COL_COURSE, LEG_COL_DISTANCE, LEG_COL_TIME, LEG_COL_THETA, LEG_COL_RHO, LEG_COL_ALTITUDE1, LEG_COL_ALTITUDE2,
+  LEG_COL_ALT_DESCRIPTOR, LEG_COL_SPEED_LIMIT, LEG_COL_SPEED_LIMIT_TYPE, LEG_COL_VERTICAL_ANGLE, LEG_COL_RNP
+};
+
+const static QStringList LEG_COLUMN_NAMES({
+  "approach_leg_id", "transition_leg_id", "is_missed", "type", "turn_direction", "arinc_descr_code", "fix_type",
+  "fix_ident", "fix_region", "fix_lonx", "fix_laty", "recommended_fix_type", "recommended_fix_ident",
+  "recommended_fix_region", "recommended_fix_lonx", "recommended_fix_laty", "is_flyover", "is_true_course", "course",
+  "distance", "time", "theta", "rho", "altitude1", "altitude2", "alt_descriptor", "speed_limit", "speed_limit_type",
+  "vertical_angle", "rnp"
+});
+
+/* Leg columns which are missing in some database versions */
+const static QStringList LEG_OPTIONAL_COLUMN_NAMES({
+  "arinc_descr_code", "fix_lonx", "fix_laty", "recommended_fix_lonx", "recommended_fix_laty", "speed_limit",
+  "vertical_angle", "rnp"
+});
+
 ProcedureQuery::ProcedureQuery(atools::sql::SqlDatabase *sqlDbNav)
   : dbNav(sqlDbNav)
 {
@@ -157,20 +186,21 @@ const MapProcedureLegs *ProcedureQuery::getProcedureLegs(const map::MapAirport&
     return getApproachLegs(airport, approachId);
 }
 
-proc::MapProcedureLeg ProcedureQuery::buildApproachLegEntry(const map::MapAirport& airport)
+proc::MapProcedureLeg ProcedureQuery::buildApproachLegEntry(const atools::sql::SqlRecord& rec, SqlColumnIndex& col,
+                                                            const map::MapAirport& airport)
 {
   MapProcedureLeg leg;
-  leg.legId = approachLegQuery->value("approach_leg_id").toInt();
-  leg.missed = approachLegQuery->value("is_missed").toBool();
-  buildLegEntry(approachLegQuery, leg, airport);
+  leg.legId = col.valueInt(rec, LEG_COL_APPROACH_LEG_ID);
+  leg.missed = col.valueBool(rec, LEG_COL_IS_MISSED);
+  buildLegEntry(rec, col, leg, airport);
   return leg;
 }
 
-proc::MapProcedureLeg ProcedureQuery::buildTransitionLegEntry(const map::MapAirport& airport)
+proc::MapProcedureLeg ProcedureQuery::buildTransitionLegEntry(const atools::sql::SqlRecord& rec, SqlColumnIndex& col,
+                                                              const map::MapAirport& airport)
 {
   MapProcedureLeg leg;
-
-  leg.legId = transitionLegQuery->value("transition_leg_id").toInt();
+  leg.legId = col.valueInt(rec, LEG_COL_TRANSITION_LEG_ID);
 
   // entry.dmeNavId = transitionLegQuery->value("dme_nav_id").toInt();
   // entry.dmeRadial = transitionLegQuery->value("dme_radial").toFloat();
@@ -183,42 +213,42 @@ proc::MapProcedureLeg ProcedureQuery::buildTransitionLegEntry(const map::MapAirp
   // }
 
   leg.missed = false;
-  buildLegEntry(transitionLegQuery, leg, airport);
+  buildLegEntry(rec, col, leg, airport);
   return leg;
 }
 
-void ProcedureQuery::buildLegEntry(atools::sql::SqlQuery *query, proc::MapProcedureLeg& leg,
+void ProcedureQuery::buildLegEntry(const atools::sql::SqlRecord& rec, SqlColumnIndex& col, proc::MapProcedureLeg& leg,
                                    const map::MapAirport& airport)
 {
-  leg.type = proc::procedureLegEnum(query->valueStr("type"));
+  leg.type = proc::procedureLegEnum(col.valueStr(rec, LEG_COL_TYPE));
 
-  leg.turnDirection = query->valueStr("turn_direction");
-  leg.arincDescrCode = query->valueStr("arinc_descr_code", QString()).toUpper();
+  leg.turnDirection = col.valueStr(rec, LEG_COL_TURN_DIRECTION);
+  leg.arincDescrCode = col.valueStr(rec, LEG_COL_ARINC_DESCR_CODE).toUpper();
 
-  leg.fixType = query->valueStr("fix_type");
-  leg.fixIdent = query->valueStr("fix_ident");
-  leg.fixRegion = query->valueStr("fix_region");
-  leg.fixPos.setLonX(query->valueFloat("fix_lonx", Pos::INVALID_VALUE));
-  leg.fixPos.setLatY(query->valueFloat("fix_laty", Pos::INVALID_VALUE));
+  leg.fixType = col.valueStr(rec, LEG_COL_FIX_TYPE);
+  leg.fixIdent = col.valueStr(rec, LEG_COL_FIX_IDENT);
+  leg.fixRegion = col.valueStr(rec, LEG_COL_FIX_REGION);
+  leg.fixPos.setLonX(col.valueFloat(rec, LEG_COL_FIX_LONX, Pos::INVALID_VALUE));
+  leg.fixPos.setLatY(col.valueFloat(rec, LEG_COL_FIX_LATY, Pos::INVALID_VALUE));
   if(leg.fixPos.isNull(Pos::POS_EPSILON_1M)) // In case field is present but null
     leg.fixPos = Pos();
 
   // query->value("fix_airport_ident");
-  leg.recFixType = query->valueStr("recommended_fix_type");
-  leg.recFixIdent = query->valueStr("recommended_fix_ident");
-  leg.recFixRegion = query->valueStr("recommended_fix_region");
-  leg.recFixPos.setLonX(query->valueFloat("recommended_fix_lonx", Pos::INVALID_VALUE));
-  leg.recFixPos.setLatY(query->valueFloat("recommended_fix_laty", Pos::INVALID_VALUE));
+  leg.recFixType = col.valueStr(rec, LEG_COL_RECOMMENDED_FIX_TYPE);
+  leg.recFixIdent = col.valueStr(rec, LEG_COL_RECOMMENDED_FIX_IDENT);
+  leg.recFixRegion = col.valueStr(rec, LEG_COL_RECOMMENDED_FIX_REGION);
+  leg.recFixPos.setLonX(col.valueFloat(rec, LEG_COL_RECOMMENDED_FIX_LONX, Pos::INVALID_VALUE));
+  leg.recFixPos.setLatY(col.valueFloat(rec, LEG_COL_RECOMMENDED_FIX_LATY, Pos::INVALID_VALUE));
   if(leg.recFixPos.isNull(Pos::POS_EPSILON_1M)) // In case field is present but null
     leg.recFixPos = Pos();
 
-  leg.flyover = query->valueBool("is_flyover");
-  leg.trueCourse = query->valueBool("is_true_course");
-  leg.course = query->valueFloat("course");
-  leg.distance = query->valueFloat("distance");
-  leg.time = query->valueFloat("time");
-  leg.theta = query->isNull("theta") ? map::INVALID_COURSE_VALUE : query->valueFloat("theta");
-  leg.rho = query->isNull("rho") ? map::INVALID_DISTANCE_VALUE : query->valueFloat("rho");
+  leg.flyover = col.valueBool(rec, LEG_COL_IS_FLYOVER);
+  leg.trueCourse = col.valueBool(rec, LEG_COL_IS_TRUE_COURSE);
+  leg.course = col.valueFloat(rec, LEG_COL_COURSE);
+  leg.distance = col.valueFloat(rec, LEG_COL_DISTANCE);
+  leg.time = col.valueFloat(rec, LEG_COL_TIME);
+  leg.theta = col.isNull(rec, LEG_COL_THETA) ? map::INVALID_COURSE_VALUE : col.valueFloat(rec, LEG_COL_THETA);
+  leg.rho = col.isNull(rec, LEG_COL_RHO) ? map::INVALID_DISTANCE_VALUE : col.valueFloat(rec, LEG_COL_RHO);
 
   leg.calculatedDistance = 0.f;
   leg.calculatedTrueCourse = 0.f;
@@ -226,12 +256,12 @@ void ProcedureQuery::buildLegEntry(atools::sql::SqlQuery *query, proc::MapProced
   leg.malteseCross = false;
   leg.intercept = false;
 
-  float alt1 = query->valueFloat("altitude1");
-  float alt2 = query->valueFloat("altitude2");
+  float alt1 = col.valueFloat(rec, LEG_COL_ALTITUDE1);
+  float alt2 = col.valueFloat(rec, LEG_COL_ALTITUDE2);
 
-  if(!query->isNull("alt_descriptor") && (alt1 > 0.f || alt2 > 0.f))
+  if(!col.isNull(rec, LEG_COL_ALT_DESCRIPTOR) && (alt1 > 0.f || alt2 > 0.f))
   {
-    QString descriptor = query->value("alt_descriptor").toString();
+    QString descriptor = col.valueStr(rec, LEG_COL_ALT_DESCRIPTOR);
 
     if(descriptor == "A")
     {
@@ -286,13 +316,13 @@ void ProcedureQuery::buildLegEntry(atools::sql::SqlQuery *query, proc::MapProced
     leg.altRestriction.alt2 = 0.f;
   }
 
-  if(query->hasField("speed_limit"))
+  if(col.contains(rec, LEG_COL_SPEED_LIMIT))
   {
-    float speedLimit = query->value("speed_limit").toFloat();
+    float speedLimit = col.valueFloat(rec, LEG_COL_SPEED_LIMIT);
 
     if(speedLimit > 1.f)
     {
-      QString type = query->value("speed_limit_type").toString();
+      QString type = col.valueStr(rec, LEG_COL_SPEED_LIMIT_TYPE);
 
       leg.speedRestriction.speed = speedLimit;
 
@@ -310,13 +340,13 @@ void ProcedureQuery::buildLegEntry(atools::sql::SqlQuery *query, proc::MapProced
     leg.speedRestriction.speed = 0.f;
   }
 
-  if(query->hasField("vertical_angle") && !query->isNull("vertical_angle"))
-    leg.verticalAngle = query->valueFloat("vertical_angle");
+  if(col.contains(rec, LEG_COL_VERTICAL_ANGLE) && !col.isNull(rec, LEG_COL_VERTICAL_ANGLE))
+    leg.verticalAngle = col.valueFloat(rec, LEG_COL_VERTICAL_ANGLE);
   else
     leg.verticalAngle = map::INVALID_ANGLE_VALUE;
 
-  if(query->hasField("rnp") && !query->isNull("rnp"))
-    leg.rnp = query->valueFloat("rnp");
+  if(col.contains(rec, LEG_COL_RNP) && !col.isNull(rec, LEG_COL_RNP))
+    leg.rnp = col.valueFloat(rec, LEG_COL_RNP);
   else
     leg.rnp = map::INVALID_DISTANCE_VALUE;
 
@@ -730,7 +760,7 @@ proc::MapProcedureLegs *ProcedureQuery::fetchTransitionLegs(const map::MapAirpor
 
     while(transitionLegQuery->next())
     {
-      legs->transitionLegs.append(buildTransitionLegEntry(airport));
+      legs->transitionLegs.append(buildTransitionLegEntry(transitionLegQuery->record(), transitionLegColumns, airport));
       legs->transitionLegs.last().airportId = airport.id;
       legs->transitionLegs.last().approachId = approachId;
       legs->transitionLegs.last().transitionId = transitionId;
@@ -779,6 +809,11 @@ proc::MapProcedureLegs *ProcedureQuery::buildApproachLegs(const map::MapAirport&
   if(!query::valid(Q_FUNC_INFO, approachLegQuery) || !query::valid(Q_FUNC_INFO, approachQuery))
     return nullptr;
 
+#ifdef DEBUG_INFORMATION
+  QElapsedTimer timer;
+  timer.start();
+#endif
+
   approachLegQuery->bindValue(":id", approachId);
   approachLegQuery->exec();
 
@@ -794,63 +829,239 @@ proc::MapProcedureLegs *ProcedureQuery::buildApproachLegs(const map::MapAirport&
   // Load all legs ======================
   while(approachLegQuery->next())
   {
-    legs->approachLegs.append(buildApproachLegEntry(airport));
+    legs->approachLegs.append(buildApproachLegEntry(approachLegQuery->record(), approachLegColumns, airport));
     legs->approachLegs.last().airportId = airport.id;
     legs->approachLegs.last().approachId = approachId;
   }
 
+#ifdef DEBUG_INFORMATION
+  qint64 elapsedUs = std::max(timer.nsecsElapsed() / 1000L, static_cast<qint64>(1));
+  qDebug() << Q_FUNC_INFO << legs->approachLegs.size() << "legs in" << elapsedUs << "us,"
+           << legs->approachLegs.size() * 1000000L / elapsedUs << "rows per second";
+#endif
+
   // Load basic approach information ======================
   approachQuery->bindValue(":id", approachId);
   approachQuery->exec();
   if(approachQuery->next())
-  {
-    legs->approachType = approachQuery->valueStr("type");
-    legs->approachSuffix = approachQuery->valueStr("suffix");
-    legs->approachFixIdent = approachQuery->valueStr("fix_ident");
-    legs->approachArincName = approachQuery->valueStr("arinc_name", QString());
-    legs->aircraftCategory = approachQuery->valueStr("aircraft_category", QString());
-    legs->gpsOverlay = approachQuery->valueBool("has_gps_overlay", false);
-    legs->verticalAngle = approachQuery->valueBool("has_vertical_angle", false);
-    legs->rnp = approachQuery->valueBool("has_rnp", false);
-    legs->procedureRunway = approachQuery->valueStr("runway_name");
-  }
+    fillApproachInformation(*legs, approachQuery->record());
   approachQuery->finish();
 
   // Get all runway ends if they are in the database
-  bool runwayFound = false;
+  int runwayEndId = -1;
   runwayEndIdQuery->bindValue(":id", approachId);
   runwayEndIdQuery->exec();
   if(runwayEndIdQuery->next())
   {
     if(!runwayEndIdQuery->isNull("runway_end_id"))
-    {
-      legs->runwayEnd = airportQueryNav->getRunwayEndById(runwayEndIdQuery->value("runway_end_id").toInt());
-
-      // Add altitude to position since it is needed to display the first point in the SID
-      legs->runwayEnd.position.setAltitude(airport.getPosition().getAltitude());
-      runwayFound = true;
-    }
+      runwayEndId = runwayEndIdQuery->value("runway_end_id").toInt();
   }
   runwayEndIdQuery->finish();
 
-  if(!runwayFound)
+  fillRunwayEnd(airport, *legs, runwayEndId);
+
+  return legs;
+}
+
+void ProcedureQuery::fillApproachInformation(proc::MapProcedureLegs& legs, const atools::sql::SqlRecord& rec) const
+{
+  legs.approachType = rec.valueStr("type");
+  legs.approachSuffix = rec.valueStr("suffix");
+  legs.approachFixIdent = rec.valueStr("fix_ident");
+  legs.approachArincName = rec.valueStr("arinc_name", QString());
+  legs.aircraftCategory = rec.valueStr("aircraft_category", QString());
+  legs.gpsOverlay = rec.valueBool("has_gps_overlay", false);
+  legs.verticalAngle = rec.valueBool("has_vertical_angle", false);
+  legs.rnp = rec.valueBool("has_rnp", false);
+  legs.procedureRunway = rec.valueStr("runway_name");
+}
+
+void ProcedureQuery::fillRunwayEnd(const map::MapAirport& airport, proc::MapProcedureLegs& legs, int runwayEndId)
+{
+  if(runwayEndId != -1)
+  {
+    legs.runwayEnd = airportQueryNav->getRunwayEndById(runwayEndId);
+
+    // Add altitude to position since it is needed to display the first point in the SID
+    legs.runwayEnd.position.setAltitude(airport.getPosition().getAltitude());
+  }
+  else
   {
     // Nothing found in the database - search by name fuzzy or add a dummy entry if nothing was found by name
 #ifdef DEBUG_INFORMATION
-    qWarning() << "Runway end for approach" << approachId << "not found";
+    qWarning() << "Runway end for approach" << legs.ref.approachId << "not found";
 #endif
     map::MapResult result;
-    runwayEndByName(result, legs->procedureRunway, airport);
+    runwayEndByName(result, legs.procedureRunway, airport);
 
     if(!result.runwayEnds.isEmpty())
-      legs->runwayEnd = result.runwayEnds.constFirst();
+      legs.runwayEnd = result.runwayEnds.constFirst();
   }
+}
 
-  return legs;
+void ProcedureQuery::preloadProcedures(map::MapAirport airport)
+{
+  NavApp::getMapQueryGui()->getAirportNavReplace(airport);
+
+  if(!airport.isValid() || !query::valid(Q_FUNC_INFO, approachQuery))
+    return;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // Load all approaches of the airport ======================
+  // Not post processed legs by approach id - needed as a base for the transitions
+  QHash<int, MapProcedureLegs> approaches;
+  SqlQuery query(dbNav);
+  // Read the same columns as approachQuery to get the same values as in buildApproachLegs()
+  query.prepare("select a.approach_id, a." % approachColumns.join(", a.") % ", e.runway_end_id as valid_runway_end_id "
+                "from approach a left outer join runway_end e on a.runway_end_id = e.runway_end_id "
+                "where a.airport_id = :id");
+  query.bindValue(":id", airport.id);
+  query.exec();
+  while(query.next())
+  {
+    MapProcedureLegs legs;
+    legs.ref.airportId = airport.id;
+    legs.ref.approachId = query.valueInt("approach_id");
+    legs.ref.transitionId = -1;
+    legs.ref.mapType = legs.mapType;
+    legs.circleToLand = false;
+    fillApproachInformation(legs, query.record());
+    fillRunwayEnd(airport, legs, query.isNull("valid_runway_end_id") ? -1 : query.valueInt("valid_runway_end_id"));
+    approaches.insert(legs.ref.approachId, legs);
+  }
+
+  if(approaches.isEmpty())
+    return;
+
+  // Load all approach legs with one query ordered by approach ======================
+  SqlColumnIndex columns(LEG_COLUMN_NAMES);
+  query.prepare("select l.* from approach_leg l join approach a on l.approach_id = a.approach_id "
+                "where a.airport_id = :id order by l.approach_id, l.approach_leg_id");
+  query.bindValue(":id", airport.id);
+  query.exec();
+  while(query.next())
+  {
+    auto it = approaches.find(query.valueInt("approach_id"));
+    if(it != approaches.end())
+    {
+      it->approachLegs.append(buildApproachLegEntry(query.record(), columns, airport));
+      it->approachLegs.last().airportId = airport.id;
+      it->approachLegs.last().approachId = it->ref.approachId;
+    }
+  }
+
+  // Collect all procedures which are not cached yet
+  QVector<MapProcedureLegs *> newApproaches, newTransitions;
+  for(auto it = approaches.constBegin(); it != approaches.constEnd(); ++it)
+  {
+    if(!procedureCache.contains(it.key()))
+      newApproaches.append(new MapProcedureLegs(it.value()));
+  }
+
+  // Load all transitions of the airport ======================
+  QHash<int, MapProcedureLegs *> transitions;
+  query.prepare("select t.transition_id, t.approach_id, t.type, t.fix_ident from transition t "
+                "join approach a on t.approach_id = a.approach_id where a.airport_id = :id");
+  query.bindValue(":id", airport.id);
+  query.exec();
+  while(query.next())
+  {
+    int transitionId = query.valueInt("transition_id");
+    auto approachIt = approaches.constFind(query.valueInt("approach_id"));
+
+    if(approachIt != approaches.constEnd() && !transitionCache.contains(transitionId))
+    {
+      // Add a full copy of the approach because approach legs will be modified for different transitions
+      MapProcedureLegs *legs = new MapProcedureLegs(approachIt.value());
+      legs->ref.transitionId = transitionId;
+      legs->transitionType = query.valueStr("type");
+      legs->transitionFixIdent = query.valueStr("fix_ident");
+      transitions.insert(transitionId, legs);
+      newTransitions.append(legs);
+    }
+  }
+
+  // Load all transition legs with one query ordered by transition ======================
+  if(!transitions.isEmpty())
+  {
+    columns.reset();
+    query.prepare("select l.* from transition_leg l join transition t on l.transition_id = t.transition_id "
+                  "join approach a on t.approach_id = a.approach_id "
+                  "where a.airport_id = :id order by l.transition_id, l.transition_leg_id");
+    query.bindValue(":id", airport.id);
+    query.exec();
+    while(query.next())
+    {
+      MapProcedureLegs *legs = transitions.value(query.valueInt("transition_id"), nullptr);
+      if(legs != nullptr)
+      {
+        legs->transitionLegs.append(buildTransitionLegEntry(query.record(), columns, airport));
+        legs->transitionLegs.last().airportId = airport.id;
+        legs->transitionLegs.last().approachId = legs->ref.approachId;
+        legs->transitionLegs.last().transitionId = legs->ref.transitionId;
+      }
+    }
+  }
+  query.finish();
+
+  qint64 loadMs = timer.restart();
+
+  // Post process all new procedures in parallel ======================
+  // Calculation does not access the database - get the simulator airport altitude once in advance
+  float airportAltitude = airportAltitudeSim(airport);
+  QVector<MapProcedureLegs *> allLegs = newApproaches + newTransitions;
+  int numThreads = std::max(1, std::min(QThread::idealThreadCount(), allLegs.size()));
+  QVector<QFuture<void> > futures;
+  for(int thread = 0; thread < numThreads; thread++)
+  {
+    futures.append(QtConcurrent::run([this, &airport, &allLegs, airportAltitude, thread, numThreads]() -> void {
+                                       for(int i = thread; i < allLegs.size(); i += numThreads)
+                                         postProcessLegs(airport, *allLegs[i], true /*addArtificialLegs*/,
+                                                         airportAltitude);
+                                     }));
+  }
+
+  for(QFuture<void>& future : futures)
+    future.waitForFinished();
+
+  // Fill caches and indexes ======================
+  // Make sure the caches can hold all procedures of the airport
+  procedureCache.setMaxCost(std::max(procedureCache.maxCost(), approaches.size()));
+  transitionCache.setMaxCost(std::max(transitionCache.maxCost(), transitions.size()));
+
+  for(MapProcedureLegs *legs : newApproaches)
+  {
+    for(int i = 0; i < legs->size(); i++)
+      procedureLegIndex.insert(legs->at(i).legId, std::make_pair(legs->ref.approachId, i));
+    procedureCache.insert(legs->ref.approachId, legs);
+  }
+
+  for(MapProcedureLegs *legs : newTransitions)
+  {
+    for(int i = 0; i < legs->size(); i++)
+      transitionLegIndex.insert(legs->at(i).legId, std::make_pair(legs->ref.transitionId, i));
+    transitionCache.insert(legs->ref.transitionId, legs);
+  }
+
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << airport.ident << newApproaches.size() << "procedures and"
+           << newTransitions.size() << "transitions loaded in" << loadMs << "ms, processed in"
+           << timer.elapsed() << "ms using" << numThreads << "threads";
+#else
+  Q_UNUSED(loadMs)
+#endif
 }
 
 void ProcedureQuery::postProcessLegs(const map::MapAirport& airport, proc::MapProcedureLegs& legs,
                                      bool addArtificialLegs) const
+{
+  postProcessLegs(airport, legs, addArtificialLegs, map::INVALID_ALTITUDE_VALUE);
+}
+
+void ProcedureQuery::postProcessLegs(const map::MapAirport& airport, proc::MapProcedureLegs& legs,
+                                     bool addArtificialLegs, float airportAltitude) const
 {
   // Clear lists so this method can run twice on a legs object
   for(MapProcedureLeg& leg : legs.approachLegs)
@@ -892,7 +1103,7 @@ void ProcedureQuery::postProcessLegs(const map::MapAirport& airport, proc::MapPr
   processLegsDistanceAndCourse(legs);
 
   // Correct overlapping conflicting altitude restrictions
-  processLegsFixRestrictions(airport, legs);
+  processLegsFixRestrictions(airport, legs, airportAltitude);
 
   // Update bounding rectangle
   updateBounding(legs);
@@ -1211,7 +1422,14 @@ void ProcedureQuery::processLegErrors(proc::MapProcedureLegs& legs) const
   }
 }
 
-void ProcedureQuery::processLegsFixRestrictions(const map::MapAirport& airport, proc::MapProcedureLegs& legs) const
+float ProcedureQuery::airportAltitudeSim(const map::MapAirport& airport) const
+{
+  map::MapAirport airportSim = NavApp::getMapQueryGui()->getAirportSim(airport);
+  return airportSim.isValid() ? airportSim.position.getAltitude() : airport.position.getAltitude();
+}
+
+void ProcedureQuery::processLegsFixRestrictions(const map::MapAirport& airport, proc::MapProcedureLegs& legs,
+                                                float airportAltitude) const
 {
   for(int i = 1; i < legs.size(); i++)
   {
@@ -1242,8 +1460,8 @@ void ProcedureQuery::processLegsFixRestrictions(const map::MapAirport& airport,
       // Last leg before missed approach - usually runway
       // Correct restriction to used simulator airport where it is wrongly below airport altitude for some
 
-      map::MapAirport airportSim = NavApp::getMapQueryGui()->getAirportSim(airport);
-      float airportAlt = airportSim.isValid() ? airportSim.position.getAltitude() : airport.position.getAltitude();
+      // Look up simulator airport only if not passed in
+      float airportAlt = airportAltitude < map::INVALID_ALTITUDE_VALUE ? airportAltitude : airportAltitudeSim(airport);
 
       if(prevLeg.altRestriction.alt1 < airportAlt)
       {
@@ -1944,6 +2162,10 @@ void ProcedureQuery::initQueries()
   transitionLegQuery->prepare("select * from transition_leg where transition_id = :id "
                               "order by transition_leg_id");
 
+  // Column indexes are resolved with the first row of each query
+  approachLegColumns = SqlColumnIndex(LEG_COLUMN_NAMES, LEG_OPTIONAL_COLUMN_NAMES);
+  transitionLegColumns = SqlColumnIndex(LEG_COLUMN_NAMES, LEG_OPTIONAL_COLUMN_NAMES);
+
   transitionIdForLegQuery = new SqlQuery(dbNav);
   transitionIdForLegQuery->prepare("select transition_id as id from transition_leg where transition_leg_id = :id");
 
@@ -1962,8 +2184,8 @@ void ProcedureQuery::initQueries()
 
   if(dbNav->record("approach").contains("arinc_name"))
   {
-    approachQuery->prepare("select type, arinc_name, suffix, has_gps_overlay, fix_ident, runway_name "
-                           "from approach where approach_id = :id");
+    approachColumns = QStringList({"type", "arinc_name", "suffix", "has_gps_overlay", "fix_ident", "runway_name"});
+    approachQuery->prepare("select " % approachColumns.join(", ") % " from approach where approach_id = :id");
 
     approachIdByNameQuery->prepare("select approach_id, arinc_name, suffix, runway_name from approach "
                                    "where fix_ident like :fixident and type like :type and airport_ident = :apident");
@@ -1974,8 +2196,8 @@ void ProcedureQuery::initQueries()
   }
   else
   {
-    approachQuery->prepare("select type, suffix, has_gps_overlay, fix_ident, runway_name "
-                           "from approach where approach_id = :id");
+    approachColumns = QStringList({"type", "suffix", "has_gps_overlay", "fix_ident", "runway_name"});
+    approachQuery->prepare("select " % approachColumns.join(", ") % " from approach where approach_id = :id");
 
     approachIdByNameQuery->prepare("select approach_id, suffix, runway_name from approach "
                                    "where fix_ident like :fixident and type like :type and airport_ident = :apident");
@@ -2004,6 +2226,9 @@ void ProcedureQuery::deInitQueries()
   delete transitionLegQuery;
   transitionLegQuery = nullptr;
 
+  approachLegColumns.reset();
+  transitionLegColumns.reset();
+
   delete transitionIdForLegQuery;
   transitionIdForLegQuery = nullptr;
 
@@ -20,6 +20,7 @@
 
 #include "common/procflags.h"
 #include "common/mapflags.h"
+#include "common/sqlcolumnindex.h"
 #include "fs/fspaths.h"
 
 #include <QCache>
@@ -89,6 +90,10 @@ public:
   /* Get transition and its approach */
   const proc::MapProcedureLegs *getTransitionLegs(map::MapAirport airport, int transitionId);
 
+  /* Loads all procedures and transitions of an airport with a few bulk queries and fills the caches.
+   * Legs are post processed in parallel. Procedures which are already cached are not loaded again. */
+  void preloadProcedures(map::MapAirport airport);
+
   /* Get all available transitions for the given procedure ID (approach.approach_id in database */
   QVector<int> getTransitionIdsForProcedure(int procedureId);
 
@@ -152,17 +157,30 @@ public:
                                const map::MapAirport& airport);
 
 private:
-  proc::MapProcedureLeg buildTransitionLegEntry(const map::MapAirport& airport);
-  proc::MapProcedureLeg buildApproachLegEntry(const map::MapAirport& airport);
-  void buildLegEntry(atools::sql::SqlQuery *query, proc::MapProcedureLeg& leg, const map::MapAirport& airport);
+  proc::MapProcedureLeg buildTransitionLegEntry(const atools::sql::SqlRecord& rec, SqlColumnIndex& col,
+                                                const map::MapAirport& airport);
+  proc::MapProcedureLeg buildApproachLegEntry(const atools::sql::SqlRecord& rec, SqlColumnIndex& col,
+                                              const map::MapAirport& airport);
+  void buildLegEntry(const atools::sql::SqlRecord& rec, SqlColumnIndex& col, proc::MapProcedureLeg& leg,
+                     const map::MapAirport& airport);
 
   void createCustomApproach(proc::MapProcedureLegs& procedure, const map::MapAirport& airport, const QString& runwayEnd,
                             float distance, float altitude, float offsetAngle);
   void createCustomDeparture(proc::MapProcedureLegs& procedure, const map::MapAirport& airport, const QString& runwayEnd,
                              float distance);
 
+  /* Fill type, suffix, runway and other fields from a record of table approach */
+  void fillApproachInformation(proc::MapProcedureLegs& legs, const atools::sql::SqlRecord& rec) const;
+
+  /* Load runway end by id or by name if id is -1 */
+  void fillRunwayEnd(const map::MapAirport& airport, proc::MapProcedureLegs& legs, int runwayEndId);
+
   /* See comments in postProcessLegs about the steps below */
   void postProcessLegs(const map::MapAirport& airport, proc::MapProcedureLegs& legs, bool addArtificialLegs) const;
+
+  /* Does not access the database if airportAltitude is given and can therefore run in a thread */
+  void postProcessLegs(const map::MapAirport& airport, proc::MapProcedureLegs& legs, bool addArtificialLegs,
+                       float airportAltitude) const;
   void processLegs(proc::MapProcedureLegs& legs) const;
   void processLegErrors(proc::MapProcedureLegs& legs) const;
   void processAltRestrictions(proc::MapProcedureLegs& procedure) const;
@@ -179,8 +197,13 @@ private:
                              bool addArtificialLegs) const;
 
   /* Adjust conflicting altitude restrictions where a transition ends with "A2000" and is the same as the following
-   * initial fix having "2000". Also corrects final altitude restriction if below airport. */
-  void processLegsFixRestrictions(const map::MapAirport& airport, proc::MapProcedureLegs& legs) const;
+   * initial fix having "2000". Also corrects final altitude restriction if below airport.
+   * Altitude of the simulator airport is looked up if airportAltitude is INVALID_ALTITUDE_VALUE. */
+  void processLegsFixRestrictions(const map::MapAirport& airport, proc::MapProcedureLegs& legs,
+                                  float airportAltitude) const;
+
+  /* Get altitude of the simulator airport or the navdata airport if not found */
+  float airportAltitudeSim(const map::MapAirport& airport) const;
 
   /* Assign magnetic variation from the navaids */
   void updateMagvar(const map::MapAirport& airport, proc::MapProcedureLegs& legs) const;
@@ -238,6 +261,13 @@ private:
                         *transitionIdByNameQuery = nullptr, *approachIdByNameQuery = nullptr,
                         *approachIdByArincNameQuery = nullptr, *transitionIdsForApproachQuery = nullptr;
 
+  /* Column indexes for approachLegQuery and transitionLegQuery. Reset when queries are prepared again. */
+  SqlColumnIndex approachLegColumns, transitionLegColumns;
+
+  /* Columns of table approach read by fillApproachInformation(). Used by approachQuery and preloadProcedures().
+   * Depends on database version. */
+  QStringList approachColumns;
+
   /* approach ID and transition ID to full lists
    * The approach also has to be stored for transitions since the handover can modify approach legs (CI legs, etc.) */
   QCache<int, proc::MapProcedureLegs> procedureCache, transitionCache;
@@ -24,6 +24,12 @@ using namespace Marble;
 
 namespace query {
 
+RectCacheStats& rectCacheStats()
+{
+  static RectCacheStats stats;
+  return stats;
+}
+
 void inflateQueryRect(Marble::GeoDataLatLonBox& rect, double factor, double increment)
 {
   rect.scale(1. + factor, 1. + factor);
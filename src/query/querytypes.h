@@ -58,6 +58,16 @@ QList<Marble::GeoDataLatLonBox> splitAtAntiMeridian(const Marble::GeoDataLatLonB
 /* Inflate rect by width and height in degrees. If it crosses the poles or date line it will be limited */
 void inflateQueryRect(Marble::GeoDataLatLonBox& rect, double factor, double increment);
 
+/* Hit and miss counters for all SimpleRectCache instances. A miss requires the caller to run a query.
+ * Used by the render profiler. Not thread safe. All map painting including the offscreen map widget for the
+ * web server runs in the GUI thread. */
+struct RectCacheStats
+{
+  quint32 hits = 0, misses = 0;
+};
+
+RectCacheStats& rectCacheStats();
+
 template<typename ID>
 const atools::sql::SqlRecord *cachedRecord(QCache<ID, atools::sql::SqlRecord>& cache,
                                            atools::sql::SqlQuery *query, ID id);
@@ -98,8 +108,11 @@ bool SimpleRectCache<TYPE>::updateCache(const Marble::GeoDataLatLonBox& rect, co
                                         double increment, bool lazy, LayerCompareFunc funcSameLayer)
 {
   if(lazy)
+  {
     // Nothing changed
+    rectCacheStats().hits++;
     return false;
+  }
 
   // Store bounding rectangle and inflate it
 
@@ -121,8 +134,10 @@ bool SimpleRectCache<TYPE>::updateCache(const Marble::GeoDataLatLonBox& rect, co
     list.clear();
     curRect = rect;
     curMapLayer = mapLayer;
+    rectCacheStats().misses++;
     return true;
   }
+  rectCacheStats().hits++;
   return false;
 }
 
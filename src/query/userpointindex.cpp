@@ -0,0 +1,242 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "query/userpointindex.h"
+
+#include "atools.h"
+#include "common/maptypesfactory.h"
+#include "sql/sqldatabase.h"
+#include "sql/sqlquery.h"
+
+#include <marble/GeoDataLatLonBox.h>
+
+#include <QElapsedTimer>
+
+using namespace Marble;
+using atools::sql::SqlQuery;
+
+/* One degree grid */
+const static int GRID_COLUMNS = 360;
+const static int GRID_ROWS = 180;
+
+UserpointIndex::UserpointIndex(atools::sql::SqlDatabase *sqlDb)
+  : db(sqlDb)
+{
+  mapTypesFactory = new MapTypesFactory();
+}
+
+UserpointIndex::~UserpointIndex()
+{
+  delete mapTypesFactory;
+}
+
+void UserpointIndex::reset()
+{
+  entries.clear();
+  cells.clear();
+  maxId = 0;
+  loaded = false;
+  revision++;
+}
+
+void UserpointIndex::loadAll()
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  entries.clear();
+  cells.clear();
+  maxId = 0;
+
+  SqlQuery query(db);
+  query.exec("select * from userdata");
+  loadFromQuery(query);
+  loaded = true;
+
+  qDebug() << Q_FUNC_INFO << entries.size() << "userpoints in" << timer.elapsed() << "ms";
+}
+
+void UserpointIndex::pointsAdded()
+{
+  if(loaded)
+  {
+    SqlQuery query(db);
+    query.prepare("select * from userdata where userdata_id > :id");
+    query.bindValue(":id", maxId);
+    query.exec();
+    loadFromQuery(query);
+  }
+  revision++;
+}
+
+void UserpointIndex::pointsUpdated(const QVector<int>& ids)
+{
+  if(loaded)
+  {
+    SqlQuery query(db);
+    query.prepare("select * from userdata where userdata_id = :id");
+    for(int id : ids)
+    {
+      removeEntry(id);
+      query.bindValue(":id", id);
+      query.exec();
+      loadFromQuery(query);
+    }
+  }
+  revision++;
+}
+
+void UserpointIndex::pointsRemoved(const QVector<int>& ids)
+{
+  if(loaded)
+  {
+    for(int id : ids)
+      removeEntry(id);
+  }
+  revision++;
+}
+
+void UserpointIndex::loadFromQuery(SqlQuery& query)
+{
+  while(query.next())
+  {
+    Entry entry;
+    mapTypesFactory->fillUserdataPoint(query.record(), entry.userpoint);
+    entry.visibleFromNm = query.valueFloat("visible_from");
+    entry.cell = cellIndex(entry.userpoint.position.getLonX(), entry.userpoint.position.getLatY());
+    insertEntry(entry);
+  }
+}
+
+void UserpointIndex::insertEntry(const Entry& entry)
+{
+  int id = entry.userpoint.id;
+  if(entries.contains(id))
+    removeEntry(id);
+
+  entries.insert(id, entry);
+  cells[entry.cell].append(id);
+  maxId = std::max(maxId, id);
+}
+
+void UserpointIndex::removeEntry(int id)
+{
+  auto it = entries.find(id);
+  if(it != entries.end())
+  {
+    auto cellIt = cells.find(it->cell);
+    if(cellIt != cells.end())
+    {
+      cellIt->removeOne(id);
+      if(cellIt->isEmpty())
+        cells.erase(cellIt);
+    }
+    entries.erase(it);
+  }
+}
+
+void UserpointIndex::getPoints(QList<map::MapUserpoint>& result, const GeoDataLatLonBox& rect, const QStringList& types,
+                               const QStringList& typesAll, bool unknownType, float distanceNm, int maxPoints)
+{
+  // Display either unknown or any type
+  if(!unknownType && types.isEmpty())
+    return;
+
+  if(!loaded)
+    loadAll();
+
+  bool allTypes = types == typesAll;
+  const QSet<QString> typeSet(types.begin(), types.end()), typesAllSet(typesAll.begin(), typesAll.end());
+
+  float west = static_cast<float>(rect.west(GeoDataCoordinates::Degree));
+  float east = static_cast<float>(rect.east(GeoDataCoordinates::Degree));
+  float north = static_cast<float>(rect.north(GeoDataCoordinates::Degree));
+  float south = static_cast<float>(rect.south(GeoDataCoordinates::Degree));
+
+  int colMin = atools::minmax(0, GRID_COLUMNS - 1, static_cast<int>(std::floor(west + 180.f)));
+  int colMax = atools::minmax(0, GRID_COLUMNS - 1, static_cast<int>(std::floor(east + 180.f)));
+  int rowMin = atools::minmax(0, GRID_ROWS - 1, static_cast<int>(std::floor(south + 90.f)));
+  int rowMax = atools::minmax(0, GRID_ROWS - 1, static_cast<int>(std::floor(north + 90.f)));
+
+  auto addIfMatches = [&](const Entry& entry) -> bool {
+                        const atools::geo::Pos& pos = entry.userpoint.position;
+                        if(pos.getLonX() >= west && pos.getLonX() <= east && pos.getLatY() >= south &&
+                           pos.getLatY() <= north &&
+                           matches(entry, typeSet, typesAllSet, allTypes, unknownType, distanceNm))
+                        {
+                          result.append(entry.userpoint);
+                          return result.size() < maxPoints;
+                        }
+                        return true;
+                      };
+
+  if((colMax - colMin + 1) * (rowMax - rowMin + 1) > cells.size())
+  {
+    // Less occupied cells than cells in rectangle - check all occupied cells
+    for(auto it = cells.constBegin(); it != cells.constEnd(); ++it)
+    {
+      int col = it.key() % GRID_COLUMNS, row = it.key() / GRID_COLUMNS;
+      if(col >= colMin && col <= colMax && row >= rowMin && row <= rowMax)
+      {
+        for(int id : it.value())
+        {
+          if(!addIfMatches(entries.value(id)))
+            return;
+        }
+      }
+    }
+  }
+  else
+  {
+    for(int row = rowMin; row <= rowMax; row++)
+    {
+      for(int col = colMin; col <= colMax; col++)
+      {
+        auto it = cells.constFind(row * GRID_COLUMNS + col);
+        if(it != cells.constEnd())
+        {
+          for(int id : it.value())
+          {
+            if(!addIfMatches(entries.value(id)))
+              return;
+          }
+        }
+      }
+    }
+  }
+}
+
+bool UserpointIndex::matches(const Entry& entry, const QSet<QString>& typeSet, const QSet<QString>& typesAllSet,
+                             bool allTypes, bool unknownType, float distanceNm) const
+{
+  if(!(entry.visibleFromNm > distanceNm))
+    return false;
+
+  const QString& type = entry.userpoint.type;
+  if(unknownType)
+    // All types if all are selected - otherwise ignore if not unknown and not in selected types
+    return allTypes || !typesAllSet.contains(type) || typeSet.contains(type);
+  else
+    return typeSet.contains(type);
+}
+
+int UserpointIndex::cellIndex(float lonX, float latY)
+{
+  int col = atools::minmax(0, GRID_COLUMNS - 1, static_cast<int>(std::floor(lonX + 180.f)));
+  int row = atools::minmax(0, GRID_ROWS - 1, static_cast<int>(std::floor(latY + 90.f)));
+  return row * GRID_COLUMNS + col;
+}
@@ -0,0 +1,115 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_USERPOINTINDEX_H
+#define LITTLENAVMAP_USERPOINTINDEX_H
+
+#include "common/maptypes.h"
+
+#include <QHash>
+#include <QSet>
+
+namespace atools {
+namespace sql {
+class SqlDatabase;
+class SqlQuery;
+}
+}
+
+namespace Marble {
+class GeoDataLatLonBox;
+}
+
+class MapTypesFactory;
+
+/*
+ * In memory copy of all userpoints from the user database in a grid of one degree cells.
+ * Used by MapQuery to get the userpoints for painting without running SQL queries for each frame.
+ *
+ * Data is loaded on first access. UserdataController notifies the index about all changes
+ * so it can be updated incrementally. The revision is increased with each change and can be used
+ * to validate caches depending on the userpoints.
+ *
+ * Not thread safe. Use only from the GUI thread.
+ */
+class UserpointIndex
+{
+public:
+  explicit UserpointIndex(atools::sql::SqlDatabase *sqlDb);
+  ~UserpointIndex();
+
+  UserpointIndex(const UserpointIndex& other) = delete;
+  UserpointIndex& operator=(const UserpointIndex& other) = delete;
+
+  /* Append all points to result which are inside rect and match the type and visibility filter.
+   * rect must not cross the anti-meridian. Stops after maxPoints were added.
+   * Semantics of the type filter are the same as in UserdataController. */
+  void getPoints(QList<map::MapUserpoint>& result, const Marble::GeoDataLatLonBox& rect, const QStringList& types,
+                 const QStringList& typesAll, bool unknownType, float distanceNm, int maxPoints);
+
+  /* Drop all data and load again on next access. Needed after undo, redo or bulk changes. */
+  void reset();
+
+  /* Load all points which were appended to the table after the last load. Used after add and import. */
+  void pointsAdded();
+
+  /* Reload given points. Used after edit and move. */
+  void pointsUpdated(const QVector<int>& ids);
+
+  /* Remove points from index. Used after delete. */
+  void pointsRemoved(const QVector<int>& ids);
+
+  /* Changes with each modification */
+  quint32 getRevision() const
+  {
+    return revision;
+  }
+
+private:
+  struct Entry
+  {
+    map::MapUserpoint userpoint;
+    float visibleFromNm;
+    int cell;
+  };
+
+  void loadAll();
+  void loadFromQuery(atools::sql::SqlQuery& query);
+  void insertEntry(const Entry& entry);
+  void removeEntry(int id);
+
+  /* Filter by type and visibility */
+  bool matches(const Entry& entry, const QSet<QString>& typeSet, const QSet<QString>& typesAllSet, bool allTypes,
+               bool unknownType, float distanceNm) const;
+
+  static int cellIndex(float lonX, float latY);
+
+  atools::sql::SqlDatabase *db;
+  MapTypesFactory *mapTypesFactory;
+
+  /* Userpoint id to entry */
+  QHash<int, Entry> entries;
+
+  /* Grid cell index to userpoint ids */
+  QHash<int, QVector<int> > cells;
+
+  int maxId = 0;
+  bool loaded = false;
+  quint32 revision = 0;
+};
+
+#endif // LITTLENAVMAP_USERPOINTINDEX_H
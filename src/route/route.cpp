@@ -36,6 +36,7 @@
 #include "settings/settings.h"
 #include "weather/windreporter.h"
 
+#include <QAtomicInteger>
 #include <QBitArray>
 #include <QRegularExpression>
 #include <QStringBuilder>
@@ -55,11 +56,17 @@ using atools::fs::pln::Flightplan;
 // Disable leg activation if distance is larger
 const float MAX_FLIGHT_PLAN_DIST_FOR_CENTER_NM = 40.f;
 
+// Half of earth circumference - covers all segments
+const static float MAX_SEGMENT_SEARCH_DIST_METER = 20040000.f;
+
 // Invalid leg as default value
 const static RouteLeg EMPTY_ROUTELEG;
 
 const static QRegularExpression USER_WP_ID("^WP([0-9]+)$");
 
+// Source for Route::revision - shared by all route objects
+static QAtomicInteger<quint32> lastRevision(0);
+
 Route::Route()
 {
   resetActive();
@@ -142,6 +149,14 @@ void Route::copy(const Route& other)
   destRunwayIlsProfile = other.destRunwayIlsProfile;
   destRunwayIlsFlightPlanTable = other.destRunwayIlsFlightPlanTable;
   destRunwayEnd = other.destRunwayEnd;
+  segmentIndex = other.segmentIndex;
+
+  // Do a full update on next call of updateAll()
+  changedFrom = changedTo = -1;
+  changedAll = true;
+
+  // Same legs - keep revision to allow reusing the copied altitude calculation
+  revision = other.revision;
 
   // Update flightplan pointers to this instance
   for(RouteLeg& routeLeg : *this)
@@ -545,15 +560,7 @@ bool Route::getRouteDistances(float *distFromStart, float *distToDest,
       *nextLegDistance = static_cast<float>(distToCurrent);
 
     // Sum up all distances along the legs
-    // Ignore missed approach legs until the active is a missedd approach leg
-    double fromStart = 0.;
-    for(int i = 0; i <= routeIndex; i++)
-    {
-      if(!value(i).getProcedureLeg().isMissed() || activeIsMissed || !value(i).isAlternate() || activeIsAlternate)
-        fromStart += value(i).getDistanceTo();
-      else
-        break;
-    }
+    double fromStart = legDistanceSum(0, routeIndex);
 
     double fromStartLegs = fromStart;
     fromStart -= distToCurrent;
@@ -576,34 +583,16 @@ bool Route::getRouteDistances(float *distFromStart, float *distToDest,
         if(activeIsMissed)
         {
           // Summarize remaining missed leg distance if on missed
-          for(int i = routeIndex + 1; i < size(); i++)
-          {
-            if(value(i).getProcedureLeg().isMissed())
-              toDest += value(i).getDistanceTo();
-          }
-          toDest += distToCurrent;
+          toDest = legDistanceSum(routeIndex + 1, size() - 1, RouteSegmentIndex::SUM_MISSED) + distToCurrent;
         }
         else if(activeIsAlternate)
         {
           // Summarize remaining leg distance to alternate if on alternate
-          for(int i = routeIndex + 1; i < size(); i++)
-          {
-            if(value(i).isAlternate())
-              toDest += value(i).getDistanceTo();
-          }
-          toDest += distToCurrent;
+          toDest = legDistanceSum(routeIndex + 1, size() - 1, RouteSegmentIndex::SUM_ALTERNATE) + distToCurrent;
         }
         else
         {
-          int destLegIdx = getDestinationLegIndex();
-          for(int i = routeIndex; i <= destLegIdx; i++)
-          {
-            if(!value(i).getProcedureLeg().isMissed() || activeIsMissed || !value(i).isAlternate() || activeIsAlternate)
-              toDest += value(i).getDistanceTo();
-            else
-              break;
-          }
-          toDest = toDest - value(routeIndex).getDistanceTo() + distToCurrent;
+          toDest = legDistanceSum(routeIndex, getDestinationLegIndex()) - value(routeIndex).getDistanceTo() + distToCurrent;
         }
       }
       *distToDest = atools::minmax(0.f, totalDistance, static_cast<float>(toDest));
@@ -636,9 +625,7 @@ float Route::getDistanceFromStart(const Pos& pos) const
   {
     if(result.status != atools::geo::INVALID)
     {
-      float fromstart = 0.f;
-      for(int i = 1; i <= legIndex; i++)
-        fromstart += value(i).getDistanceTo();
+      float fromstart = static_cast<float>(legDistanceSum(1, legIndex));
 
       return projectedDistance(result, fromstart, legIndex);
     }
@@ -1787,12 +1774,90 @@ void Route::updateAll()
   removeDuplicateRouteLegs();
   validateAirways();
   updateAlternateProperties();
-  updateMagvar();
-  updateDistancesAndCourse();
+
+  // Changed legs and their successors which have a new predecessor - otherwise all
+  int from = 0, to = size() - 1;
+  if(!changedAll && changedFrom >= 0)
+  {
+    from = std::max(0, std::min(changedFrom, size() - 1));
+    to = std::min(changedTo + 1, size() - 1);
+  }
+
+#ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "from" << from << "to" << to << "size" << size();
+#endif
+
+  // Only the expensive magvar lookups and geometry calculations are limited to the changed range
+  updateMagvar(from, to);
+  updateDistancesAndCourse(from, to);
+
+  // Linear passes over all legs - segment index cells are keyed by leg index which shifts on insert and remove
   updateBoundingRect();
   updateWaypointNames();
   updateDepartureAndDestination();
   updateApproachIls();
+
+  // Index is keyed on the revision - assign new one before building
+  newRevision();
+  segmentIndex.build(*this);
+
+  changedFrom = changedTo = -1;
+  changedAll = false;
+}
+
+void Route::legInserted(int index)
+{
+  // Move range if leg was inserted before or within
+  if(changedFrom >= 0)
+  {
+    if(index <= changedFrom)
+    {
+      changedFrom++;
+      changedTo++;
+    }
+    else if(index <= changedTo)
+      changedTo++;
+  }
+  legsChanged(index, index);
+}
+
+void Route::legRemoved(int index)
+{
+  // Move range if leg was removed before or within
+  if(changedFrom >= 0)
+  {
+    if(index < changedFrom)
+    {
+      changedFrom--;
+      changedTo--;
+    }
+    else if(index <= changedTo)
+      changedTo = std::max(changedFrom, changedTo - 1);
+  }
+
+  // Leg now at index has a new predecessor
+  legsChanged(index, index);
+}
+
+void Route::newRevision()
+{
+  revision = lastRevision.fetchAndAddRelaxed(1) + 1;
+}
+
+void Route::legsChanged(int from, int to)
+{
+  newRevision();
+
+  if(changedFrom < 0)
+  {
+    changedFrom = from;
+    changedTo = to;
+  }
+  else
+  {
+    changedFrom = std::min(changedFrom, from);
+    changedTo = std::max(changedTo, to);
+  }
 }
 
 void Route::updateWaypointNames()
@@ -1960,7 +2025,7 @@ void Route::setActiveLeg(int value)
   }
 }
 
-bool Route::isAirportAfterArrival(int index)
+bool Route::isAirportAfterArrival(int index) const
 {
   return (hasAnyApproachProcedure() /*|| hasStarProcedure()*/) &&
          index == getDestinationAirportLegIndex() && value(index).getMapObjectType() == map::AIRPORT;
@@ -2001,7 +2066,7 @@ void Route::removeAllExceptRange(int from, int to)
     removeAllAt(row);
 }
 
-void Route::updateDistancesAndCourse()
+void Route::updateDistancesAndCourse(int from, int to)
 {
   totalDistance = 0.f;
   RouteLeg *last = nullptr, *beforeDestAirport = nullptr;
@@ -2021,7 +2086,8 @@ void Route::updateDistancesAndCourse()
         continue;
       }
 
-      leg.updateDistanceAndCourse(i, last);
+      if(i >= from && i <= to)
+        leg.updateDistanceAndCourse(i, last);
 
       if(!leg.getProcedureLeg().isMissed())
         // Do not sum up missed legs
@@ -2037,17 +2103,17 @@ void Route::updateDistancesAndCourse()
 #endif
 }
 
-void Route::updateMagvar()
+void Route::updateMagvar(int from, int to)
 {
   // get magvar from internal database objects (waypoints, VOR and others)
-  for(int i = 0; i < size(); i++)
+  for(int i = from; i <= to; i++)
   {
     RouteLeg& leg = (*this)[i];
     leg.updateMagvar();
   }
 
   // Update variance for to VOR legs and for legs which are outbound from VOR to other waypoint type
-  for(int i = 1; i < size(); i++)
+  for(int i = std::max(from, 1); i <= to; i++)
   {
     RouteLeg& leg = (*this)[i];
     if(!leg.isRoute())
@@ -2100,23 +2166,10 @@ void Route::nearestAllLegIndex(const map::PosCourse& pos, float& crossTrackDista
   if(!pos.isValid())
     return;
 
-  float minDistance = map::INVALID_DISTANCE_VALUE;
-
-  // Check only until the approach starts if required
   atools::geo::LineDistance result;
-
-  for(int i = 1; i < size(); i++)
-  {
-    pos.pos.distanceMeterToLine(getPrevPositionAt(i), getPositionAt(i), result);
-    float distance = std::abs(result.distance);
-
-    if(result.status != atools::geo::INVALID && distance < minDistance)
-    {
-      minDistance = distance;
-      crossTrackDistanceMeter = result.distance;
-      index = i;
-    }
-  }
+  index = nearestLegSegment(pos.pos, result, atools::geo::nmToMeter(100.f));
+  if(index != map::INVALID_INDEX_VALUE)
+    crossTrackDistanceMeter = result.distance;
 
   if(crossTrackDistanceMeter < map::INVALID_DISTANCE_VALUE)
   {
@@ -2129,6 +2182,84 @@ void Route::nearestAllLegIndex(const map::PosCourse& pos, float& crossTrackDista
   }
 }
 
+int Route::nearestLegSegment(const Pos& pos, atools::geo::LineDistance& minResult, float maxDistanceMeter,
+                             const std::function<bool(int index)>& accept) const
+{
+  int index = map::INVALID_INDEX_VALUE;
+  minResult.status = atools::geo::INVALID;
+  minResult.distance = map::INVALID_DISTANCE_VALUE;
+
+  atools::geo::LineDistance result;
+  auto check = [&](int i) -> void {
+                 if(accept && !accept(i))
+                   return;
+
+                 pos.distanceMeterToLine(getPrevPositionAt(i), getPositionAt(i), result);
+                 if(result.status != atools::geo::INVALID && std::abs(result.distance) < std::abs(minResult.distance))
+                 {
+                   minResult = result;
+                   index = i;
+                 }
+               };
+
+  if(!segmentIndex.isValidFor(revision))
+  {
+    // Index not up to date - check all legs
+    for(int i = 1; i < size(); i++)
+      check(i);
+    return index;
+  }
+
+  // Increase search radius until a segment is found ============================
+  QVector<int> candidates;
+  float radiusMeter = std::min(RouteSegmentIndex::cellSizeMeter(), maxDistanceMeter);
+  while(true)
+  {
+    segmentIndex.candidates(candidates, pos, radiusMeter);
+    for(int i : candidates)
+      check(i);
+
+    if(index != map::INVALID_INDEX_VALUE || radiusMeter >= maxDistanceMeter)
+      break;
+    radiusMeter = std::min(radiusMeter * 4.f, maxDistanceMeter);
+  }
+
+  if(index != map::INVALID_INDEX_VALUE && std::abs(minResult.distance) > radiusMeter)
+  {
+    // Found segment is farther away than the search radius - closer ones might be missing in the candidates
+    segmentIndex.candidates(candidates, pos, std::abs(minResult.distance));
+    index = map::INVALID_INDEX_VALUE;
+    minResult.status = atools::geo::INVALID;
+    minResult.distance = map::INVALID_DISTANCE_VALUE;
+    for(int i : candidates)
+      check(i);
+  }
+
+  return index;
+}
+
+double Route::legDistanceSum(int from, int to, RouteSegmentIndex::DistanceSum type) const
+{
+  from = std::max(from, 0);
+  to = std::min(to, size() - 1);
+  if(from > to)
+    return 0.;
+
+  if(segmentIndex.isValidFor(revision))
+    return segmentIndex.getDistanceSum(to, type) - (from > 0 ? segmentIndex.getDistanceSum(from - 1, type) : 0.);
+
+  double sum = 0.;
+  for(int i = from; i <= to; i++)
+  {
+    const RouteLeg& leg = value(i);
+    if(type == RouteSegmentIndex::SUM_ALL ||
+       (type == RouteSegmentIndex::SUM_MISSED && leg.getProcedureLeg().isMissed()) ||
+       (type == RouteSegmentIndex::SUM_ALTERNATE && leg.isAlternate()))
+      sum += leg.getDistanceTo();
+  }
+  return sum;
+}
+
 int Route::getNearestRouteLegResult(const Pos& pos, atools::geo::LineDistance& lineDistanceResult, bool ignoreNotEditable,
                                     bool ignoreMissed) const
 {
@@ -2139,26 +2270,14 @@ int Route::getNearestRouteLegResult(const Pos& pos, atools::geo::LineDistance& l
   if(!pos.isValid())
     return index;
 
-  // Check only until the approach starts if required
-  atools::geo::LineDistance result, minResult;
-  minResult.status = atools::geo::INVALID;
-  minResult.distance = map::INVALID_DISTANCE_VALUE;
-
-  for(int i = 1; i < size(); i++)
-  {
+  atools::geo::LineDistance minResult;
+  index = nearestLegSegment(pos, minResult, MAX_SEGMENT_SEARCH_DIST_METER, [ignoreNotEditable, ignoreMissed, this](int i) -> bool {
     if(ignoreNotEditable && !canEditLeg(i))
-      continue;
+      return false;
     if(ignoreMissed && value(i).isAnyProcedure() && value(i).getProcedureLeg().isMissed())
-      continue;
-
-    pos.distanceMeterToLine(getPrevPositionAt(i), getPositionAt(i), result);
-
-    if(result.status != atools::geo::INVALID && std::abs(result.distance) < std::abs(minResult.distance))
-    {
-      minResult = result;
-      index = i;
-    }
-  }
+      return false;
+    return true;
+  });
 
   if(index != map::INVALID_INDEX_VALUE)
     lineDistanceResult = minResult;
@@ -2206,7 +2325,11 @@ void Route::setDepartureParking(const map::MapParking& departureParking)
   int idx = getDepartureAirportLegIndex();
 
   if(idx != map::INVALID_INDEX_VALUE)
+  {
+    // Changes distance to first SID leg
     (*this)[idx].setDepartureParking(departureParking);
+    legsChanged(idx, idx);
+  }
   else
     qWarning() << Q_FUNC_INFO << "invalid index" << idx;
 }
@@ -2216,7 +2339,11 @@ void Route::setDepartureStart(const map::MapStart& departureStart)
   int idx = getDepartureAirportLegIndex();
 
   if(idx != map::INVALID_INDEX_VALUE)
+  {
+    // Changes distance to first SID leg
     (*this)[idx].setDepartureStart(departureStart);
+    legsChanged(idx, idx);
+  }
   else
     qWarning() << Q_FUNC_INFO << "invalid index" << idx;
 }
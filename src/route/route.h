@@ -20,9 +20,12 @@
 
 #include "route/routeleg.h"
 #include "route/routeflags.h"
+#include "route/routesegmentindex.h"
 
 #include "fs/pln/flightplan.h"
 
+#include <functional>
+
 class CoordinateConverter;
 class FlightplanEntryBuilder;
 class RouteAltitude;
@@ -131,6 +134,13 @@ public:
     return numAlternateLegs;
   }
 
+  /* Changes whenever legs are modified or updateAll() is called. Unique across all route objects except copies.
+   * Used to detect if cached calculation results based on this route are still valid. */
+  quint32 getRevision() const
+  {
+    return revision;
+  }
+
   /* map::INVALID_INDEX_VALUE if no active.
    * 1 for first leg to route.size() - 1 for active legs.
    * 0 is special case for plans consisting of only one airport */
@@ -454,7 +464,11 @@ public:
   const atools::geo::Pos& getPrevPositionAt(int i) const;
 
   /* Update distance, course, bounding rect and total distance for route map objects.
-   *  Also calculates maximum number of user points. */
+   *  Also calculates maximum number of user points.
+   *  Magnetic variation, distance and course are only recalculated for legs changed by append, prepend, insert, replace,
+   *  move and remove since the last call and their successors. Does a full update if nothing was recorded.
+   *  Indexes, offsets, airway validation, bounding rectangle, waypoint names, departure/destination, ILS and the
+   *  segment index are still updated with linear passes over all legs. */
   void updateAll();
 
   /* Use an expensive heuristic to update the missing regions in all airports
@@ -468,7 +482,7 @@ public:
   void resetActive();
 
   /* true if type is airport at the given index and is after an arrival procedure (approach and transition) */
-  bool isAirportAfterArrival(int index);
+  bool isAirportAfterArrival(int index) const;
 
   /* Get approach and transition in one legs struct */
   const proc::MapProcedureLegs& getApproachLegs() const
@@ -529,31 +543,38 @@ public:
   void append(const RouteLeg& leg)
   {
     QList::append(leg);
+    legInserted(QList::size() - 1);
   }
 
   void prepend(const RouteLeg& leg)
   {
     QList::prepend(leg);
+    legInserted(0);
   }
 
   void insert(int before, const RouteLeg& leg)
   {
     QList::insert(before, leg);
+    legInserted(before);
   }
 
   void replace(int i, const RouteLeg& leg)
   {
     QList::replace(i, leg);
+    legsChanged(i, i);
   }
 
   void move(int from, int to)
   {
     QList::move(from, to);
+    legRemoved(from);
+    legInserted(to);
   }
 
   void removeAt(int i)
   {
     QList::removeAt(i);
+    legRemoved(i);
   }
 
   /* Removes the shadowed flight plan entry too */
@@ -561,6 +582,7 @@ public:
   {
     QList::removeAt(i);
     flightplan.getEntries().removeAt(i);
+    legRemoved(i);
   }
 
   /* Removes all entries in route and flightplan except the ones in the range (including) */
@@ -570,6 +592,8 @@ public:
   void clear()
   {
     QList::clear();
+    changedAll = true;
+    newRevision();
   }
 
   /* Removes all legs, procedure information and flight plan legs */
@@ -730,8 +754,10 @@ private:
   /* Removes related properies in the flight plan only */
   void clearFlightplanProcedureProperties(proc::MapProcedureTypes type);
 
-  /* Calculate all distances and courses for route map objects */
-  void updateDistancesAndCourse();
+  /* Calculate distances and courses for route map objects in the range from and to (including).
+   * Total distance is summed up for all legs. Alternates and the destination airport after an approach
+   * are always updated since they do not depend on their direct predecessor. */
+  void updateDistancesAndCourse(int from, int to);
   void updateBoundingRect();
 
   /* Looks fuzzy for a waypoint at the given position from front to end or vice versa if reverse is true */
@@ -742,12 +768,29 @@ private:
 
   void removeLegs(int from, int to);
 
-  /* Update and calculate magnetic variation for all route map objects */
-  void updateMagvar();
+  /* Update and calculate magnetic variation for route map objects in the range from and to (including) */
+  void updateMagvar(int from, int to);
+
+  /* Keep track of the range of changed legs for updateAll(). Indexes are adjusted for inserted and removed legs. */
+  void legInserted(int index);
+  void legRemoved(int index);
+  void legsChanged(int from, int to);
+
+  /* Assign a new unique revision */
+  void newRevision();
 
   /* Get indexes to nearest approach or route leg and cross track distance to the nearest ofthem in nm */
   void copy(const Route& other);
   void nearestAllLegIndex(const map::PosCourse& pos, float& crossTrackDistanceMeter, int& index) const;
+
+  /* Get index of the leg segment nearest to pos which is accepted by the optional filter and is not farther
+   * away than maxDistanceMeter. Uses the segment index if valid. Does not consider the first leg. */
+  int nearestLegSegment(const atools::geo::Pos& pos, atools::geo::LineDistance& minResult, float maxDistanceMeter,
+                        const std::function<bool(int index)>& accept = nullptr) const;
+
+  /* Sum of leg distances from index from up to and including index to for the given type.
+   * Uses the cumulative values of the segment index if valid. */
+  double legDistanceSum(int from, int to, RouteSegmentIndex::DistanceSum type = RouteSegmentIndex::SUM_ALL) const;
   bool isSmaller(const atools::geo::LineDistance& dist1, const atools::geo::LineDistance& dist2, float epsilon);
   int adjustedActiveLeg() const;
 
@@ -794,6 +837,16 @@ private:
   map::MapRunwayEnd destRunwayEnd;
 
   RouteAltitude *altitude = nullptr;
+
+  /* Spatial index and cumulative distances for legs. Rebuilt by updateAll(). */
+  RouteSegmentIndex segmentIndex;
+
+  /* Range of legs changed since last updateAll(). changedFrom is -1 if nothing was recorded.
+   * changedAll forces a full update. */
+  int changedFrom = -1, changedTo = -1;
+  bool changedAll = true;
+
+  quint32 revision = 0;
 };
 
 QDebug operator<<(QDebug out, const Route& route);
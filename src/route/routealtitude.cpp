@@ -31,6 +31,9 @@
 using atools::interpolate;
 namespace ageo = atools::geo;
 
+/* Number of cached vertical profiles - calculateAll() does up to four iterations */
+const static int MAX_PROFILE_STAGES = 4;
+
 RouteAltitude::RouteAltitude(const Route *routeParam)
   : route(routeParam)
 {
@@ -51,15 +54,26 @@ int RouteAltitude::indexForDistance(float distanceToDest) const
 
   float distFromStart = route->getTotalDistance() - distanceToDest;
 
-  for(int index = 0; index < size(); index++)
+  if(!legDistancesFromStart.isEmpty())
+  {
+    // Binary search for first leg ending after the given distance
+    auto it = std::upper_bound(legDistancesFromStart.constBegin(), legDistancesFromStart.constEnd(), distFromStart);
+    if(it != legDistancesFromStart.constEnd())
+      return static_cast<int>(it - legDistancesFromStart.constBegin());
+  }
+  else
   {
-    const RouteAltitudeLeg& leg = at(index);
+    // Trip not calculated yet - search through legs
+    for(int index = 0; index < size(); index++)
+    {
+      const RouteAltitudeLeg& leg = at(index);
 
-    if(leg.isMissed() || leg.isAlternate())
-      break;
+      if(leg.isMissed() || leg.isAlternate())
+        break;
 
-    if(distFromStart < leg.getDistanceFromStart())
-      return index;
+      if(distFromStart < leg.getDistanceFromStart())
+        return index;
+    }
   }
 
   return map::INVALID_INDEX_VALUE;
@@ -194,6 +208,7 @@ atools::geo::Pos RouteAltitude::getTopOfClimbPos() const
 void RouteAltitude::clearAll()
 {
   clear();
+  legDistancesFromStart.clear();
   distanceTopOfClimb = map::INVALID_DISTANCE_VALUE;
   distanceTopOfDescent = map::INVALID_DISTANCE_VALUE;
   legIndexTopOfClimb = map::INVALID_INDEX_VALUE;
@@ -1010,7 +1025,7 @@ void RouteAltitude::calculateAll(const atools::fs::perf::AircraftPerf& perf, flo
   {
     // Flight plan is valid so far s===============================================
     QStringList altRestrErrors;
-    calculate(altRestrErrors);
+    calculateProfile(altRestrErrors);
     collectErrors(altRestrErrors);
 
     if(validProfile)
@@ -1042,8 +1057,7 @@ void RouteAltitude::calculateAll(const atools::fs::perf::AircraftPerf& perf, flo
                  << "descentRateWindFtPerNm" << descentRateWindFtPerNm;
 #endif
 
-        clearAll();
-        calculate(altRestrErrors);
+        calculateProfile(altRestrErrors);
         collectErrors(altRestrErrors);
 
         if(validProfile)
@@ -1072,6 +1086,62 @@ void RouteAltitude::calculateAll(const atools::fs::perf::AircraftPerf& perf, flo
   qDebug() << Q_FUNC_INFO;
 }
 
+void RouteAltitude::calculateProfile(QStringList& altRestErrors)
+{
+  clearAll();
+
+  quint32 revision = route->getRevision();
+  for(const ProfileStage& stage : profileStages)
+  {
+    if(stage.routeRevision == revision && stage.cruiseAltitude == cruiseAltitude &&
+       stage.climbRateWindFtPerNm == climbRateWindFtPerNm &&
+       stage.descentRateWindFtPerNm == descentRateWindFtPerNm &&
+       stage.simplify == simplify && stage.calcTopOfDescent == calcTopOfDescent &&
+       stage.calcTopOfClimb == calcTopOfClimb)
+    {
+      // Nothing changed - restore profile without trip values
+      static_cast<QVector<RouteAltitudeLeg>&>(*this) = stage.legs;
+      altRestErrors = stage.altRestErrors;
+      distanceTopOfClimb = stage.distanceTopOfClimb;
+      distanceTopOfDescent = stage.distanceTopOfDescent;
+      legIndexTopOfClimb = stage.legIndexTopOfClimb;
+      legIndexTopOfDescent = stage.legIndexTopOfDescent;
+      validProfile = stage.validProfile;
+      return;
+    }
+  }
+
+  calculate(altRestErrors);
+
+  // Remember result and inputs ==========================
+  // Drop results for other route revisions and keep a few iterations only
+  for(int i = profileStages.size() - 1; i >= 0; i--)
+  {
+    if(profileStages.at(i).routeRevision != revision)
+      profileStages.remove(i);
+  }
+  if(profileStages.size() >= MAX_PROFILE_STAGES)
+    profileStages.removeFirst();
+
+  ProfileStage profileStage;
+  profileStage.routeRevision = revision;
+  profileStage.cruiseAltitude = cruiseAltitude;
+  profileStage.climbRateWindFtPerNm = climbRateWindFtPerNm;
+  profileStage.descentRateWindFtPerNm = descentRateWindFtPerNm;
+  profileStage.simplify = simplify;
+  profileStage.calcTopOfDescent = calcTopOfDescent;
+  profileStage.calcTopOfClimb = calcTopOfClimb;
+
+  profileStage.legs = *this;
+  profileStage.altRestErrors = altRestErrors;
+  profileStage.distanceTopOfClimb = distanceTopOfClimb;
+  profileStage.distanceTopOfDescent = distanceTopOfDescent;
+  profileStage.legIndexTopOfClimb = legIndexTopOfClimb;
+  profileStage.legIndexTopOfDescent = legIndexTopOfDescent;
+  profileStage.validProfile = validProfile;
+  profileStages.append(profileStage);
+}
+
 void RouteAltitude::calculate(QStringList& altRestErrors)
 {
   altRestErrors.clear();
@@ -1687,6 +1757,8 @@ float RouteAltitude::distanceForAltitude(const RouteAltitudeLeg& leg, float alti
 
 void RouteAltitude::calculateTrip(const atools::fs::perf::AircraftPerf& perf)
 {
+  legDistancesFromStart.clear();
+
   if(isEmpty())
     return;
 
@@ -2013,6 +2085,17 @@ void RouteAltitude::calculateTrip(const atools::fs::perf::AircraftPerf& perf)
 
   averageGroundSpeed = getTotalDistance() / travelTime;
 
+  // Collect leg end distances up to destination for indexForDistance() ==================================
+  // Fuel and time to destination are already accumulated per leg above
+  legDistancesFromStart.reserve(size());
+  for(const RouteAltitudeLeg& leg : *this)
+  {
+    if(leg.isMissed() || leg.isAlternate())
+      break;
+
+    legDistancesFromStart.append(leg.getDistanceFromStart());
+  }
+
 #ifdef DEBUG_INFORMATION_ROUTE_ALT
   qDebug() << "================================================================================================";
   qDebug() << Q_FUNC_INFO << *this;
@@ -410,6 +410,9 @@ private:
   /* Calculate altitudes for all legs. Error list will be filled with altitude restriction violations. */
   void calculate(QStringList& altRestErrors);
 
+  /* Clears all and calls calculate() or restores the last result if route and profile inputs did not change */
+  void calculateProfile(QStringList& altRestErrors);
+
   /* Calculate traveling time and fuel consumption based on given performance object and wind */
   void calculateTrip(const atools::fs::perf::AircraftPerf& perf);
 
@@ -456,6 +459,7 @@ private:
   /* Fill line object in leg with geometry */
   void fillGeometry();
 
+  /* Leg index containing the distance. Uses binary search if calculateTrip() was run */
   int indexForDistance(float distanceToDest) const;
 
   void collectErrors(const QStringList& altRestrErrors);
@@ -501,6 +505,30 @@ private:
   /* Contains a list of messages if the calculation result violates altitude restrictions
    * which can happen if the cruise altitude is too low */
   QStringList errors;
+
+  /* Result of calculate() together with its inputs. Allows to rerun only calculateTrip() if performance
+   * fuel values or winds change or if climb and descent rates do not change between iterations. */
+  struct ProfileStage
+  {
+    /* Inputs */
+    quint32 routeRevision = 0;
+    float cruiseAltitude = 0.f, climbRateWindFtPerNm = 0.f, descentRateWindFtPerNm = 0.f;
+    bool simplify = false, calcTopOfDescent = false, calcTopOfClimb = false;
+
+    /* Results */
+    QVector<RouteAltitudeLeg> legs;
+    QStringList altRestErrors;
+    float distanceTopOfClimb = map::INVALID_DISTANCE_VALUE, distanceTopOfDescent = map::INVALID_DISTANCE_VALUE;
+    int legIndexTopOfClimb = map::INVALID_INDEX_VALUE, legIndexTopOfDescent = map::INVALID_INDEX_VALUE;
+    bool validProfile = false;
+  };
+
+  /* Last results - one for each iteration in calculateAll() with different climb and descent rates */
+  QVector<ProfileStage> profileStages;
+
+  /* Distance from departure to the end of each leg up to the first missed or alternate leg.
+   * Built at the end of calculateTrip() for the binary search in indexForDistance(). */
+  QVector<float> legDistancesFromStart;
 };
 
 QDebug operator<<(QDebug out, const RouteAltitude& obj);
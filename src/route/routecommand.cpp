@@ -18,12 +18,75 @@
 #include "route/routecommand.h"
 #include "route/routecontroller.h"
 
+#include <QDebug>
+
+using atools::fs::pln::Flightplan;
+using atools::fs::pln::FlightplanEntry;
+
+/* Compare all values which can be changed by the user or by route editing */
+static bool entryEqual(const FlightplanEntry& entry1, const FlightplanEntry& entry2)
+{
+  return entry1.getIdent() == entry2.getIdent() &&
+         entry1.getRegion() == entry2.getRegion() &&
+         entry1.getWaypointType() == entry2.getWaypointType() &&
+         entry1.getPosition() == entry2.getPosition() &&
+         entry1.getPosition().getAltitude() == entry2.getPosition().getAltitude() &&
+         entry1.getAirway() == entry2.getAirway() &&
+         entry1.getFlags() == entry2.getFlags() &&
+         entry1.getName() == entry2.getName() &&
+         entry1.getComment() == entry2.getComment();
+}
+
+namespace rctype {
+
+bool EntryDiff::matches(const QList<FlightplanEntry>& entries) const
+{
+  if(offset < 0 || offset + removed.size() > entries.size())
+    return false;
+
+  for(int i = 0; i < removed.size(); i++)
+  {
+    if(!entryEqual(entries.at(offset + i), removed.at(i)))
+      return false;
+  }
+  return true;
+}
+
+bool EntryDiff::apply(QList<FlightplanEntry>& entries) const
+{
+  if(!matches(entries))
+  {
+    qWarning() << Q_FUNC_INFO << "Diff does not match entries" << offset << removed.size() << entries.size();
+    return false;
+  }
+
+  for(int i = 0; i < removed.size(); i++)
+    entries.removeAt(offset);
+
+  for(int i = 0; i < inserted.size(); i++)
+    entries.insert(offset + i, inserted.at(i));
+  return true;
+}
+
+EntryDiff EntryDiff::reversed() const
+{
+  EntryDiff diff;
+  diff.offset = offset;
+  diff.removed = inserted;
+  diff.inserted = removed;
+  return diff;
+}
+
+}
+
 RouteCommand::RouteCommand(RouteController *routeController,
                            const atools::fs::pln::Flightplan& flightplanBefore, const QString& text,
                            rctype::RouteCmdType rcType)
   : QUndoCommand(text), controller(routeController), type(rcType)
 {
   planBeforeChange = flightplanBefore;
+  headerBeforeChange = flightplanBefore;
+  headerBeforeChange.getEntries().clear();
 }
 
 RouteCommand::~RouteCommand()
@@ -33,12 +96,54 @@ RouteCommand::~RouteCommand()
 
 void RouteCommand::setFlightplanAfter(const atools::fs::pln::Flightplan& flightplanAfter)
 {
-  planAfterChange = flightplanAfter;
+  headerAfterChange = flightplanAfter;
+  headerAfterChange.getEntries().clear();
+
+  const QList<FlightplanEntry>& before = planBeforeChange.getEntries();
+  const QList<FlightplanEntry>& after = flightplanAfter.getEntries();
+
+  // Skip unchanged entries at start
+  int first = 0;
+  while(first < before.size() && first < after.size() && entryEqual(before.at(first), after.at(first)))
+    first++;
+
+  // Skip unchanged entries at end - index is behind last changed entry
+  int endBefore = before.size(), endAfter = after.size();
+  while(endBefore > first && endAfter > first && entryEqual(before.at(endBefore - 1), after.at(endAfter - 1)))
+  {
+    endBefore--;
+    endAfter--;
+  }
+
+  if(endBefore > first || endAfter > first)
+  {
+    rctype::EntryDiff diff;
+    diff.offset = first;
+    diff.removed = before.mid(first, endBefore - first);
+    diff.inserted = after.mid(first, endAfter - first);
+    diffs.append(diff);
+  }
+
+  // Not needed anymore
+  planBeforeChange = Flightplan();
+}
+
+int RouteCommand::getNumDiffEntries() const
+{
+  int num = 0;
+  for(const rctype::EntryDiff& diff : diffs)
+    num += diff.removed.size() + diff.inserted.size();
+  return num;
 }
 
 void RouteCommand::undo()
 {
-  controller->changeRouteUndo(planBeforeChange);
+  // Revert all changes in reverse order
+  QVector<rctype::EntryDiff> undoDiffs;
+  for(int i = diffs.size() - 1; i >= 0; i--)
+    undoDiffs.append(diffs.at(i).reversed());
+
+  controller->changeRouteUndo(headerBeforeChange, undoDiffs);
 }
 
 void RouteCommand::redo()
@@ -47,7 +152,7 @@ void RouteCommand::redo()
     // Skip first redo - I need to do the initial changes myself
     firstRedoExecuted = true;
   else
-    controller->changeRouteRedo(planAfterChange);
+    controller->changeRouteRedo(headerAfterChange, diffs);
 }
 
 int RouteCommand::id() const
@@ -74,8 +179,9 @@ bool RouteCommand::mergeWith(const QUndoCommand *other)
     case rctype::MOVE:
     case rctype::ALTITUDE:
     case rctype::REMARKS:
-      // Merge - overwrite the flight plan after the change
-      planAfterChange = newCmd->planAfterChange;
+      // Merge - add changes and overwrite the flight plan values after the change
+      diffs.append(newCmd->diffs);
+      headerAfterChange = newCmd->headerAfterChange;
       // Let controller know about the merge so the undo index can be adapted
       controller->undoMerge();
       return true;
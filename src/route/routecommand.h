@@ -21,6 +21,7 @@
 #include "fs/pln/flightplan.h"
 
 #include <QUndoCommand>
+#include <QVector>
 
 class RouteController;
 
@@ -36,11 +37,28 @@ enum RouteCmdType
   REMARKS = 5 /* Route remarks edited */
 };
 
+/* Change of flight plan entries. The entries in removed starting at offset were replaced by the ones in inserted. */
+struct EntryDiff
+{
+  int offset = 0;
+  QList<atools::fs::pln::FlightplanEntry> removed, inserted;
+
+  /* true if the entries at offset are equal to removed */
+  bool matches(const QList<atools::fs::pln::FlightplanEntry>& entries) const;
+
+  /* Replace removed by inserted in the given list of entries.
+   * Returns false and leaves entries unchanged if they do not match removed. */
+  bool apply(QList<atools::fs::pln::FlightplanEntry>& entries) const;
+
+  /* Get a diff which reverts this change */
+  EntryDiff reversed() const;
+};
+
 }
 
 /*
  * Flight plan undo command including a few workaround for QUndoCommand inflexibilities.
- * Keeps a copy of the flight plan before and after the change.
+ * Keeps the flight plan values and properties before and after the change but only the changed range of entries.
  */
 class RouteCommand :
   public QUndoCommand
@@ -53,9 +71,13 @@ public:
   virtual void undo() override;
   virtual void redo() override;
 
-  /* Need to keep both versions in a redundant way since linking between commands is not reliable */
+  /* Calculates the difference to the flight plan given in the constructor.
+   * Both versions of flight plan values and properties are kept since linking between commands is not reliable */
   void setFlightplanAfter(const atools::fs::pln::Flightplan& flightplanAfter);
 
+  /* Number of stored changed entries */
+  int getNumDiffEntries() const;
+
 private:
   virtual int id() const override;
   virtual bool mergeWith(const QUndoCommand *other) override;
@@ -64,7 +86,15 @@ private:
   bool firstRedoExecuted = false;
   RouteController *controller;
   rctype::RouteCmdType type;
-  atools::fs::pln::Flightplan planBeforeChange, planAfterChange;
+
+  /* Full flight plan before change. Only kept until setFlightplanAfter() is called. */
+  atools::fs::pln::Flightplan planBeforeChange;
+
+  /* Flight plans without entries keeping values like cruise altitude and properties */
+  atools::fs::pln::Flightplan headerBeforeChange, headerAfterChange;
+
+  /* Changed entries in order of change. Contains more than one diff if commands were merged. */
+  QVector<rctype::EntryDiff> diffs;
 };
 
 #endif // LITTLENAVMAP_ROUTECOMMAND_H
@@ -57,6 +57,7 @@
 #include "route/routealtitude.h"
 #include "route/routecalcdialog.h"
 #include "route/routelabel.h"
+#include "route/routetablemodel.h"
 #include "route/runwayselectiondialog.h"
 #include "route/userwaypointdialog.h"
 #include "routeextractor.h"
@@ -74,7 +75,6 @@
 
 #include <QClipboard>
 #include <QFile>
-#include <QStandardItemModel>
 #include <QInputDialog>
 #include <QFileInfo>
 #include <QTextTable>
@@ -82,55 +82,6 @@
 #include <QProgressDialog>
 #include <QScrollBar>
 
-namespace rcol {
-// Route table column indexes
-enum RouteColumns
-{
-  /* Column indexes. Saved through view in RouteLabel::saveState()
-   * Update RouteController::routeColumns and RouteController::routeColumnDescription when adding new values */
-  FIRST_COLUMN,
-  IDENT = FIRST_COLUMN,
-  REGION,
-  NAME,
-  PROCEDURE,
-  AIRWAY_OR_LEGTYPE,
-  RESTRICTION,
-  TYPE,
-  FREQ,
-  RANGE,
-  COURSE,
-  COURSETRUE,
-  DIST,
-  REMAINING_DISTANCE,
-  LEG_TIME,
-  ETA,
-  FUEL_WEIGHT,
-  FUEL_VOLUME,
-  WIND,
-  WIND_HEAD_TAIL,
-  ALTITUDE,
-  SAFE_ALTITUDE,
-  LATITUDE,
-  LONGITUDE,
-  RECOMMENDED,
-  REMARKS,
-  LAST_COLUMN = REMARKS,
-
-  /* Not column names but identifiers for the tree dialog
-   * Not saved directly but state is saved in RouteLabel::saveState() */
-  HEADER_AIRPORTS = 1000,
-  HEADER_TAKEOFF,
-  HEADER_DEPARTURE,
-  HEADER_ARRIVAL,
-  HEADER_LAND,
-  HEADER_DIST_TIME,
-
-  FOOTER_SELECTION = 1500,
-  FOOTER_ERROR,
-};
-
-}
-
 /* Maximum lines in flight plan and waypoint remarks for printing and HTML export */
 const static int MAX_REMARK_LINES_HTML_AND_PRINT = 1000;
 const static int MAX_REMARK_COLS_HTML_AND_PRINT = 200;
@@ -334,7 +285,8 @@ RouteController::RouteController(QMainWindow *parentWindow, QTableView *tableVie
   view->verticalHeader()->setSectionsMovable(false);
   view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 
-  model = new QStandardItemModel();
+  model = new RouteTableModel(this, &route);
+  model->setHeaderToolTips(routeColumnDescription);
   QItemSelectionModel *m = view->selectionModel();
   view->setModel(model);
   delete m;
@@ -457,7 +409,7 @@ void RouteController::tableCopyClipboard()
   qDebug() << "RouteController::tableCopyClipboard";
 
   const Route& rt = route;
-  const QStandardItemModel *mdl = model;
+  const RouteTableModel *mdl = model;
 
   // Use callback to get data to avoid truncated remarks
   auto dataFunc = [&rt, &mdl](int row, int column) -> QVariant {
@@ -558,9 +510,9 @@ void RouteController::flightplanTableAsTextTable(QTextCursor& cursor, const QBit
         // Ignore if not selected in the print dialog
         continue;
 
-      const QStandardItem *item = model->item(row, logicalCol);
+      QModelIndex idx = model->index(row, logicalCol);
 
-      if(item != nullptr)
+      if(idx.isValid())
       {
         // Alternating background =============================
         QTextCharFormat textFormat = (row % 2) == 0 ? altFormat1 : altFormat2;
@@ -592,7 +544,7 @@ void RouteController::flightplanTableAsTextTable(QTextCursor& cursor, const QBit
         cursor.setPosition(table->cellAt(row + 1, cellIdx).firstPosition());
 
         // Assign alignment to cell
-        if(item->textAlignment() == Qt::AlignRight)
+        if(model->data(idx, Qt::TextAlignmentRole).toInt() == Qt::AlignRight)
           cursor.setBlockFormat(alignRight);
         else
           cursor.setBlockFormat(alignLeft);
@@ -601,7 +553,7 @@ void RouteController::flightplanTableAsTextTable(QTextCursor& cursor, const QBit
           cursor.insertText(atools::elideTextLinesShort(leg.getComment(), MAX_REMARK_LINES_HTML_AND_PRINT,
                                                         MAX_REMARK_COLS_HTML_AND_PRINT, true, true));
         else
-          cursor.insertText(item->text());
+          cursor.insertText(model->data(idx).toString());
       }
       cellIdx++;
     }
@@ -726,9 +678,9 @@ QString RouteController::getFlightplanTableAsHtml(float iconSizePixel, bool prin
 
       if(!view->isColumnHidden(logicalCol) && view->columnWidth(logicalCol) > minColWidth)
       {
-        QStandardItem *item = model->item(row, logicalCol);
+        QModelIndex idx = model->index(row, logicalCol);
 
-        if(item != nullptr)
+        if(idx.isValid())
         {
           QColor color(Qt::black);
           if(leg.isAlternate())
@@ -752,14 +704,14 @@ QString RouteController::getFlightplanTableAsHtml(float iconSizePixel, bool prin
             flags |= atools::util::html::SMALL;
 
           // Take over alignment from model
-          if(item->textAlignment().testFlag(Qt::AlignRight))
+          if(model->data(idx, Qt::TextAlignmentRole).toInt() & Qt::AlignRight)
             flags |= atools::util::html::ALIGN_RIGHT;
 
           if(logicalCol == rcol::REMARKS)
             html.td(atools::elideTextLinesShort(leg.getComment(), MAX_REMARK_LINES_HTML_AND_PRINT,
                                                 MAX_REMARK_COLS_HTML_AND_PRINT, true, true), flags, color);
           else
-            html.td(item->text(), flags, color);
+            html.td(model->data(idx).toString(), flags, color);
         }
         else
           html.td(QString());
@@ -939,7 +891,7 @@ void RouteController::updateTableHeaders()
   for(QString& str : routeHeaders)
     str = Unit::replacePlaceholders(str);
 
-  model->setHorizontalHeaderLabels(routeHeaders);
+  model->setHeaderLabels(routeHeaders);
 }
 
 void RouteController::saveState()
@@ -3117,22 +3069,36 @@ void RouteController::tableSelectionChanged(const QItemSelection& selected, cons
 }
 
 /* Called by undo command */
-void RouteController::changeRouteUndo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteUndo(const atools::fs::pln::Flightplan& header,
+                                      const QVector<rctype::EntryDiff>& diffs)
 {
   // Keep our own index as a workaround
   undoIndex--;
 
   qDebug() << "changeRouteUndo undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
-  changeRouteUndoRedo(newFlightplan);
+  changeRouteUndoRedo(header, diffs);
 }
 
 /* Called by undo command */
-void RouteController::changeRouteRedo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteRedo(const atools::fs::pln::Flightplan& header,
+                                      const QVector<rctype::EntryDiff>& diffs)
 {
   // Keep our own index as a workaround
   undoIndex++;
   qDebug() << "changeRouteRedo undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
-  changeRouteUndoRedo(newFlightplan);
+  changeRouteUndoRedo(header, diffs);
+}
+
+void RouteController::undoStackMismatch()
+{
+  undoStack->clear();
+  undoIndex = 0;
+  // State of the file is unknown
+  undoIndexClean = -1;
+
+  atools::gui::Dialog::warning(mainWindow, tr("Undo or redo is not possible since the flight plan does not match "
+                                              "the recorded changes.<br/><br/>"
+                                              "The flight plan was left unchanged and the undo history was cleared."));
 }
 
 /* Called by undo command when commands are merged */
@@ -3145,16 +3111,39 @@ void RouteController::undoMerge()
 }
 
 /* Update window after undo or redo action */
-void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& newFlightplan)
+void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& header,
+                                          const QVector<rctype::EntryDiff>& diffs)
 {
-  route.clearAll();
-  route.setFlightplan(newFlightplan);
+  if(!changeRouteUndoRedoLegs(header, diffs))
+  {
+    // Apply changes to a copy of the current plan without procedures and rebuild the route
+    Flightplan newFlightplan = route.getFlightplan();
+    newFlightplan.removeNoSaveEntries();
+    QList<FlightplanEntry> entries = newFlightplan.getEntries();
+    for(const rctype::EntryDiff& diff : diffs)
+    {
+      if(!diff.apply(entries))
+      {
+        // Plan was changed outside of the undo stack - partially applied diffs would result in a plan which
+        // never existed. Keep the current plan and drop the undo stack after the command has finished.
+        QTimer::singleShot(0, this, &RouteController::undoStackMismatch);
+        return;
+      }
+    }
+
+    newFlightplan = header;
+    newFlightplan.getEntries() = entries;
+
+    route.clearAll();
+    route.setFlightplan(newFlightplan);
+
+    // Change format in plan according to last saved format
+    route.createRouteLegsFromFlightplan();
+    loadProceduresFromFlightplan(false /* clear old procedure properties */);
+    loadAlternateFromFlightplan();
+    route.updateAll();
+  }
 
-  // Change format in plan according to last saved format
-  route.createRouteLegsFromFlightplan();
-  loadProceduresFromFlightplan(false /* clear old procedure properties */);
-  loadAlternateFromFlightplan();
-  route.updateAll();
   route.updateAirwaysAndAltitude(false /* adjustRouteAltitude */);
   route.updateLegAltitudes();
   remarksFlightPlanToWidget();
@@ -3164,6 +3153,76 @@ void RouteController::changeRouteUndoRedo(const atools::fs::pln::Flightplan& new
   emit routeChanged(true);
 }
 
+bool RouteController::changeRouteUndoRedoLegs(const atools::fs::pln::Flightplan& header,
+                                              const QVector<rctype::EntryDiff>& diffs)
+{
+  // Procedures and alternates are loaded from properties - rebuild if these differ
+  if(route.isEmpty() || header.getProperties() != route.getFlightplan().getProperties())
+    return false;
+
+  // Number of entries without procedures
+  int numEntries = 0;
+  for(int i = 0; i < route.size(); i++)
+  {
+    if(!route.value(i).isAnyProcedure())
+      numEntries++;
+  }
+
+  // Check if the changed entries match the current plan =====================
+  // Plan might have been modified without undo command, e.g. by adding procedures
+  Flightplan checkFlightplan = route.getFlightplan();
+  checkFlightplan.removeNoSaveEntries();
+  QList<FlightplanEntry> checkEntries = checkFlightplan.getEntries();
+  for(const rctype::EntryDiff& diff : diffs)
+  {
+    if(!diff.matches(checkEntries))
+      return false;
+    diff.apply(checkEntries);
+  }
+
+  // Check if all changes are between departure and destination =====================
+  int numAlternates = route.getNumAlternateLegs();
+  for(const rctype::EntryDiff& diff : diffs)
+  {
+    int destIndex = numEntries - numAlternates - 1;
+    if(diff.offset < 1 || diff.offset + diff.removed.size() > destIndex)
+      return false;
+
+    numEntries += diff.inserted.size() - diff.removed.size();
+    if(diff.offset + diff.inserted.size() > numEntries - numAlternates - 1)
+      return false;
+  }
+
+  // Apply changes to route legs and entries =====================
+  // Legs of a departure procedure are placed between departure airport and first route leg
+  int sidOffset = route.getLastIndexOfDepartureProcedure();
+  Flightplan& flightplan = route.getFlightplan();
+  for(const rctype::EntryDiff& diff : diffs)
+  {
+    int index = diff.offset + sidOffset;
+    for(int i = 0; i < diff.removed.size(); i++)
+      route.removeAllAt(index);
+
+    for(int i = 0; i < diff.inserted.size(); i++)
+    {
+      flightplan.getEntries().insert(index + i, diff.inserted.at(i));
+
+      RouteLeg leg(&flightplan);
+      leg.createFromDatabaseByEntry(index + i, &route.value(index + i - 1));
+      route.insert(index + i, leg);
+    }
+  }
+
+  // Copy values like cruise altitude and properties but keep entries
+  QList<FlightplanEntry> entries = flightplan.getEntries();
+  flightplan = header;
+  flightplan.getEntries() = entries;
+
+  // Updates only changed legs
+  route.updateAll();
+  return true;
+}
+
 void RouteController::styleChanged()
 {
   tabHandlerRoute->styleChanged();
@@ -3279,9 +3338,6 @@ void RouteController::moveSelectedLegsInternal(MoveDirection direction)
       // Change flight plan
       route.getFlightplan().getEntries().move(row, row + direction);
       route.move(row, row + direction);
-
-      // Move row
-      model->insertRow(row + direction, model->takeRow(row));
     }
 
     int firstRow = rows.constFirst();
@@ -3372,7 +3428,6 @@ void RouteController::deleteSelectedLegsInternal(const QList<int>& rows)
       route.eraseAirway(row);
 
       route.removeAt(row);
-      model->removeRow(row);
     }
 
     if(procs & proc::PROCEDURE_ALL)
@@ -4269,23 +4324,7 @@ void RouteController::updateFlightplanFromWidgets(Flightplan& flightplan)
 
 QIcon RouteController::iconForLeg(const RouteLeg& leg, int size) const
 {
-  QIcon icon;
-  if(leg.getMapObjectType() == map::AIRPORT)
-    icon = SymbolPainter::createAirportIcon(leg.getAirport(), size - 2);
-  else if(leg.getVor().isValid())
-    icon = SymbolPainter::createVorIcon(leg.getVor(), size);
-  else if(leg.getNdb().isValid())
-    icon = SymbolPainter::createNdbIcon(size);
-  else if(leg.getWaypoint().isValid())
-    icon = SymbolPainter::createWaypointIcon(size);
-  else if(leg.getMapObjectType() == map::USERPOINTROUTE)
-    icon = SymbolPainter::createUserpointIcon(size);
-  else if(leg.getMapObjectType() == map::INVALID)
-    icon = SymbolPainter::createWaypointIcon(size, mapcolors::routeInvalidPointColor);
-  else if(leg.isAnyProcedure())
-    icon = SymbolPainter::createProcedurePointIcon(size);
-
-  return icon;
+  return RouteTableModel::iconForLeg(leg, size);
 }
 
 void RouteController::updatePlaceholderWidget()
@@ -4297,221 +4336,13 @@ void RouteController::updatePlaceholderWidget()
   ui->textBrowserViewRoute->setVisible(showPlaceholder);
 }
 
-/* Update table view model completely */
+/* Reset table view model completely. Cells are formatted on demand by the model. */
 void RouteController::updateTableModel()
 {
   Ui::MainWindow *ui = NavApp::getMainUi();
 
-  model->removeRows(0, model->rowCount());
-  float totalDistance = route.getTotalDistance();
-
-  int row = 0;
-  float cumulatedDistance = 0.f;
-
-  // Create null pointer filled list for all items ==============
-  QList<QStandardItem *> itemRow;
-  for(int i = rcol::FIRST_COLUMN; i <= rcol::LAST_COLUMN; i++)
-    itemRow.append(nullptr);
-
-  for(int i = 0; i < route.size(); i++)
-  {
-    const RouteLeg& leg = route.value(i);
-    const proc::MapProcedureLeg& procedureLeg = leg.getProcedureLeg();
-
-    // Ident ===========================================
-    QString identStr;
-    if(leg.isAnyProcedure())
-      // Get ident with IAF, FAF or other indication
-      identStr = proc::procedureLegFixStr(procedureLeg);
-    else
-      identStr = leg.getDisplayIdent();
-
-    QStandardItem *ident = new QStandardItem(iconForLeg(leg, view->verticalHeader()->defaultSectionSize() - 2), identStr);
-    QFont f = ident->font();
-    f.setBold(true);
-    ident->setFont(f);
-    ident->setTextAlignment(Qt::AlignRight);
-
-    itemRow[rcol::IDENT] = ident;
-    // highlightProcedureItems() does error checking for IDENT
-
-    // Region, navaid name, procedure type ===========================================
-    itemRow[rcol::REGION] = new QStandardItem(leg.getRegion());
-    itemRow[rcol::NAME] = new QStandardItem(leg.getName());
-
-    if(row == route.getDepartureAirportLegIndex() && !route.getDepartureAirportLeg().isAnyProcedure())
-      itemRow[rcol::PROCEDURE] = new QStandardItem(tr("Departure"));
-    else if(row == route.getDestinationAirportLegIndex() && !route.getDestinationAirportLeg().isAnyProcedure())
-      itemRow[rcol::PROCEDURE] = new QStandardItem(tr("Destination"));
-    else if(leg.isAlternate())
-      itemRow[rcol::PROCEDURE] = new QStandardItem(tr("Alternate"));
-    else if(leg.isAnyProcedure())
-      itemRow[rcol::PROCEDURE] = new QStandardItem(route.getProcedureLegText(leg.getProcedureType(),
-                                                                             false /* includeRunway */, false /* missedAsApproach */,
-                                                                             true /* transitionAsProcedure */));
-
-    // Airway or leg type and restriction ===========================================
-    if(leg.isRoute())
-    {
-      // Airway ========================
-      const map::MapAirway& airway = leg.getAirway();
-
-      QStringList awname;
-
-      awname.append(airway.isValid() && airway.isTrack() ? tr("Track %1").arg(leg.getAirwayName()) : leg.getAirwayName());
-
-      if(airway.isValid())
-      {
-        awname.append(map::airwayTrackTypeToShortString(airway.type));
-
-#ifdef DEBUG_INFORMATION
-        awname.append("[" + map::airwayRouteTypeToStringShort(airway.routeType) + "]");
-#endif
-
-        awname.removeAll(QString());
-        itemRow[rcol::RESTRICTION] = new QStandardItem(map::airwayAltTextShort(airway, false /* addUnit */, false /* narrow */));
-      }
-
-      itemRow[rcol::AIRWAY_OR_LEGTYPE] = new QStandardItem(awname.join(tr(" / ")));
-      // highlightProcedureItems() does error checking
-    }
-    else
-    {
-      // Procedure ========================
-      itemRow[rcol::AIRWAY_OR_LEGTYPE] =
-        new QStandardItem(atools::strJoin({leg.getFlightplanEntry().getAirway(), proc::procedureLegTypeStr(procedureLeg.type)}, tr(", ")));
-      itemRow[rcol::RESTRICTION] = new QStandardItem(proc::restrictionText(procedureLeg).join(tr(", ")));
-    }
-
-    // Get ILS for approach runway if it marks the end of an ILS or localizer approach procedure
-    QStringList ilsTypeTexts, ilsFreqTexts;
-    if(procedureLeg.isApproach() && leg.getRunwayEnd().isValid())
-    {
-      // Build string for ILS type - use recommended ILS which can also apply to non ILS approaches
-      for(const map::MapIls& ils : route.getDestRunwayIlsFlightPlanTable())
-      {
-        ilsTypeTexts.append(map::ilsType(ils, true /* gs */, true /* dme */, tr(", ")));
-
-        if(!ils.isAnyGlsRnp())
-          ilsFreqTexts.append(ils.freqMHzLocale());
-      }
-    }
-
-    // VOR/NDB type ===========================
-    if(leg.getVor().isValid())
-      itemRow[rcol::TYPE] = new QStandardItem(map::vorFullShortText(leg.getVor()));
-    else if(leg.getNdb().isValid())
-      itemRow[rcol::TYPE] = new QStandardItem(map::ndbFullShortText(leg.getNdb()));
-    else if(!ilsTypeTexts.isEmpty())
-      itemRow[rcol::TYPE] = new QStandardItem(ilsTypeTexts.join(", "));
-
-    // VOR/NDB frequency =====================
-    if(leg.getVor().isValid())
-    {
-      if(leg.getVor().tacan)
-        itemRow[rcol::FREQ] = new QStandardItem(leg.getVor().channel);
-      else
-        itemRow[rcol::FREQ] = new QStandardItem(QLocale().toString(leg.getFrequency() / 1000.f, 'f', 2));
-    }
-    else if(leg.getNdb().isValid())
-      itemRow[rcol::FREQ] = new QStandardItem(QLocale().toString(leg.getFrequency() / 100.f, 'f', 1));
-    else if(!ilsFreqTexts.isEmpty())
-      itemRow[rcol::FREQ] = new QStandardItem(ilsFreqTexts.join(", "));
-
-    // VOR/NDB range =====================
-    if(leg.getRange() > 0 && (leg.getVor().isValid() || leg.getNdb().isValid()))
-      itemRow[rcol::RANGE] = new QStandardItem(Unit::distNm(leg.getRange(), false));
-
-    // Course =====================
-    bool afterArrivalAirport = route.isAirportAfterArrival(i);
-    bool parkingToDeparture = route.hasAnySidProcedure() && i == 0;
-
-    if(row > 0 && !afterArrivalAirport && !parkingToDeparture && leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE &&
-       leg.getDistanceTo() > 0.f && !leg.noCourseDisplay())
-    {
-      if(leg.getCourseToMag() < map::INVALID_COURSE_VALUE)
-        itemRow[rcol::COURSE] = new QStandardItem(QLocale().toString(leg.getCourseToMag(), 'f', 0));
-      if(leg.getCourseToTrue() < map::INVALID_COURSE_VALUE)
-        itemRow[rcol::COURSETRUE] = new QStandardItem(QLocale().toString(leg.getCourseToTrue(), 'f', 0));
-    }
-
-    // Distance =====================
-    if(!afterArrivalAirport)
-    {
-      if(leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE /*&& !leg.noDistanceDisplay()*/)
-      {
-        cumulatedDistance += leg.getDistanceTo();
-        itemRow[rcol::DIST] = new QStandardItem(Unit::distNm(leg.getDistanceTo(), false));
-
-        if(!procedureLeg.isMissed() && !leg.isAlternate())
-        {
-          float remaining = totalDistance - cumulatedDistance;
-          if(remaining < 0.f)
-            remaining = 0.f; // Catch the -0 case due to rounding errors
-          itemRow[rcol::REMAINING_DISTANCE] = new QStandardItem(Unit::distNm(remaining, false));
-        }
-      }
-    }
-
-    itemRow[rcol::LATITUDE] = new QStandardItem(Unit::coordsLatY(leg.getPosition()));
-    itemRow[rcol::LONGITUDE] = new QStandardItem(Unit::coordsLonX(leg.getPosition()));
-
-    itemRow[rcol::RECOMMENDED] = new QStandardItem(atools::elideTextShort(proc::procedureLegRecommended(procedureLeg).join(tr(", ")), 80));
-
-    QString comment;
-    if(leg.isAnyProcedure())
-      // Show procedure remarks like turn and flyover
-      comment = proc::procedureLegRemark(procedureLeg).join(tr(" / "));
-    else
-      // Show user comment on normal leg
-      comment = leg.getFlightplanEntry().getComment();
-    if(!comment.isEmpty())
-    {
-      itemRow[rcol::REMARKS] = new QStandardItem(atools::elideTextShort(comment, 80));
-      itemRow[rcol::REMARKS]->setToolTip(atools::elideTextLinesShort(comment, 20, 80));
-    }
-
-    // Travel time, remaining fuel and ETA are updated in updateModelRouteTime
-
-    // Create empty items for missing fields ===================
-    for(int col = rcol::FIRST_COLUMN; col <= rcol::LAST_COLUMN; col++)
-    {
-      if(itemRow[col] == nullptr)
-        itemRow[col] = new QStandardItem();
-
-      // Do not allow editing and drag and drop
-      itemRow[col]->setFlags(itemRow[col]->flags() &
-                             ~(Qt::ItemIsEditable | Qt::ItemIsDragEnabled | Qt::ItemIsDropEnabled));
-    }
-
-    // Align cells to the right - rest is aligned in updateModelRouteTimeFuel ===============
-    itemRow[rcol::REGION]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::REMAINING_DISTANCE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::DIST]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::COURSE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::COURSETRUE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::RANGE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::FREQ]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::RESTRICTION]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::LEG_TIME]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::ETA]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::FUEL_WEIGHT]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::FUEL_VOLUME]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::WIND]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::WIND_HEAD_TAIL]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::ALTITUDE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::SAFE_ALTITUDE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::LATITUDE]->setTextAlignment(Qt::AlignRight);
-    itemRow[rcol::LONGITUDE]->setTextAlignment(Qt::AlignRight);
-
-    model->appendRow(itemRow);
-
-    for(int col = rcol::FIRST_COLUMN; col <= rcol::LAST_COLUMN; col++)
-      itemRow[col] = nullptr;
-    row++;
-  }
-
-  updateModelTimeFuelWindAlt();
+  // Also calculates travel time, remaining fuel and ETA
+  model->updateAll(view->verticalHeader()->defaultSectionSize() - 2);
 
   Flightplan& flightplan = route.getFlightplan();
 
@@ -4532,10 +4363,6 @@ void RouteController::updateTableModel()
     }
   }
 
-  // Update header tooltips
-  for(int col = rcol::FIRST_COLUMN; col <= rcol::LAST_COLUMN; col++)
-    model->horizontalHeaderItem(col)->setToolTip(routeColumnDescription.at(col));
-
   updateModelHighlights();
   highlightNextWaypoint(route.getActiveLegIndexCorrected());
 
@@ -4556,211 +4383,8 @@ void RouteController::updateModelTimeFuelWindAlt()
   if(model->rowCount() == 0)
     return;
 
-  using atools::fs::perf::AircraftPerf;
-  const RouteAltitude& altitudeLegs = route.getAltitudeLegs();
-  if(altitudeLegs.isEmpty())
-    return;
-
-  int row = 0;
-  float cumulatedTravelTime = 0.f;
-
-  bool setValues = !altitudeLegs.hasErrors();
-  const AircraftPerf& perf = NavApp::getAircraftPerformance();
-  float totalFuelLbsOrGal = altitudeLegs.getTripFuel() + altitudeLegs.getAlternateFuel();
-
-  if(setValues)
-  {
-    totalFuelLbsOrGal *= perf.getContingencyFuelFactor();
-    totalFuelLbsOrGal += perf.getExtraFuel() + perf.getReserveFuel();
-  }
-
-  // Remember colum widths
-  QHeaderView *header = view->horizontalHeader();
-  int widthLegTime = header->isSectionHidden(rcol::LEG_TIME) ? -1 : view->columnWidth(rcol::LEG_TIME);
-  int widthEta = header->isSectionHidden(rcol::ETA) ? -1 : view->columnWidth(rcol::ETA);
-  int widthFuelWeight = header->isSectionHidden(rcol::FUEL_WEIGHT) ? -1 : view->columnWidth(rcol::FUEL_WEIGHT);
-  int widthFuelVol = header->isSectionHidden(rcol::FUEL_VOLUME) ? -1 : view->columnWidth(rcol::FUEL_VOLUME);
-  int widthWind = header->isSectionHidden(rcol::WIND) ? -1 : view->columnWidth(rcol::WIND);
-  int widthWindHt = header->isSectionHidden(rcol::WIND_HEAD_TAIL) ? -1 : view->columnWidth(rcol::WIND_HEAD_TAIL);
-  int widthAlt = header->isSectionHidden(rcol::ALTITUDE) ? -1 : view->columnWidth(rcol::ALTITUDE);
-  int widthSafeAlt = header->isSectionHidden(rcol::SAFE_ALTITUDE) ? -1 : view->columnWidth(rcol::SAFE_ALTITUDE);
-
-  for(int i = 0; i < route.size(); i++)
-  {
-    if(i >= model->rowCount())
-    {
-      qWarning() << Q_FUNC_INFO << "Route size exceeds model size" << i << model->rowCount() - 1;
-      break;
-    }
-
-    if(!setValues)
-    {
-      // Do not fill if collecting performance or route altitude is invalid
-      model->item(row, rcol::LEG_TIME)->setText(QString());
-      model->item(row, rcol::ETA)->setText(QString());
-      model->item(row, rcol::FUEL_WEIGHT)->setText(QString());
-      model->item(row, rcol::FUEL_VOLUME)->setText(QString());
-      model->item(row, rcol::WIND)->setText(QString());
-      model->item(row, rcol::WIND_HEAD_TAIL)->setText(QString());
-      model->item(row, rcol::ALTITUDE)->setText(QString());
-      model->item(row, rcol::SAFE_ALTITUDE)->setText(QString());
-    }
-    else
-    {
-      const RouteLeg& leg = route.value(i);
-      const RouteAltitudeLeg& altLeg = altitudeLegs.value(i);
-
-      // Leg time =====================================================================
-      float travelTime = altLeg.getTime();
-      if(row == 0 || !(travelTime < map::INVALID_TIME_VALUE) || leg.getProcedureLeg().isMissed())
-        model->item(row, rcol::LEG_TIME)->setText((QString()));
-      else
-      {
-        QString txt = formatter::formatMinutesHours(travelTime);
-#ifdef DEBUG_INFORMATION_LEGTIME
-        txt += " [" + QString::number(travelTime * 3600., 'f', 0) + "]";
-#endif
-        model->item(row, rcol::LEG_TIME)->setText(txt);
-      }
-
-      if(!leg.getProcedureLeg().isMissed())
-      {
-        // Arrival time =====================================================================
-        QString txt = formatter::formatMinutesHours(cumulatedTravelTime + travelTime);
-
-        // Do not sum up for alternates - calculate again from destination for each alternate
-        if(!leg.isAlternate())
-          cumulatedTravelTime += travelTime;
-
-#ifdef DEBUG_INFORMATION_LEGTIME
-        txt += " [" + QString::number(cumulatedTravelTime * 3600., 'f', 0) + "]";
-#endif
-        model->item(row, rcol::ETA)->setText(txt);
-
-        // Fuel at leg =====================================================================
-        if(!leg.isAlternate())
-          totalFuelLbsOrGal -= altLeg.getFuel();
-        float totalTempFuel = totalFuelLbsOrGal;
-
-        if(leg.isAlternate())
-          totalTempFuel -= altLeg.getFuel();
-
-        float weight = 0.f, vol = 0.f;
-        if(perf.useFuelAsVolume())
-        {
-          weight = atools::geo::fromGalToLbs(perf.isJetFuel(), totalTempFuel);
-          vol = totalTempFuel;
-        }
-        else
-        {
-          weight = totalTempFuel;
-          vol = atools::geo::fromLbsToGal(perf.isJetFuel(), totalTempFuel);
-        }
-
-        if(atools::almostEqual(vol, 0.f, 0.01f))
-          // Avoid -0 case
-          vol = 0.f;
-        if(atools::almostEqual(weight, 0.f, 0.01f))
-          // Avoid -0 case
-          weight = 0.f;
-
-        txt = perf.isFuelFlowValid() ? Unit::weightLbs(weight, false /* addUnit */) : QString();
-        model->item(row, rcol::FUEL_WEIGHT)->setText(txt);
-
-        txt = perf.isFuelFlowValid() ? Unit::volGallon(vol, false /* addUnit */) : QString();
-        model->item(row, rcol::FUEL_VOLUME)->setText(txt);
-
-        // Wind at waypoint ========================================================
-        // Exclude departure and all after including destination airport
-        if(row > route.getDepartureAirportLegIndex() && row < route.getDestinationAirportLegIndex())
-        {
-          txt.clear();
-          float headWind = 0.f, crossWind = 0.f;
-          if(altLeg.getWindSpeed() >= 1.f)
-          {
-            atools::geo::windForCourse(headWind, crossWind, altLeg.getWindSpeed(),
-                                       altLeg.getWindDirection(), leg.getCourseToTrue());
-
-            txt = tr("%1 / %2").
-                  arg(atools::geo::normalizeCourse(altLeg.getWindDirection() - leg.getMagvar()), 0, 'f', 0).
-                  arg(Unit::speedKts(altLeg.getWindSpeed(), false /* addUnit */));
-          }
-
-          model->item(row, rcol::WIND)->setText(txt);
-
-          // Head or tailwind at waypoint ========================================================
-          txt.clear();
-          if(std::abs(headWind) >= 1.f)
-          {
-            QString ptr;
-            if(headWind >= 1.f)
-              ptr = tr("▼");
-            else if(headWind <= -1.f)
-              ptr = tr("▲");
-            txt.append(tr("%1 %2").arg(ptr).arg(Unit::speedKts(std::abs(headWind), false /* addUnit */)));
-          }
-          model->item(row, rcol::WIND_HEAD_TAIL)->setText(txt);
-        }
-
-        // Altitude at waypoint ========================================================
-        txt.clear();
-        float alt = altLeg.getWaypointAltitude();
-        if(alt < map::INVALID_ALTITUDE_VALUE)
-          txt = Unit::altFeet(alt, false /* addUnit */);
-        model->item(row, rcol::ALTITUDE)->setText(txt);
-
-        // Leg safe altitude ========================================================
-        txt.clear();
-        // Get ground buffer when flying towards waypoint
-        float safeAlt = NavApp::getGroundBufferForLegFt(i - 1);
-        if(safeAlt < map::INVALID_ALTITUDE_VALUE)
-          txt = Unit::altFeet(safeAlt, false /* addUnit */);
-        model->item(row, rcol::SAFE_ALTITUDE)->setText(txt);
-      } // if(!leg.getProcedureLeg().isMissed())
-    } // else if(!route.isAirportAfterArrival(row))
-    row++;
-  } // for(int i = 0; i < route.size(); i++)
-
-  // Set back column widths if visible - widget changes widths on setItem
-  if(widthLegTime > 0)
-    view->setColumnWidth(rcol::LEG_TIME, widthLegTime);
-  else
-    header->hideSection(rcol::LEG_TIME);
-
-  if(widthEta > 0)
-    view->setColumnWidth(rcol::ETA, widthEta);
-  else
-    header->hideSection(rcol::ETA);
-
-  if(widthFuelWeight > 0)
-    view->setColumnWidth(rcol::FUEL_WEIGHT, widthFuelWeight);
-  else
-    header->hideSection(rcol::FUEL_WEIGHT);
-
-  if(widthFuelVol > 0)
-    view->setColumnWidth(rcol::FUEL_VOLUME, widthFuelVol);
-  else
-    header->hideSection(rcol::FUEL_VOLUME);
-
-  if(widthWind > 0)
-    view->setColumnWidth(rcol::WIND, widthWind);
-  else
-    header->hideSection(rcol::WIND);
-
-  if(widthWindHt > 0)
-    view->setColumnWidth(rcol::WIND_HEAD_TAIL, widthWindHt);
-  else
-    header->hideSection(rcol::WIND_HEAD_TAIL);
-
-  if(widthAlt > 0)
-    view->setColumnWidth(rcol::ALTITUDE, widthAlt);
-  else
-    header->hideSection(rcol::ALTITUDE);
-
-  if(widthSafeAlt > 0)
-    view->setColumnWidth(rcol::SAFE_ALTITUDE, widthSafeAlt);
-  else
-    header->hideSection(rcol::SAFE_ALTITUDE);
+  // Updates only time, fuel, wind and altitude columns
+  model->updateTimeFuelWindAlt();
 }
 
 void RouteController::disconnectedFromSimulator()
@@ -4836,50 +4460,10 @@ void RouteController::highlightNextWaypoint(int activeLegIdx)
   if(model->rowCount() == 0)
     return;
 
-  // Remove background brush for all rows and columns ===============
+  // Add magenta brush for all columns in active row - removes highlight from previous row
   activeLegIndex = activeLegIdx;
-  for(int row = 0; row < model->rowCount(); ++row)
-  {
-    for(int col = 0; col < model->columnCount(); col++)
-    {
-      QStandardItem *item = model->item(row, col);
-      if(item != nullptr)
-      {
-        item->setBackground(Qt::NoBrush);
-        // Keep first column bold
-        if(item->font().bold() && col != 0)
-        {
-          QFont font = item->font();
-          font.setBold(false);
-          item->setFont(font);
-        }
-      }
-    }
-  }
-
-  if(!route.isEmpty() && OptionData::instance().getFlags2().testFlag(opts2::ROUTE_HIGHLIGHT_ACTIVE_TABLE))
-  {
-    // Add magenta brush for all columns in active row ======================
-    if(activeLegIndex >= 0 && activeLegIndex < route.size())
-    {
-      QColor color = NavApp::isCurrentGuiStyleNight() ? mapcolors::nextWaypointColorDark : mapcolors::nextWaypointColor;
-
-      for(int col = 0; col < model->columnCount(); col++)
-      {
-        QStandardItem *item = model->item(activeLegIndex, col);
-        if(item != nullptr)
-        {
-          item->setBackground(color);
-          if(!item->font().bold())
-          {
-            QFont font = item->font();
-            font.setBold(true);
-            item->setFont(font);
-          }
-        }
-      }
-    }
-  }
+  model->setActiveLeg(activeLegIndex, !route.isEmpty() && activeLegIndex >= 0 && activeLegIndex < route.size() &&
+                      OptionData::instance().getFlags2().testFlag(opts2::ROUTE_HIGHLIGHT_ACTIVE_TABLE));
 }
 
 /* Set colors for procedures and missing objects like waypoints and airways */
@@ -4889,99 +4473,9 @@ void RouteController::updateModelHighlights()
   if(model->rowCount() == 0)
     return;
 
-  bool night = NavApp::isCurrentGuiStyleNight();
-  const QColor defaultColor = QApplication::palette().color(QPalette::Normal, QPalette::Text);
-  const QColor invalidColor = night ? mapcolors::routeInvalidTableColorDark : mapcolors::routeInvalidTableColor;
   flightplanErrors.clear();
   trackErrors = false;
-
-  for(int row = 0; row < model->rowCount(); row++)
-  {
-    const RouteLeg& leg = route.value(row);
-    if(!leg.isValid())
-    {
-      // Have to check here since sim updates can still happen while building the flight plan
-      qWarning() << Q_FUNC_INFO << "Invalid index" << row;
-      break;
-    }
-
-    for(int col = 0; col < model->columnCount(); col++)
-    {
-      QStandardItem *item = model->item(row, col);
-      if(item != nullptr)
-      {
-        // Set default font color for all items ==============
-        item->setForeground(defaultColor);
-
-        if(leg.isAlternate())
-          item->setForeground(night ? mapcolors::routeAlternateTableColorDark : mapcolors::routeAlternateTableColor);
-        else if(leg.isAnyProcedure())
-        {
-          if(leg.getProcedureLeg().isMissed())
-            item->setForeground(night ? mapcolors::routeProcedureMissedTableColorDark : mapcolors::routeProcedureMissedTableColor);
-          else
-            item->setForeground(night ? mapcolors::routeProcedureTableColorDark : mapcolors::routeProcedureTableColor);
-        }
-
-        // Ident colum ==========================================
-        if(col == rcol::IDENT)
-        {
-          if(leg.getMapObjectType() == map::INVALID)
-          {
-            item->setForeground(invalidColor);
-            QString err = tr("Waypoint \"%1\" not found.").arg(leg.getDisplayIdent());
-            item->setToolTip(err);
-            flightplanErrors.append(err);
-          }
-          else
-            item->setToolTip(QString());
-
-          if(leg.getAirport().isValid())
-          {
-            QFont font = item->font();
-            if(leg.getAirport().addon())
-            {
-              font.setItalic(true);
-              font.setUnderline(true);
-            }
-            if(leg.getAirport().closed())
-              font.setStrikeOut(true);
-            item->setFont(font);
-          }
-        }
-
-        // Airway colum ==========================================
-        if(col == rcol::AIRWAY_OR_LEGTYPE && leg.isRoute())
-        {
-          QStringList airwayErrors;
-          bool trackError = false;
-          if(leg.isAirwaySetAndInvalid(route.getCruisingAltitudeFeet(), &airwayErrors, &trackError))
-          {
-            // Has airway but errors
-            item->setForeground(invalidColor);
-            QFont font = item->font();
-            font.setBold(true);
-            item->setFont(font);
-            if(!airwayErrors.isEmpty())
-            {
-              item->setToolTip(airwayErrors.join(tr("\n")));
-              flightplanErrors.append(airwayErrors);
-            }
-          }
-          else if(row != activeLegIndex)
-          {
-            // No airway or no errors - leave font bold if this is the active
-            QFont font = item->font();
-            font.setBold(false);
-            item->setFont(font);
-            item->setToolTip(QString());
-          }
-
-          trackErrors |= trackError;
-        }
-      }
-    }
-  }
+  model->updateHighlights(flightplanErrors, trackErrors);
 }
 
 bool RouteController::hasErrors() const
@@ -5119,7 +4613,8 @@ void RouteController::postChange(RouteCommand *undoCommand)
   // Index and clean index workaround
   undoIndex++;
 #ifdef DEBUG_INFORMATION
-  qDebug() << "postChange undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean;
+  qDebug() << "postChange undoIndex" << undoIndex << "undoIndexClean" << undoIndexClean
+           << "diff entries" << undoCommand->getNumDiffEntries();
 #endif
   undoStack->push(undoCommand);
 }
@@ -52,7 +52,6 @@ class FlightplanEntry;
 
 class QMainWindow;
 class QTableView;
-class QStandardItemModel;
 class QItemSelection;
 class FlightplanEntryBuilder;
 class SymbolPainter;
@@ -62,6 +61,7 @@ class UnitStringTool;
 class QTextCursor;
 class RouteCalcDialog;
 class RouteLabel;
+class RouteTableModel;
 
 /*
  * All flight plan related tasks like saving, loading, modification, calculation and table
@@ -359,11 +359,11 @@ private:
   /* Saves flight plan sippet using LNM format to given name. Given range must not contains procedures or alternates. */
   bool saveFlightplanLnmSelectionAs(const QString& filename, int from, int to) const;
 
-  /* Called by route command */
-  void changeRouteUndo(const atools::fs::pln::Flightplan& newFlightplan);
+  /* Called by route command. header contains flight plan values and properties. diffs are applied in order. */
+  void changeRouteUndo(const atools::fs::pln::Flightplan& header, const QVector<rctype::EntryDiff>& diffs);
 
   /* Called by route command */
-  void changeRouteRedo(const atools::fs::pln::Flightplan& newFlightplan);
+  void changeRouteRedo(const atools::fs::pln::Flightplan& header, const QVector<rctype::EntryDiff>& diffs);
 
   /* Called by route command */
   void undoMerge();
@@ -419,7 +419,15 @@ private:
   void updateFlightplanFromWidgets();
 
   /* Used by undo/redo */
-  void changeRouteUndoRedo(const atools::fs::pln::Flightplan& newFlightplan);
+  void changeRouteUndoRedo(const atools::fs::pln::Flightplan& header, const QVector<rctype::EntryDiff>& diffs);
+
+  /* Clear undo stack and show a warning if recorded changes do not match the plan. Called delayed since
+   * the stack cannot be cleared while an undo command is executed. */
+  void undoStackMismatch();
+
+  /* Apply changes directly to route legs if only legs between departure and destination are affected
+   * and procedures and alternates are unchanged. Returns false if route has to be rebuilt. */
+  bool changeRouteUndoRedoLegs(const atools::fs::pln::Flightplan& header, const QVector<rctype::EntryDiff>& diffs);
 
   void tableCopyClipboard();
 
@@ -542,7 +550,7 @@ private:
   QMainWindow *mainWindow;
   QTableView *view;
   AirportQuery *airportQuery;
-  QStandardItemModel *model;
+  RouteTableModel *model;
   QUndoStack *undoStack = nullptr;
   FlightplanEntryBuilder *entryBuilder = nullptr;
   atools::fs::pln::FlightplanIO *flightplanIO = nullptr;
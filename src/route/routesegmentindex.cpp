@@ -0,0 +1,197 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/routesegmentindex.h"
+
+#include "atools.h"
+#include "geo/calculations.h"
+#include "route/route.h"
+
+#include <algorithm>
+#include <cmath>
+
+using atools::geo::Pos;
+
+/* Two degree grid */
+const static float CELL_SIZE_DEG = 2.f;
+const static int GRID_COLUMNS = 180;
+const static int GRID_ROWS = 90;
+
+/* Segments with a larger radius are not put into the grid */
+const static float MAX_GRID_RADIUS_DEG = 10.f;
+
+/* Added to circle extents to catch inaccuracies of the degree approximation */
+const static float MARGIN_FACTOR = 1.1f;
+
+static float meterToDeg(float meter)
+{
+  return atools::geo::meterToNm(meter) / 60.f;
+}
+
+void RouteSegmentIndex::clear()
+{
+  cells.clear();
+  largeSegments.clear();
+  distanceSums.clear();
+  distanceSumsMissed.clear();
+  distanceSumsAlternate.clear();
+  revision = 0;
+  valid = false;
+}
+
+void RouteSegmentIndex::build(const Route& route)
+{
+  clear();
+
+  double sum = 0., sumMissed = 0., sumAlternate = 0.;
+  for(int i = 0; i < route.size(); i++)
+  {
+    const RouteLeg& leg = route.value(i);
+
+    // Cumulative distances ===========================
+    float distance = leg.getDistanceTo();
+    sum += distance;
+    if(leg.getProcedureLeg().isMissed())
+      sumMissed += distance;
+    if(leg.isAlternate())
+      sumAlternate += distance;
+    distanceSums.append(sum);
+    distanceSumsMissed.append(sumMissed);
+    distanceSumsAlternate.append(sumAlternate);
+
+    // Segments ===========================
+    if(i > 0)
+    {
+      const Pos& from = route.getPrevPositionAt(i);
+      const Pos& to = route.getPositionAt(i);
+      if(from.isValid() && to.isValid())
+        // All points of the segment are within segment length of the start point
+        insert(i, from.getLonX(), from.getLatY(), from.distanceMeterTo(to));
+    }
+  }
+
+  revision = route.getRevision();
+  valid = true;
+}
+
+void RouteSegmentIndex::insert(int index, float lonX, float latY, float radiusMeter)
+{
+  float radiusDeg = meterToDeg(radiusMeter) * MARGIN_FACTOR + CELL_SIZE_DEG;
+  int colMin, colMax, rowMin, rowMax;
+  if(radiusDeg > MAX_GRID_RADIUS_DEG || !columnRange(colMin, colMax, lonX, latY, radiusDeg))
+  {
+    largeSegments.append(index);
+    return;
+  }
+  rowRange(rowMin, rowMax, latY, radiusDeg);
+
+  for(int row = rowMin; row <= rowMax; row++)
+  {
+    for(int col = colMin; col <= colMax; col++)
+      cells[row * GRID_COLUMNS + (col + GRID_COLUMNS) % GRID_COLUMNS].append(index);
+  }
+}
+
+void RouteSegmentIndex::candidates(QVector<int>& indexes, const Pos& pos, float distanceMeter) const
+{
+  indexes = largeSegments;
+
+  float radiusDeg = meterToDeg(distanceMeter) * MARGIN_FACTOR + CELL_SIZE_DEG;
+  int colMin, colMax, rowMin, rowMax;
+  rowRange(rowMin, rowMax, pos.getLatY(), radiusDeg);
+  if(!columnRange(colMin, colMax, pos.getLonX(), pos.getLatY(), radiusDeg))
+  {
+    colMin = 0;
+    colMax = GRID_COLUMNS - 1;
+  }
+
+  if((colMax - colMin + 1) * (rowMax - rowMin + 1) > cells.size())
+  {
+    // Less occupied cells than cells in rectangle - check all occupied cells
+    for(auto it = cells.constBegin(); it != cells.constEnd(); ++it)
+    {
+      int col = it.key() % GRID_COLUMNS, row = it.key() / GRID_COLUMNS;
+      if(row >= rowMin && row <= rowMax &&
+         ((col >= colMin && col <= colMax) || (col + GRID_COLUMNS >= colMin && col + GRID_COLUMNS <= colMax) ||
+          (col - GRID_COLUMNS >= colMin && col - GRID_COLUMNS <= colMax)))
+        indexes.append(it.value());
+    }
+  }
+  else
+  {
+    for(int row = rowMin; row <= rowMax; row++)
+    {
+      for(int col = colMin; col <= colMax; col++)
+      {
+        auto it = cells.constFind(row * GRID_COLUMNS + (col + GRID_COLUMNS) % GRID_COLUMNS);
+        if(it != cells.constEnd())
+          indexes.append(it.value());
+      }
+    }
+  }
+
+  // Segments spanning more than one cell are found more than once
+  std::sort(indexes.begin(), indexes.end());
+  indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+}
+
+double RouteSegmentIndex::getDistanceSum(int index, DistanceSum type) const
+{
+  if(index < 0 || index >= distanceSums.size())
+    return 0.;
+
+  switch(type)
+  {
+    case RouteSegmentIndex::SUM_ALL:
+      return distanceSums.at(index);
+
+    case RouteSegmentIndex::SUM_MISSED:
+      return distanceSumsMissed.at(index);
+
+    case RouteSegmentIndex::SUM_ALTERNATE:
+      return distanceSumsAlternate.at(index);
+  }
+  return 0.;
+}
+
+float RouteSegmentIndex::cellSizeMeter()
+{
+  return atools::geo::nmToMeter(CELL_SIZE_DEG * 60.f);
+}
+
+void RouteSegmentIndex::rowRange(int& rowMin, int& rowMax, float latY, float radiusDeg)
+{
+  rowMin = atools::minmax(0, GRID_ROWS - 1, static_cast<int>(std::floor((latY - radiusDeg + 90.f) / CELL_SIZE_DEG)));
+  rowMax = atools::minmax(0, GRID_ROWS - 1, static_cast<int>(std::floor((latY + radiusDeg + 90.f) / CELL_SIZE_DEG)));
+}
+
+bool RouteSegmentIndex::columnRange(int& colMin, int& colMax, float lonX, float latY, float radiusDeg)
+{
+  // Longitude extent grows towards the poles
+  float maxLat = std::abs(latY) + radiusDeg;
+  if(maxLat >= 89.f)
+    return false;
+
+  float lonRadiusDeg = radiusDeg / std::cos(atools::geo::toRadians(maxLat));
+  if(lonRadiusDeg >= 180.f)
+    return false;
+
+  // Not clamped - columns are wrapped at the anti-meridian by caller
+  colMin = static_cast<int>(std::floor((lonX - lonRadiusDeg + 180.f) / CELL_SIZE_DEG));
+  colMax = static_cast<int>(std::floor((lonX + lonRadiusDeg + 180.f) / CELL_SIZE_DEG));
+  return true;
+}
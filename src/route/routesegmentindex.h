@@ -0,0 +1,93 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_ROUTESEGMENTINDEX_H
+#define LITTLENAVMAP_ROUTESEGMENTINDEX_H
+
+#include <QHash>
+#include <QVector>
+
+class Route;
+
+namespace atools {
+namespace geo {
+class Pos;
+}
+}
+
+/*
+ * Spatial index for the leg segments of a route and cumulative leg distances.
+ *
+ * Segment of leg i is the line from Route::getPrevPositionAt(i) to Route::getPositionAt(i).
+ * Leg 0 has no segment. Segments are assigned to all cells of a coarse lat/lon grid which are covered
+ * by a circle around the start point with the segment length as radius. Very long segments are always returned.
+ *
+ * Built by Route::updateAll(). Callers have to fall back to scanning all legs if isValidFor() returns false.
+ * The index is keyed on the route revision which changes with every modification of the legs.
+ */
+class RouteSegmentIndex
+{
+public:
+  /* Type of legs to sum up for cumulative distances */
+  enum DistanceSum
+  {
+    SUM_ALL,
+    SUM_MISSED,
+    SUM_ALTERNATE
+  };
+
+  void build(const Route& route);
+  void clear();
+
+  /* true if built for the given route revision. See Route::getRevision() */
+  bool isValidFor(quint32 routeRevision) const
+  {
+    return valid && revision == routeRevision;
+  }
+
+  /* Get sorted leg indexes of all segments which might have a point within distanceMeter of pos.
+   * Candidates have to be checked by caller. */
+  void candidates(QVector<int>& indexes, const atools::geo::Pos& pos, float distanceMeter) const;
+
+  /* Sum of leg distances in NM from departure up to and including leg index for the given type */
+  double getDistanceSum(int index, DistanceSum type = SUM_ALL) const;
+
+  /* Size of a grid cell in meter. Used as initial search radius. */
+  static float cellSizeMeter();
+
+private:
+  void insert(int index, float lonX, float latY, float radiusMeter);
+
+  /* Get clamped row and wrapped column range for a circle. Returns false if circle covers all columns. */
+  static bool columnRange(int& colMin, int& colMax, float lonX, float latY, float radiusDeg);
+  static void rowRange(int& rowMin, int& rowMax, float latY, float radiusDeg);
+
+  /* Row major cell index to leg indexes */
+  QHash<int, QVector<int> > cells;
+
+  /* Segments which are too long for the grid */
+  QVector<int> largeSegments;
+
+  /* Cumulative values */
+  QVector<double> distanceSums, distanceSumsMissed, distanceSumsAlternate;
+
+  /* Route revision at the time of build() */
+  quint32 revision = 0;
+  bool valid = false;
+};
+
+#endif // LITTLENAVMAP_ROUTESEGMENTINDEX_H
@@ -0,0 +1,739 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "route/routetablemodel.h"
+
+#include "atools.h"
+#include "common/formatter.h"
+#include "common/mapcolors.h"
+#include "common/symbolpainter.h"
+#include "common/unit.h"
+#include "fs/perf/aircraftperf.h"
+#include "geo/calculations.h"
+#include "navapp.h"
+#include "route/route.h"
+#include "route/routealtitude.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QFont>
+
+/* Bit mask for the cached columns is limited to 32 bits */
+Q_STATIC_ASSERT(rcol::LAST_COLUMN < 32);
+
+/* Columns filled by updateTimeFuelWindAlt() */
+const static quint32 TIME_FUEL_WIND_ALT_MASK = ((1u << (rcol::SAFE_ALTITUDE + 1)) - 1u) & ~((1u << rcol::LEG_TIME) - 1u);
+
+/* Elide remarks in table cells and tooltips */
+const static int MAX_REMARK_COLS = 80;
+const static int MAX_REMARK_LINES_TOOLTIP = 20;
+
+static bool isAlignRight(int column)
+{
+  switch(column)
+  {
+    case rcol::IDENT:
+    case rcol::REGION:
+    case rcol::REMAINING_DISTANCE:
+    case rcol::DIST:
+    case rcol::COURSE:
+    case rcol::COURSETRUE:
+    case rcol::RANGE:
+    case rcol::FREQ:
+    case rcol::RESTRICTION:
+    case rcol::LEG_TIME:
+    case rcol::ETA:
+    case rcol::FUEL_WEIGHT:
+    case rcol::FUEL_VOLUME:
+    case rcol::WIND:
+    case rcol::WIND_HEAD_TAIL:
+    case rcol::ALTITUDE:
+    case rcol::SAFE_ALTITUDE:
+    case rcol::LATITUDE:
+    case rcol::LONGITUDE:
+      return true;
+  }
+  return false;
+}
+
+/* Procedure remarks like turn and flyover or user comment on normal leg */
+static QString remarkText(const RouteLeg& leg)
+{
+  if(leg.isAnyProcedure())
+    return proc::procedureLegRemark(leg.getProcedureLeg()).join(RouteTableModel::tr(" / "));
+  else
+    return leg.getFlightplanEntry().getComment();
+}
+
+RouteTableModel::RouteTableModel(QObject *parent, const Route *routeParam)
+  : QAbstractTableModel(parent), route(routeParam)
+{
+}
+
+RouteTableModel::~RouteTableModel()
+{
+}
+
+int RouteTableModel::rowCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : numRows;
+}
+
+int RouteTableModel::columnCount(const QModelIndex& parent) const
+{
+  return parent.isValid() ? 0 : rcol::LAST_COLUMN + 1;
+}
+
+Qt::ItemFlags RouteTableModel::flags(const QModelIndex& index) const
+{
+  if(!index.isValid())
+    return Qt::NoItemFlags;
+
+  // Do not allow editing and drag and drop
+  return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+QVariant RouteTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if(orientation == Qt::Horizontal)
+  {
+    if(role == Qt::DisplayRole && section >= 0 && section < headerLabels.size())
+      return headerLabels.at(section);
+    else if(role == Qt::ToolTipRole && section >= 0 && section < headerToolTips.size())
+      return headerToolTips.at(section);
+  }
+  return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QVariant RouteTableModel::data(const QModelIndex& index, int role) const
+{
+  // Route might be already changed while the model is not reset yet
+  if(!index.isValid() || index.row() >= numRows || index.row() >= route->size())
+    return QVariant();
+
+  int row = index.row(), column = index.column();
+  switch(role)
+  {
+    case Qt::DisplayRole:
+      return cellText(row, column);
+
+    case Qt::DecorationRole:
+      if(column == rcol::IDENT)
+      {
+        RowCache& rowCache = cache[row];
+        if(!rowCache.iconValid)
+        {
+          rowCache.icon = iconForLeg(route->value(row), iconSize);
+          rowCache.iconValid = true;
+        }
+        return rowCache.icon;
+      }
+      break;
+
+    case Qt::TextAlignmentRole:
+      if(isAlignRight(column))
+        return static_cast<int>(Qt::AlignRight);
+      break;
+
+    case Qt::ForegroundRole:
+      return foregroundColor(row, column);
+
+    case Qt::BackgroundRole:
+      if(highlightActive && row == activeLegIndex)
+        return activeColor;
+      break;
+
+    case Qt::FontRole:
+      return font(row, column);
+
+    case Qt::ToolTipRole:
+      return toolTip(row, column);
+  }
+  return QVariant();
+}
+
+const QString& RouteTableModel::cellText(int row, int column) const
+{
+  RowCache& rowCache = cache[row];
+  if(rowCache.texts.isEmpty())
+    rowCache.texts.resize(rcol::LAST_COLUMN + 1);
+
+  quint32 bit = 1u << column;
+  if(!(rowCache.validColumns & bit))
+  {
+    rowCache.texts[column] = formatText(row, column);
+    rowCache.validColumns |= bit;
+  }
+  return rowCache.texts.at(column);
+}
+
+QString RouteTableModel::formatText(int row, int column) const
+{
+  if((1u << column) & TIME_FUEL_WIND_ALT_MASK)
+    return formatTimeFuelWindAlt(row, column);
+
+  const RouteLeg& leg = route->value(row);
+  const proc::MapProcedureLeg& procedureLeg = leg.getProcedureLeg();
+
+  switch(column)
+  {
+    // Ident ===========================================
+    case rcol::IDENT:
+      if(leg.isAnyProcedure())
+        // Get ident with IAF, FAF or other indication
+        return proc::procedureLegFixStr(procedureLeg);
+      else
+        return leg.getDisplayIdent();
+
+    // Region, navaid name, procedure type ===========================================
+    case rcol::REGION:
+      return leg.getRegion();
+
+    case rcol::NAME:
+      return leg.getName();
+
+    case rcol::PROCEDURE:
+      if(row == route->getDepartureAirportLegIndex() && !route->getDepartureAirportLeg().isAnyProcedure())
+        return tr("Departure");
+      else if(row == route->getDestinationAirportLegIndex() && !route->getDestinationAirportLeg().isAnyProcedure())
+        return tr("Destination");
+      else if(leg.isAlternate())
+        return tr("Alternate");
+      else if(leg.isAnyProcedure())
+        return route->getProcedureLegText(leg.getProcedureType(), false /* includeRunway */, false /* missedAsApproach */,
+                                          true /* transitionAsProcedure */);
+      break;
+
+    // Airway or leg type and restriction ===========================================
+    case rcol::AIRWAY_OR_LEGTYPE:
+      if(leg.isRoute())
+      {
+        const map::MapAirway& airway = leg.getAirway();
+        QStringList awname;
+        awname.append(airway.isValid() && airway.isTrack() ? tr("Track %1").arg(leg.getAirwayName()) : leg.getAirwayName());
+
+        if(airway.isValid())
+        {
+          awname.append(map::airwayTrackTypeToShortString(airway.type));
+
+#ifdef DEBUG_INFORMATION
+          awname.append("[" + map::airwayRouteTypeToStringShort(airway.routeType) + "]");
+#endif
+          awname.removeAll(QString());
+        }
+        return awname.join(tr(" / "));
+      }
+      else
+        return atools::strJoin({leg.getFlightplanEntry().getAirway(), proc::procedureLegTypeStr(procedureLeg.type)}, tr(", "));
+
+    case rcol::RESTRICTION:
+      if(leg.isRoute())
+      {
+        if(leg.getAirway().isValid())
+          return map::airwayAltTextShort(leg.getAirway(), false /* addUnit */, false /* narrow */);
+      }
+      else
+        return proc::restrictionText(procedureLeg).join(tr(", "));
+      break;
+
+    // VOR/NDB type and frequency or ILS for approach runway =====================
+    case rcol::TYPE:
+    case rcol::FREQ:
+      if(leg.getVor().isValid())
+      {
+        if(column == rcol::TYPE)
+          return map::vorFullShortText(leg.getVor());
+        else if(leg.getVor().tacan)
+          return leg.getVor().channel;
+        else
+          return QLocale().toString(leg.getFrequency() / 1000.f, 'f', 2);
+      }
+      else if(leg.getNdb().isValid())
+      {
+        if(column == rcol::TYPE)
+          return map::ndbFullShortText(leg.getNdb());
+        else
+          return QLocale().toString(leg.getFrequency() / 100.f, 'f', 1);
+      }
+      else if(procedureLeg.isApproach() && leg.getRunwayEnd().isValid())
+      {
+        // Get ILS for approach runway if it marks the end of an ILS or localizer approach procedure
+        // Use recommended ILS which can also apply to non ILS approaches
+        QStringList texts;
+        for(const map::MapIls& ils : route->getDestRunwayIlsFlightPlanTable())
+        {
+          if(column == rcol::TYPE)
+            texts.append(map::ilsType(ils, true /* gs */, true /* dme */, tr(", ")));
+          else if(!ils.isAnyGlsRnp())
+            texts.append(ils.freqMHzLocale());
+        }
+        return texts.join(", ");
+      }
+      break;
+
+    // VOR/NDB range =====================
+    case rcol::RANGE:
+      if(leg.getRange() > 0 && (leg.getVor().isValid() || leg.getNdb().isValid()))
+        return Unit::distNm(leg.getRange(), false);
+
+      break;
+
+    // Course =====================
+    case rcol::COURSE:
+    case rcol::COURSETRUE:
+      {
+        bool parkingToDeparture = route->hasAnySidProcedure() && row == 0;
+        if(row > 0 && !route->isAirportAfterArrival(row) && !parkingToDeparture &&
+           leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE && leg.getDistanceTo() > 0.f && !leg.noCourseDisplay())
+        {
+          float course = column == rcol::COURSE ? leg.getCourseToMag() : leg.getCourseToTrue();
+          if(course < map::INVALID_COURSE_VALUE)
+            return QLocale().toString(course, 'f', 0);
+        }
+      }
+      break;
+
+    // Distance =====================
+    case rcol::DIST:
+      if(!route->isAirportAfterArrival(row) && leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE)
+        return Unit::distNm(leg.getDistanceTo(), false);
+
+      break;
+
+    case rcol::REMAINING_DISTANCE:
+      if(row < remainingDistances.size() && remainingDistances.at(row) < map::INVALID_DISTANCE_VALUE)
+        return Unit::distNm(remainingDistances.at(row), false);
+
+      break;
+
+    case rcol::LATITUDE:
+      return Unit::coordsLatY(leg.getPosition());
+
+    case rcol::LONGITUDE:
+      return Unit::coordsLonX(leg.getPosition());
+
+    case rcol::RECOMMENDED:
+      return atools::elideTextShort(proc::procedureLegRecommended(procedureLeg).join(tr(", ")), MAX_REMARK_COLS);
+
+    case rcol::REMARKS:
+      return atools::elideTextShort(remarkText(leg), MAX_REMARK_COLS);
+  }
+  return QString();
+}
+
+QString RouteTableModel::formatTimeFuelWindAlt(int row, int column) const
+{
+  // Do not fill if collecting performance or route altitude is invalid
+  const RouteAltitude& altitudeLegs = route->getAltitudeLegs();
+  if(!timeFuelValid || row >= altitudeLegs.size() || row >= arrivalTimes.size())
+    return QString();
+
+  const RouteLeg& leg = route->value(row);
+  const RouteAltitudeLeg& altLeg = altitudeLegs.value(row);
+
+  if(leg.getProcedureLeg().isMissed())
+    // Nothing for missed approach legs
+    return QString();
+
+  switch(column)
+  {
+    // Leg time =====================================================================
+    case rcol::LEG_TIME:
+      {
+        float travelTime = altLeg.getTime();
+        if(row > 0 && travelTime < map::INVALID_TIME_VALUE)
+        {
+          QString txt = formatter::formatMinutesHours(travelTime);
+#ifdef DEBUG_INFORMATION_LEGTIME
+          txt += " [" + QString::number(travelTime * 3600., 'f', 0) + "]";
+#endif
+          return txt;
+        }
+      }
+      break;
+
+    // Arrival time =====================================================================
+    case rcol::ETA:
+      {
+        QString txt = formatter::formatMinutesHours(arrivalTimes.at(row));
+#ifdef DEBUG_INFORMATION_LEGTIME
+        txt += " [" + QString::number(arrivalTimes.at(row) * 3600., 'f', 0) + "]";
+#endif
+        return txt;
+      }
+
+    // Fuel at leg =====================================================================
+    case rcol::FUEL_WEIGHT:
+    case rcol::FUEL_VOLUME:
+      if(fuelFlowValid)
+      {
+        float fuel = fuelLbsOrGal.at(row);
+        float weight = 0.f, vol = 0.f;
+        if(fuelAsVolume)
+        {
+          weight = atools::geo::fromGalToLbs(jetFuel, fuel);
+          vol = fuel;
+        }
+        else
+        {
+          weight = fuel;
+          vol = atools::geo::fromLbsToGal(jetFuel, fuel);
+        }
+
+        if(column == rcol::FUEL_WEIGHT)
+          // Avoid -0 case
+          return Unit::weightLbs(atools::almostEqual(weight, 0.f, 0.01f) ? 0.f : weight, false /* addUnit */);
+        else
+          return Unit::volGallon(atools::almostEqual(vol, 0.f, 0.01f) ? 0.f : vol, false /* addUnit */);
+      }
+      break;
+
+    // Wind and head- or tailwind at waypoint ========================================================
+    case rcol::WIND:
+    case rcol::WIND_HEAD_TAIL:
+      // Exclude departure and all after including destination airport
+      if(row > route->getDepartureAirportLegIndex() && row < route->getDestinationAirportLegIndex() &&
+         altLeg.getWindSpeed() >= 1.f)
+      {
+        if(column == rcol::WIND)
+          return tr("%1 / %2").
+                 arg(atools::geo::normalizeCourse(altLeg.getWindDirection() - leg.getMagvar()), 0, 'f', 0).
+                 arg(Unit::speedKts(altLeg.getWindSpeed(), false /* addUnit */));
+        else
+        {
+          float headWind = 0.f, crossWind = 0.f;
+          atools::geo::windForCourse(headWind, crossWind, altLeg.getWindSpeed(), altLeg.getWindDirection(),
+                                     leg.getCourseToTrue());
+
+          if(std::abs(headWind) >= 1.f)
+            return tr("%1 %2").
+                   arg(headWind >= 1.f ? tr("▼") : tr("▲")).
+                   arg(Unit::speedKts(std::abs(headWind), false /* addUnit */));
+        }
+      }
+      break;
+
+    // Altitude at waypoint ========================================================
+    case rcol::ALTITUDE:
+      if(altLeg.getWaypointAltitude() < map::INVALID_ALTITUDE_VALUE)
+        return Unit::altFeet(altLeg.getWaypointAltitude(), false /* addUnit */);
+
+      break;
+
+    // Leg safe altitude ========================================================
+    case rcol::SAFE_ALTITUDE:
+      {
+        // Get ground buffer when flying towards waypoint
+        float safeAlt = NavApp::getGroundBufferForLegFt(row - 1);
+        if(safeAlt < map::INVALID_ALTITUDE_VALUE)
+          return Unit::altFeet(safeAlt, false /* addUnit */);
+      }
+      break;
+  }
+  return QString();
+}
+
+QVariant RouteTableModel::foregroundColor(int row, int column) const
+{
+  if(!defaultColor.isValid() || row >= rowStates.size())
+    // Highlights not calculated yet
+    return QVariant();
+
+  const RowState& state = rowStates.at(row);
+  if((column == rcol::IDENT && state.identInvalid) || (column == rcol::AIRWAY_OR_LEGTYPE && state.airwayInvalid))
+    return night ? mapcolors::routeInvalidTableColorDark : mapcolors::routeInvalidTableColor;
+
+  const RouteLeg& leg = route->value(row);
+  if(leg.isAlternate())
+    return night ? mapcolors::routeAlternateTableColorDark : mapcolors::routeAlternateTableColor;
+  else if(leg.isAnyProcedure())
+  {
+    if(leg.getProcedureLeg().isMissed())
+      return night ? mapcolors::routeProcedureMissedTableColorDark : mapcolors::routeProcedureMissedTableColor;
+    else
+      return night ? mapcolors::routeProcedureTableColorDark : mapcolors::routeProcedureTableColor;
+  }
+  return defaultColor;
+}
+
+QVariant RouteTableModel::font(int row, int column) const
+{
+  // Use an empty font with only the changed attributes set to keep the view font size
+  QFont font;
+  bool changed = false;
+
+  if(column == rcol::IDENT)
+  {
+    // Ident is always bold
+    font.setBold(true);
+
+    const map::MapAirport& airport = route->value(row).getAirport();
+    if(airport.isValid())
+    {
+      if(airport.addon())
+      {
+        font.setItalic(true);
+        font.setUnderline(true);
+      }
+      if(airport.closed())
+        font.setStrikeOut(true);
+    }
+    changed = true;
+  }
+
+  if((highlightActive && row == activeLegIndex) ||
+     (column == rcol::AIRWAY_OR_LEGTYPE && row < rowStates.size() && rowStates.at(row).airwayInvalid))
+  {
+    font.setBold(true);
+    changed = true;
+  }
+
+  return changed ? QVariant(font) : QVariant();
+}
+
+QVariant RouteTableModel::toolTip(int row, int column) const
+{
+  if(column == rcol::IDENT && row < rowStates.size() && rowStates.at(row).identInvalid)
+    return tr("Waypoint \"%1\" not found.").arg(route->value(row).getDisplayIdent());
+  else if(column == rcol::AIRWAY_OR_LEGTYPE && row < rowStates.size() && rowStates.at(row).airwayInvalid)
+    return rowStates.at(row).airwayToolTip;
+  else if(column == rcol::REMARKS)
+  {
+    QString comment = remarkText(route->value(row));
+    if(!comment.isEmpty())
+      return atools::elideTextLinesShort(comment, MAX_REMARK_LINES_TOOLTIP, MAX_REMARK_COLS);
+  }
+  return QVariant();
+}
+
+void RouteTableModel::updateAll(int iconSizeParam)
+{
+  beginResetModel();
+
+  iconSize = iconSizeParam;
+  numRows = route->size();
+
+  cache.clear();
+  cache.resize(numRows);
+
+  // Highlights are calculated in updateHighlights()
+  rowStates.clear();
+  rowStates.resize(numRows);
+
+  calculateDistances();
+  calculateTimeFuel();
+
+  endResetModel();
+}
+
+void RouteTableModel::updateTimeFuelWindAlt()
+{
+  if(numRows == 0)
+    return;
+
+  calculateTimeFuel();
+
+  // Drop cached texts for time, fuel, wind and altitude columns only
+  for(RowCache& rowCache : cache)
+    rowCache.validColumns &= ~TIME_FUEL_WIND_ALT_MASK;
+
+  emit dataChanged(index(0, rcol::LEG_TIME), index(numRows - 1, rcol::SAFE_ALTITUDE), {Qt::DisplayRole});
+}
+
+void RouteTableModel::updateHighlights(QStringList& flightplanErrors, bool& trackErrors)
+{
+  if(numRows == 0)
+    return;
+
+  // Colors change for all rows if style changes
+  bool nightStyle = NavApp::isCurrentGuiStyleNight();
+  QColor textColor = QApplication::palette().color(QPalette::Normal, QPalette::Text);
+  bool styleChanged = nightStyle != night || textColor != defaultColor;
+  night = nightStyle;
+  defaultColor = textColor;
+
+  for(int row = 0; row < numRows; row++)
+  {
+    const RouteLeg& leg = route->value(row);
+    if(!leg.isValid())
+    {
+      // Have to check here since sim updates can still happen while building the flight plan
+      qWarning() << Q_FUNC_INFO << "Invalid index" << row;
+      break;
+    }
+
+    RowState state;
+
+    // Ident colum ==========================================
+    if(leg.getMapObjectType() == map::INVALID)
+    {
+      state.identInvalid = true;
+      flightplanErrors.append(tr("Waypoint \"%1\" not found.").arg(leg.getDisplayIdent()));
+    }
+
+    // Airway colum ==========================================
+    if(leg.isRoute())
+    {
+      QStringList airwayErrors;
+      bool trackError = false;
+      if(leg.isAirwaySetAndInvalid(route->getCruisingAltitudeFeet(), &airwayErrors, &trackError))
+      {
+        // Has airway but errors
+        state.airwayInvalid = true;
+        if(!airwayErrors.isEmpty())
+        {
+          state.airwayToolTip = airwayErrors.join(tr("\n"));
+          flightplanErrors.append(airwayErrors);
+        }
+      }
+      trackErrors |= trackError;
+    }
+
+    if(state != rowStates.at(row))
+    {
+      rowStates[row] = state;
+      if(!styleChanged)
+        emit dataChanged(index(row, rcol::FIRST_COLUMN), index(row, rcol::LAST_COLUMN),
+                         {Qt::ForegroundRole, Qt::FontRole, Qt::ToolTipRole});
+    }
+  }
+
+  if(styleChanged)
+    emit dataChanged(index(0, rcol::FIRST_COLUMN), index(numRows - 1, rcol::LAST_COLUMN),
+                     {Qt::ForegroundRole, Qt::FontRole, Qt::ToolTipRole});
+}
+
+void RouteTableModel::setActiveLeg(int activeLegIndexParam, bool highlightParam)
+{
+  QColor color = NavApp::isCurrentGuiStyleNight() ? mapcolors::nextWaypointColorDark : mapcolors::nextWaypointColor;
+
+  // Rows which are currently shown highlighted
+  int oldRow = highlightActive ? activeLegIndex : -1;
+  int newRow = highlightParam ? activeLegIndexParam : -1;
+  bool colorChanged = color != activeColor;
+
+  activeLegIndex = activeLegIndexParam;
+  highlightActive = highlightParam;
+  activeColor = color;
+
+  if(oldRow != newRow || colorChanged)
+  {
+    for(int row : {oldRow, newRow})
+    {
+      if(row >= 0 && row < numRows)
+        emit dataChanged(index(row, rcol::FIRST_COLUMN), index(row, rcol::LAST_COLUMN),
+                         {Qt::BackgroundRole, Qt::FontRole});
+    }
+  }
+}
+
+void RouteTableModel::setHeaderLabels(const QStringList& labels)
+{
+  headerLabels = labels;
+  emit headerDataChanged(Qt::Horizontal, rcol::FIRST_COLUMN, rcol::LAST_COLUMN);
+}
+
+void RouteTableModel::setHeaderToolTips(const QStringList& toolTips)
+{
+  headerToolTips = toolTips;
+  emit headerDataChanged(Qt::Horizontal, rcol::FIRST_COLUMN, rcol::LAST_COLUMN);
+}
+
+void RouteTableModel::calculateDistances()
+{
+  remainingDistances.fill(map::INVALID_DISTANCE_VALUE, numRows);
+
+  float totalDistance = route->getTotalDistance();
+  float cumulatedDistance = 0.f;
+  for(int row = 0; row < numRows; row++)
+  {
+    const RouteLeg& leg = route->value(row);
+    if(!route->isAirportAfterArrival(row) && leg.getDistanceTo() < map::INVALID_DISTANCE_VALUE)
+    {
+      cumulatedDistance += leg.getDistanceTo();
+
+      if(!leg.getProcedureLeg().isMissed() && !leg.isAlternate())
+        // Catch the -0 case due to rounding errors
+        remainingDistances[row] = std::max(totalDistance - cumulatedDistance, 0.f);
+    }
+  }
+}
+
+void RouteTableModel::calculateTimeFuel()
+{
+  using atools::fs::perf::AircraftPerf;
+
+  const RouteAltitude& altitudeLegs = route->getAltitudeLegs();
+  const AircraftPerf& perf = NavApp::getAircraftPerformance();
+
+  timeFuelValid = !altitudeLegs.isEmpty() && !altitudeLegs.hasErrors();
+  fuelFlowValid = perf.isFuelFlowValid();
+  fuelAsVolume = perf.useFuelAsVolume();
+  jetFuel = perf.isJetFuel();
+
+  arrivalTimes.fill(0.f, numRows);
+  fuelLbsOrGal.fill(0.f, numRows);
+
+  if(!timeFuelValid)
+    return;
+
+  float totalFuelLbsOrGal = altitudeLegs.getTripFuel() + altitudeLegs.getAlternateFuel();
+  totalFuelLbsOrGal *= perf.getContingencyFuelFactor();
+  totalFuelLbsOrGal += perf.getExtraFuel() + perf.getReserveFuel();
+
+  float cumulatedTravelTime = 0.f;
+  for(int row = 0; row < numRows && row < altitudeLegs.size(); row++)
+  {
+    const RouteLeg& leg = route->value(row);
+    if(leg.getProcedureLeg().isMissed())
+      continue;
+
+    const RouteAltitudeLeg& altLeg = altitudeLegs.value(row);
+
+    // Do not sum up for alternates - calculate again from destination for each alternate
+    arrivalTimes[row] = cumulatedTravelTime + altLeg.getTime();
+    if(!leg.isAlternate())
+    {
+      cumulatedTravelTime += altLeg.getTime();
+      totalFuelLbsOrGal -= altLeg.getFuel();
+      fuelLbsOrGal[row] = totalFuelLbsOrGal;
+    }
+    else
+      fuelLbsOrGal[row] = totalFuelLbsOrGal - altLeg.getFuel();
+  }
+}
+
+QIcon RouteTableModel::iconForLeg(const RouteLeg& leg, int size)
+{
+  QIcon icon;
+  if(leg.getMapObjectType() == map::AIRPORT)
+    icon = SymbolPainter::createAirportIcon(leg.getAirport(), size - 2);
+  else if(leg.getVor().isValid())
+    icon = SymbolPainter::createVorIcon(leg.getVor(), size);
+  else if(leg.getNdb().isValid())
+    icon = SymbolPainter::createNdbIcon(size);
+  else if(leg.getWaypoint().isValid())
+    icon = SymbolPainter::createWaypointIcon(size);
+  else if(leg.getMapObjectType() == map::USERPOINTROUTE)
+    icon = SymbolPainter::createUserpointIcon(size);
+  else if(leg.getMapObjectType() == map::INVALID)
+    icon = SymbolPainter::createWaypointIcon(size, mapcolors::routeInvalidPointColor);
+  else if(leg.isAnyProcedure())
+    icon = SymbolPainter::createProcedurePointIcon(size);
+
+  return icon;
+}
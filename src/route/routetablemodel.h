@@ -0,0 +1,186 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_ROUTETABLEMODEL_H
+#define LITTLENAVMAP_ROUTETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QColor>
+#include <QIcon>
+#include <QVector>
+
+class Route;
+class RouteLeg;
+
+namespace rcol {
+// Route table column indexes
+enum RouteColumns
+{
+  /* Column indexes. Saved through view in RouteLabel::saveState()
+   * Update RouteController::routeColumns and RouteController::routeColumnDescription when adding new values */
+  FIRST_COLUMN,
+  IDENT = FIRST_COLUMN,
+  REGION,
+  NAME,
+  PROCEDURE,
+  AIRWAY_OR_LEGTYPE,
+  RESTRICTION,
+  TYPE,
+  FREQ,
+  RANGE,
+  COURSE,
+  COURSETRUE,
+  DIST,
+  REMAINING_DISTANCE,
+  LEG_TIME,
+  ETA,
+  FUEL_WEIGHT,
+  FUEL_VOLUME,
+  WIND,
+  WIND_HEAD_TAIL,
+  ALTITUDE,
+  SAFE_ALTITUDE,
+  LATITUDE,
+  LONGITUDE,
+  RECOMMENDED,
+  REMARKS,
+  LAST_COLUMN = REMARKS,
+
+  /* Not column names but identifiers for the tree dialog
+   * Not saved directly but state is saved in RouteLabel::saveState() */
+  HEADER_AIRPORTS = 1000,
+  HEADER_TAKEOFF,
+  HEADER_DEPARTURE,
+  HEADER_ARRIVAL,
+  HEADER_LAND,
+  HEADER_DIST_TIME,
+
+  FOOTER_SELECTION = 1500,
+  FOOTER_ERROR,
+};
+
+}
+
+/*
+ * Table model for the flight plan table view. Reads all values directly from the route and its
+ * altitude legs and formats cell texts only when requested by the view.
+ *
+ * Formatted texts and icons are cached per row until the related data changes.
+ * Updates for time, fuel, highlights and active leg emit dataChanged only for the affected
+ * rows and columns instead of rebuilding the whole table.
+ */
+class RouteTableModel :
+  public QAbstractTableModel
+{
+  Q_OBJECT
+
+public:
+  explicit RouteTableModel(QObject *parent, const Route *routeParam);
+  virtual ~RouteTableModel() override;
+
+  virtual int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+  virtual int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+  virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+  virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+  virtual Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+  /* Resets the model after changes to the route structure and drops all cached texts and icons.
+   * Icon size is the size of the symbol in the ident column in pixel. */
+  void updateAll(int iconSizeParam);
+
+  /* Update travel time, fuel, wind and altitude columns after the route altitude was calculated.
+   * Emits dataChanged for these columns only. */
+  void updateTimeFuelWindAlt();
+
+  /* Update colors, fonts and tooltips for procedures and missing objects like waypoints and airways.
+   * Error messages are appended to flightplanErrors. Emits dataChanged only for rows that changed. */
+  void updateHighlights(QStringList& flightplanErrors, bool& trackErrors);
+
+  /* Highlight active leg row with background color and bold font. Updates only old and new active row.
+   * Use -1 to remove highlight. */
+  void setActiveLeg(int activeLegIndexParam, bool highlightParam);
+
+  /* Set header texts and tooltips */
+  void setHeaderLabels(const QStringList& labels);
+  void setHeaderToolTips(const QStringList& toolTips);
+
+  /* Get symbol for leg as used in the ident column */
+  static QIcon iconForLeg(const RouteLeg& leg, int size);
+
+private:
+  /* Formatted texts and icon for one row. Bits in validColumns indicate cached texts. */
+  struct RowCache
+  {
+    QVector<QString> texts;
+    quint32 validColumns = 0;
+    QIcon icon;
+    bool iconValid = false;
+  };
+
+  /* Highlight and error state for one row */
+  struct RowState
+  {
+    bool identInvalid = false, airwayInvalid = false;
+    QString airwayToolTip;
+
+    bool operator==(const RowState& other) const
+    {
+      return identInvalid == other.identInvalid && airwayInvalid == other.airwayInvalid &&
+             airwayToolTip == other.airwayToolTip;
+    }
+
+    bool operator!=(const RowState& other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  /* Get cached text or format it */
+  const QString& cellText(int row, int column) const;
+
+  /* Format text for cell without using the cache */
+  QString formatText(int row, int column) const;
+  QString formatTimeFuelWindAlt(int row, int column) const;
+
+  QVariant foregroundColor(int row, int column) const;
+  QVariant font(int row, int column) const;
+  QVariant toolTip(int row, int column) const;
+
+  /* Recalculate remaining distance, arrival times and fuel per row */
+  void calculateDistances();
+  void calculateTimeFuel();
+
+  const Route *route;
+  int numRows = 0, iconSize = 16;
+
+  mutable QVector<RowCache> cache;
+  QVector<RowState> rowStates;
+
+  /* Accumulated values per row */
+  QVector<float> remainingDistances, arrivalTimes, fuelLbsOrGal;
+
+  /* Values copied from aircraft performance when calculating fuel */
+  bool timeFuelValid = false, fuelFlowValid = false, fuelAsVolume = false, jetFuel = false;
+
+  int activeLegIndex = -1;
+  bool highlightActive = false, night = false;
+  QColor defaultColor, activeColor;
+
+  QStringList headerLabels, headerToolTips;
+};
+
+#endif // LITTLENAVMAP_ROUTETABLEMODEL_H
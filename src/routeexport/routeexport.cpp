@@ -130,17 +130,38 @@ void RouteExport::routeMultiExport()
     // Export - first check constraints for all formats - also updates AIRAC cycle
     if(routeValidate(exportFormatMap->getSelected(), true /* multi */))
     {
+      // Build each adjusted route only once for all formats using the same options
+      adjustedRouteCache.clear();
+      cacheAdjustedRoutes = true;
+
       // Export all button or menu item
       int numExported = 0;
+      QStringList failedFormats;
       for(const RouteExportFormat& fmt : exportFormatMap->getSelected())
       {
         if(fmt.isSelected() && fmt.isPathValid() && fmt.isPatternValid())
-          numExported += fmt.copyForMultiSave().callExport();
+        {
+          if(fmt.copyForMultiSave().callExport())
+            numExported++;
+          else
+            failedFormats.append(fmt.getComment());
+        }
       }
+
+      qDebug() << Q_FUNC_INFO << "Exported" << numExported << "using" << adjustedRouteCache.size() << "adjusted routes";
+
+      cacheAdjustedRoutes = false;
+      adjustedRouteCache.clear();
+
+      QString message;
       if(numExported == 0)
-        mainWindow->setStatusMessage(tr("No flight plan exported."));
+        message = tr("No flight plan exported.");
       else
-        mainWindow->setStatusMessage(tr("Exported %1 flight plans.").arg(numExported));
+        message = tr("Exported %1 flight plans.").arg(numExported);
+
+      if(!failedFormats.isEmpty())
+        message.append(tr(" Not exported: %1.").arg(failedFormats.join(tr(", "))));
+      mainWindow->setStatusMessage(message);
     }
 
     // Check if native LNMPLN was exported, update filename and change status of the file if
@@ -1895,7 +1916,15 @@ QString RouteExport::buildDefaultFilename(const RouteExportFormat& format, bool
 
 Route RouteExport::buildAdjustedRoute(rf::RouteAdjustOptions options)
 {
-  return buildAdjustedRoute(NavApp::getRoute(), options);
+  if(cacheAdjustedRoutes)
+  {
+    int key = static_cast<int>(options);
+    if(!adjustedRouteCache.contains(key))
+      adjustedRouteCache.insert(key, buildAdjustedRoute(NavApp::getRoute(), options));
+    return adjustedRouteCache.value(key);
+  }
+  else
+    return buildAdjustedRoute(NavApp::getRoute(), options);
 }
 
 Route RouteExport::buildAdjustedRoute(const Route& route, rf::RouteAdjustOptions options)
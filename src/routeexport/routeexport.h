@@ -315,6 +315,11 @@ private:
   /* Filled by "formatExportedCallback" when doing a multi export using routeMultiExport() */
   QHash<int, QString> exported;
 
+  /* Adjusted routes by RouteAdjustOptions. Filled by buildAdjustedRoute() and only used while
+   * routeMultiExport() is running since most formats share the same options. */
+  QHash<int, Route> adjustedRouteCache;
+  bool cacheAdjustedRoutes = false;
+
   /* true if any formats are selected for multiexport */
   bool selected = false;
 
@@ -106,7 +106,14 @@ bool RouteStringReader::createRouteFromString(const QString& routeString, rs::Ro
   QElapsedTimer timer;
   timer.start();
 
-  airwayQuery->setUseTracks(!(options & rs::NO_TRACKS));
+  // Drop cached lookups from previous calls unless requested otherwise - also if track usage changes
+  bool useTracks = !(options & rs::NO_TRACKS);
+  if(!keepCache || useTracks != cacheUseTracks)
+    clearCache();
+  cacheUseTracks = useTracks;
+  cacheHits = cacheMisses = 0;
+
+  airwayQuery->setUseTracks(useTracks);
   waypointQuery->setUseTracks(false);
 
   messages.clear();
@@ -404,6 +411,7 @@ bool RouteStringReader::createRouteFromString(const QString& routeString, rs::Ro
     addReport(fp, routeString);
 
 #ifdef DEBUG_INFORMATION
+  qDebug() << Q_FUNC_INFO << "cache hits" << cacheHits << "misses" << cacheMisses;
   qDebug() << "===============================";
   qDebug() << *fp;
 
@@ -1058,7 +1066,7 @@ atools::geo::Pos RouteStringReader::findFirstCoordinate(const QStringList& items
           for(const map::MapWaypoint& w : result.waypoints)
           {
             QList<map::MapWaypoint> waypoints;
-            airwayQuery->getWaypointsForAirway(waypoints, secondItem, w.ident);
+            getWaypointsForAirway(waypoints, secondItem, w.ident);
             if(!waypoints.isEmpty())
               lastPos = w.getPosition();
           }
@@ -1200,7 +1208,7 @@ void RouteStringReader::filterWaypoints(MapResult& result, atools::geo::Pos& las
         {
           QList<map::MapWaypoint> waypoints;
           // Get all waypoints for first
-          airwayQuery->getWaypointsForAirway(waypoints, airwayName, waypointIdent);
+          getWaypointsForAirway(waypoints, airwayName, waypointIdent);
 
           if(!waypoints.isEmpty())
           {
@@ -1319,14 +1327,14 @@ void RouteStringReader::filterAirways(QList<ParseEntry>& resultList, int i)
     }
 
     // Get all waypoints for first
-    airwayQuery->getWaypointsForAirway(waypoints, airwayName, waypointNameStart);
+    getWaypointsForAirway(waypoints, airwayName, waypointNameStart);
 
     if(!waypoints.isEmpty())
     {
       QList<map::MapAirwayWaypoint> allAirwayWaypoints;
 
       // Get all waypoints for the airway sorted by fragment and sequence
-      airwayQuery->getWaypointListForAirwayName(allAirwayWaypoints, airwayName);
+      getWaypointListForAirwayName(allAirwayWaypoints, airwayName);
 
 #ifdef DEBUG_INFORMATION
       for(const map::MapAirwayWaypoint& w : allAirwayWaypoints)
@@ -1404,8 +1412,60 @@ void RouteStringReader::filterAirways(QList<ParseEntry>& resultList, int i)
   }
 }
 
+void RouteStringReader::clearCache()
+{
+  waypointCache.clear();
+  airwayWaypointCache.clear();
+  airwayWaypointListCache.clear();
+}
+
+void RouteStringReader::getWaypointsForAirway(QList<map::MapWaypoint>& waypoints, const QString& airwayName,
+                                              const QString& waypointIdent)
+{
+  std::pair<QString, QString> key(airwayName, waypointIdent);
+  auto it = airwayWaypointCache.constFind(key);
+  if(it != airwayWaypointCache.constEnd())
+  {
+    cacheHits++;
+    waypoints = it.value();
+  }
+  else
+  {
+    cacheMisses++;
+    airwayQuery->getWaypointsForAirway(waypoints, airwayName, waypointIdent);
+    airwayWaypointCache.insert(key, waypoints);
+  }
+}
+
+void RouteStringReader::getWaypointListForAirwayName(QList<map::MapAirwayWaypoint>& waypoints, const QString& airwayName)
+{
+  auto it = airwayWaypointListCache.constFind(airwayName);
+  if(it != airwayWaypointListCache.constEnd())
+  {
+    cacheHits++;
+    waypoints = it.value();
+  }
+  else
+  {
+    cacheMisses++;
+    airwayQuery->getWaypointListForAirwayName(waypoints, airwayName);
+    airwayWaypointListCache.insert(airwayName, waypoints);
+  }
+}
+
 void RouteStringReader::findWaypoints(MapResult& result, const QString& item, bool matchWaypoints)
 {
+  // Same idents appear often in routes and tracks
+  std::pair<QString, bool> key(item, matchWaypoints);
+  auto it = waypointCache.constFind(key);
+  if(it != waypointCache.constEnd())
+  {
+    cacheHits++;
+    result = it.value();
+    return;
+  }
+  cacheMisses++;
+
   bool searchCoords = false;
   if(item.length() > 5)
     // User coordinates for sure
@@ -1450,6 +1510,8 @@ void RouteStringReader::findWaypoints(MapResult& result, const QString& item, bo
       }
     }
   }
+
+  waypointCache.insert(key, result);
 }
 
 QStringList RouteStringReader::cleanItemList(const QStringList& items, float *speedKnots, float *altFeet)
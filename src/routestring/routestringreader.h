@@ -20,9 +20,11 @@
 
 #include "routestring/routestringtypes.h"
 #include "common/mapflags.h"
+#include "common/mapresult.h"
 
 #include <QStringList>
 #include <QCoreApplication>
+#include <QHash>
 
 namespace atools {
 
@@ -107,6 +109,15 @@ public:
     return hasErrors;
   }
 
+  /* Keep resolved idents and airways between calls of createRouteFromString(). Useful when reading many
+   * route strings in a batch like tracks. Cache is cleared for each call by default since the database might change. */
+  void setKeepCache(bool value)
+  {
+    keepCache = value;
+  }
+
+  void clearCache();
+
 private:
   /* Internal parsing structure which holds all found potential candidates from a search */
   struct ParseEntry;
@@ -135,9 +146,14 @@ private:
                          map::MapTypes types);
 
   /* Get airport or any navaid for item. Also resolves coordinate formats. Optionally tries to match position
-   * to waypoints like oceaninc or confluence points.*/
+   * to waypoints like oceaninc or confluence points. Result has to be empty. Uses cache.*/
   void findWaypoints(map::MapResult& result, const QString& item, bool matchWaypoints);
 
+  /* Cached versions of AirwayTrackQuery::getWaypointsForAirway() and getWaypointListForAirwayName() */
+  void getWaypointsForAirway(QList<map::MapWaypoint>& waypoints, const QString& airwayName,
+                             const QString& waypointIdent);
+  void getWaypointListForAirwayName(QList<map::MapAirwayWaypoint>& waypoints, const QString& airwayName);
+
   /* Get nearest waypoint for given position probably removing ones which are too far away. Changes given result.
    * Also checks airways and connections if lastResult is given. */
   void filterWaypoints(map::MapResult& result, atools::geo::Pos& lastPos, const atools::geo::Pos& destPos, const map::MapResult *lastResult,
@@ -191,6 +207,13 @@ private:
   FlightplanEntryBuilder *entryBuilder = nullptr;
   QStringList messages;
   bool plaintextMessages = false, hasWarnings = false, hasErrors = false;
+
+  /* Lookup caches. Key for waypoints is item and matchWaypoints flag */
+  QHash<std::pair<QString, bool>, map::MapResult> waypointCache;
+  QHash<std::pair<QString, QString>, QList<map::MapWaypoint> > airwayWaypointCache;
+  QHash<QString, QList<map::MapAirwayWaypoint> > airwayWaypointListCache;
+  bool keepCache = false, cacheUseTracks = false;
+  int cacheHits = 0, cacheMisses = 0;
 };
 
 #endif // LITTLENAVMAP_ROUTESTRINGREADER_H
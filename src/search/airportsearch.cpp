@@ -35,7 +35,7 @@
 #include "search/column.h"
 #include "search/columnlist.h"
 #include "search/sqlmodel.h"
-#include "search/randomdepartureairportpickingbycriteria.h"
+#include "search/randomflightplangenerator.h"
 #include "search/sqlcontroller.h"
 #include "settings/settings.h"
 #include "sql/sqlrecord.h"
@@ -43,7 +43,9 @@
 
 #include <QMessageBox>
 #include <QProgressDialog>
+#include <QRandomGenerator>
 #include <QStringBuilder>
+#include <QtConcurrent/QtConcurrentRun>
 
 /* Default values for minimum and maximum random flight plan distance */
 const static float FLIGHTPLAN_MIN_DISTANCE_DEFAULT_NM = 0.f;
@@ -266,6 +268,11 @@ AirportSearch::AirportSearch(QMainWindow *parent, QTableView *tableView, si::Tab
 
 AirportSearch::~AirportSearch()
 {
+  // Stop random flight search and wait for thread
+  randomFlightplanCanceled.storeRelease(1);
+  randomFlightplanWatcher.disconnect(this);
+  randomFlightplanFuture.waitForFinished();
+
   delete iconDelegate;
   delete unitStringTool;
 }
@@ -378,6 +385,8 @@ void AirportSearch::connectSearchSlots()
   connect(ui->pushButtonAirportSearchReset, &QPushButton::clicked, this, &AirportSearch::resetSearch);
 
   connect(ui->pushButtonAirportFlightplanSearch, &QPushButton::clicked, this, &AirportSearch::randomFlightplanClicked);
+  connect(&randomFlightplanWatcher, &QFutureWatcher<QVector<std::pair<int, int> > >::finished,
+          this, &AirportSearch::randomFlightplanFinished);
   connect(ui->spinBoxAirportFlightplanMinSearch, QOverload<int>::of(&QSpinBox::valueChanged),
           this, &AirportSearch::updateRandomFlightplanDistance);
   connect(ui->spinBoxAirportFlightplanMaxSearch, QOverload<int>::of(&QSpinBox::valueChanged),
@@ -785,64 +794,51 @@ void AirportSearch::randomFlightplanClicked()
   float distanceMinMeter = Unit::rev(ui->spinBoxAirportFlightplanMinSearch->value(), Unit::distMeterF);
   float distanceMaxMeter = Unit::rev(ui->spinBoxAirportFlightplanMaxSearch->value(), Unit::distMeterF);
 
-  // Log minimum and maximum distance from UI
-  qDebug() << Q_FUNC_INFO << "random flight, distance min: " << distanceMinMeter
-           << ", random flight, distance max: " << distanceMaxMeter;
-
-  // Fetch data from SQL model
-  // create new for threads, delete in method receiving result
-  QVector<std::pair<int, atools::geo::Pos> > *result = new QVector<std::pair<int, atools::geo::Pos> >();
-  controller->getSqlModel()->getFullResultSet(*result);
-
-  const int countResult = result->size();
+  // Fetch data from SQL model - copy is passed to the thread
+  QVector<std::pair<int, atools::geo::Pos> > airports;
+  controller->getSqlModel()->getFullResultSet(airports);
 
-  qDebug() << Q_FUNC_INFO << "random flight, count source airports: " << countResult;
+  // New seed for each click - allows to reproduce a result from the log
+  quint32 seed = QRandomGenerator::global()->generate();
 
-  // above this limit do not try to find a random value beacuse this will only have few "space" to "pick" from many already picked
-  const int randomLimit = countResult / 10 * 7;
+  qDebug() << Q_FUNC_INFO << "random flight, distance min" << distanceMinMeter << "max" << distanceMaxMeter
+           << "count source airports" << airports.size() << "seed" << seed;
 
-  // maximum equals seconds to 100% (per attempted departure)
-  progress = new QProgressDialog(tr("random picking and criteria comparison running..."),
-                                 tr("Abort running"), 0, 30, NavApp::getQMainWidget());
+  // Busy indicator only since grid search is usually quick
+  progress = new QProgressDialog(tr("Looking for random flight ..."), tr("Cancel"), 0, 0, NavApp::getQMainWidget());
   progress->setWindowModality(Qt::ApplicationModal);
   progress->setAutoClose(false);
-  progress->setValue(progress->minimum());
+  progress->setValue(0);
 
   // Let progress dialog pop up early to block application
   // Allows to avoid waiting cursor
   progress->setMinimumDuration(200); // see https://doc.qt.io/qt-5/qprogressdialog.html#value-prop . Issues with Modal include non-showing of the progress bar.
+  connect(progress, &QProgressDialog::canceled, this, [this]() -> void {
+    randomFlightplanCanceled.storeRelease(1);
+  });
 
   // Disable button to avoid multiple clicks
   ui->pushButtonAirportFlightplanSearch->setDisabled(true);
 
-  RandomDepartureAirportPickingByCriteria::initStatics(countResult, randomLimit, result,
-                                                       atools::roundToInt(distanceMinMeter),
-                                                       atools::roundToInt(distanceMaxMeter));
-  RandomDepartureAirportPickingByCriteria *departurePicker = new RandomDepartureAirportPickingByCriteria(this);
-  connect(progress, &QProgressDialog::canceled, departurePicker,
-          &RandomDepartureAirportPickingByCriteria::cancellationReceived);
-  connect(departurePicker, &RandomDepartureAirportPickingByCriteria::progressing, this, &AirportSearch::progressing);
-  connect(departurePicker, &RandomDepartureAirportPickingByCriteria::resultReady, this,
-          &AirportSearch::dataRandomAirportsReceived);
-  connect(departurePicker, &RandomDepartureAirportPickingByCriteria::finished, departurePicker, &QObject::deleteLater);
-  departurePicker->start();
-}
+  randomFlightplanCanceled.storeRelease(0);
 
-void AirportSearch::progressing()
-{
-  if(progress != nullptr)
-  {
-    progress->setValue((progress->value() + 1) % progress->maximum() + 1);
-  }
+  // Generator is created in the thread since building the grid is part of the work
+  randomFlightplanFuture = QtConcurrent::run([airports, distanceMinMeter, distanceMaxMeter, seed,
+                                              this]() -> QVector<std::pair<int, int> > {
+    RandomFlightplanGenerator generator(airports, distanceMinMeter, distanceMaxMeter);
+    return generator.generate(1, seed, &randomFlightplanCanceled);
+  });
+
+  // Watcher will call AirportSearch::randomFlightplanFinished() when done
+  randomFlightplanWatcher.setFuture(randomFlightplanFuture);
 }
 
-void AirportSearch::dataRandomAirportsReceived(bool isSuccess, int indexDeparture, int indexDestination,
-                                               QVector<std::pair<int, atools::geo::Pos> > *data)
+void AirportSearch::randomFlightplanFinished()
 {
   // Check if user pressed cancel in the progress dialog
-  bool canceled = progress->wasCanceled();
+  bool canceled = randomFlightplanCanceled.loadAcquire() != 0;
   progress->hide();
-  delete progress;
+  progress->deleteLater();
   progress = nullptr;
 
   // Enable button again
@@ -851,14 +847,15 @@ void AirportSearch::dataRandomAirportsReceived(bool isSuccess, int indexDepartur
   // Do not show any dialogs at all if user canceled
   if(!canceled)
   {
-    if(isSuccess)
+    QVector<std::pair<int, int> > plans = randomFlightplanFuture.result();
+    if(!plans.isEmpty())
     {
-      qDebug() << Q_FUNC_INFO << "random flight, index departure: " << indexDeparture
-               << ", random flight, index destination: " << indexDestination;
+      qDebug() << Q_FUNC_INFO << "random flight, departure id" << plans.constFirst().first
+               << "destination id" << plans.constFirst().second;
 
       AirportQuery *airportQuery = NavApp::getAirportQuerySim();
-      map::MapAirport airportDeparture = airportQuery->getAirportById(data->at(indexDeparture).first);
-      map::MapAirport airportDestination = airportQuery->getAirportById(data->at(indexDestination).first);
+      map::MapAirport airportDeparture = airportQuery->getAirportById(plans.constFirst().first);
+      map::MapAirport airportDestination = airportQuery->getAirportById(plans.constFirst().second);
 
       // Show a question dialog before taking over plan - avoids "flight plan has changed" nagging dialog
       QString text(tr("<p><b>%1</b> to <b>%2</b></p><p>Direct distance: %3</p>").
@@ -891,6 +888,4 @@ void AirportSearch::dataRandomAirportsReceived(bool isSuccess, int indexDepartur
       msgBox.exec();
     }
   }
-
-  delete data; // delete data created for threads
 }
@@ -20,6 +20,9 @@
 
 #include "search/searchbasetable.h"
 
+#include <QAtomicInt>
+#include <QFutureWatcher>
+
 class Column;
 class AirportIconDelegate;
 class QAction;
@@ -58,11 +61,6 @@ public:
   virtual void postDatabaseLoad() override;
   virtual void resetSearch() override;
 
-public slots:
-  void progressing();
-  void dataRandomAirportsReceived(bool isSuccess, int indexDeparture, int indexDestination,
-                                  QVector<std::pair<int, atools::geo::Pos> > *data);
-
 private:
   virtual void updateButtonMenu() override;
   virtual void saveViewState(bool distSearchActive) override;
@@ -85,6 +83,9 @@ private:
   /* UI push button clicked */
   void randomFlightplanClicked();
 
+  /* Called by watcher when random flight plan thread is finished */
+  void randomFlightplanFinished();
+
   /* Update min/max values in random flight plan spin boxes */
   void updateRandomFlightplanDistance();
 
@@ -101,6 +102,11 @@ private:
   UnitStringTool *unitStringTool;
 
   QProgressDialog *progress = nullptr;
+
+  /* Random flight plan search running in background. Result is list of departure and destination airport ids. */
+  QFuture<QVector<std::pair<int, int> > > randomFlightplanFuture;
+  QFutureWatcher<QVector<std::pair<int, int> > > randomFlightplanWatcher;
+  QAtomicInt randomFlightplanCanceled;
 };
 
 #endif // LITTLENAVMAP_AIRPORTSEARCH_H
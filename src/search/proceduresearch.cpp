@@ -335,6 +335,10 @@ void ProcedureSearch::showProcedures(const map::MapAirport& airport, bool depart
 
   airportQueryNav->getAirportByIdent(*currentAirportNav, navAirport.ident);
 
+  // Load all procedures at once instead of one by one when expanding or hovering tree items
+  if(currentAirportNav->isValid() && currentAirportNav->procedure())
+    procedureQuery->preloadProcedures(*currentAirportNav);
+
   updateFilterBoxes();
 
   fillProcedureTreeWidget();
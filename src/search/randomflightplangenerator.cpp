@@ -0,0 +1,168 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#include "search/randomflightplangenerator.h"
+
+#include "atools.h"
+#include "geo/calculations.h"
+
+#include <QAtomicInt>
+#include <QRandomGenerator>
+#include <QtMath>
+
+/* Grid dimensions for one degree cells */
+const static int GRID_COLUMNS = 360;
+const static int GRID_ROWS = 180;
+
+/* Length of one degree latitude */
+const static float METER_PER_DEGREE = atools::geo::nmToMeter(60.f);
+
+/* Maximum distance from a cell center to any point in the cell plus some margin */
+const static float CELL_RADIUS_METER = 80000.f;
+
+RandomFlightplanGenerator::RandomFlightplanGenerator(const QVector<std::pair<int, atools::geo::Pos> >& airports,
+                                                     float distanceMinMeter, float distanceMaxMeter)
+  : distanceMin(distanceMinMeter), distanceMax(distanceMaxMeter)
+{
+  positions.reserve(airports.size());
+  ids.reserve(airports.size());
+  for(const std::pair<int, atools::geo::Pos>& airport : airports)
+  {
+    if(airport.second.isValid())
+    {
+      ids.append(airport.first);
+      positions.append(airport.second);
+    }
+  }
+
+  // Counting sort of all position indexes by grid cell ========================
+  cellStart.fill(0, GRID_COLUMNS * GRID_ROWS + 1);
+  for(const atools::geo::Pos& pos : positions)
+    cellStart[cellIndex(pos.getLonX(), pos.getLatY()) + 1]++;
+
+  for(int i = 1; i < cellStart.size(); i++)
+    cellStart[i] += cellStart.at(i - 1);
+
+  QVector<int> fill(cellStart);
+  cellIndexes.resize(positions.size());
+  for(int i = 0; i < positions.size(); i++)
+    cellIndexes[fill[cellIndex(positions.at(i).getLonX(), positions.at(i).getLatY())]++] = i;
+}
+
+QVector<std::pair<int, int> > RandomFlightplanGenerator::generate(int numPlans, quint32 seed,
+                                                                   const QAtomicInt *canceled) const
+{
+  QVector<std::pair<int, int> > result;
+  QRandomGenerator random(seed);
+
+  QVector<int> departures(positions.size());
+  for(int i = 0; i < departures.size(); i++)
+    departures[i] = i;
+
+  // Lazy Fisher-Yates shuffle - draw departures without repetition until enough plans are found
+  QVector<int> candidates;
+  for(int i = departures.size() - 1; i >= 0 && result.size() < numPlans; i--)
+  {
+    if(canceled != nullptr && canceled->loadAcquire() != 0)
+      break;
+
+    std::swap(departures[i], departures[static_cast<int>(random.bounded(i + 1))]);
+    int departure = departures.at(i);
+
+    candidates.clear();
+    destinationCandidates(candidates, departure);
+
+    if(!candidates.isEmpty())
+      result.append(std::make_pair(ids.at(departure),
+                                   ids.at(candidates.at(static_cast<int>(random.bounded(candidates.size()))))));
+  }
+  return result;
+}
+
+void RandomFlightplanGenerator::destinationCandidates(QVector<int>& candidates, int departure) const
+{
+  const atools::geo::Pos& pos = positions.at(departure);
+
+  // Angular radius of the cap around departure including margin for earth radius differences
+  float radiusDeg = distanceMax / METER_PER_DEGREE * 1.01f + 1.f;
+  int rowMin = std::max(0, static_cast<int>(std::floor(pos.getLatY() - radiusDeg + 90.f)));
+  int rowMax = std::min(GRID_ROWS - 1, static_cast<int>(std::floor(pos.getLatY() + radiusDeg + 90.f)));
+
+  // Longitude extent of a spherical cap - covers all longitudes if the cap contains a pole
+  bool allLon = radiusDeg >= 90.f;
+  float lonHalfDeg = 180.f;
+  if(!allLon)
+  {
+    double sinRadius = std::sin(atools::geo::toRadians(static_cast<double>(radiusDeg)));
+    double cosLat = std::cos(atools::geo::toRadians(static_cast<double>(pos.getLatY())));
+    if(sinRadius >= cosLat)
+      allLon = true;
+    else
+      lonHalfDeg = static_cast<float>(atools::geo::toDegree(std::asin(sinRadius / cosLat))) + 1.f;
+  }
+
+  int colMin = static_cast<int>(std::floor(pos.getLonX() - lonHalfDeg + 180.f));
+  int colMax = static_cast<int>(std::floor(pos.getLonX() + lonHalfDeg + 180.f));
+  if(allLon || colMax - colMin >= GRID_COLUMNS - 1)
+  {
+    colMin = 0;
+    colMax = GRID_COLUMNS - 1;
+  }
+
+  for(int row = rowMin; row <= rowMax; row++)
+    cellCandidates(candidates, departure, row, colMin, colMax);
+}
+
+void RandomFlightplanGenerator::cellCandidates(QVector<int>& candidates, int departure, int latRow,
+                                               int lonMinCell, int lonMaxCell) const
+{
+  const atools::geo::Pos& pos = positions.at(departure);
+
+  for(int col = lonMinCell; col <= lonMaxCell; col++)
+  {
+    // Wrap around anti-meridian
+    int cell = latRow * GRID_COLUMNS + ((col % GRID_COLUMNS) + GRID_COLUMNS) % GRID_COLUMNS;
+    int start = cellStart.at(cell), end = cellStart.at(cell + 1);
+    if(start == end)
+      continue;
+
+    // Skip cells which are completely inside the minimum or outside the maximum distance
+    atools::geo::Pos center(static_cast<float>(cell % GRID_COLUMNS) - 180.f + 0.5f,
+                            static_cast<float>(latRow) - 90.f + 0.5f);
+    float centerDist = pos.distanceMeterTo(center);
+    if(centerDist + CELL_RADIUS_METER < distanceMin || centerDist - CELL_RADIUS_METER > distanceMax)
+      continue;
+
+    for(int i = start; i < end; i++)
+    {
+      int index = cellIndexes.at(i);
+      if(index != departure)
+      {
+        float dist = pos.distanceMeterTo(positions.at(index));
+        if(dist >= distanceMin && dist <= distanceMax)
+          candidates.append(index);
+      }
+    }
+  }
+}
+
+int RandomFlightplanGenerator::cellIndex(float lonX, float latY)
+{
+  int col = atools::minmax(0, GRID_COLUMNS - 1, static_cast<int>(std::floor(lonX + 180.f)));
+  int row = atools::minmax(0, GRID_ROWS - 1, static_cast<int>(std::floor(latY + 90.f)));
+  return row * GRID_COLUMNS + col;
+}
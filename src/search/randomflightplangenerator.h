@@ -0,0 +1,78 @@
+/*****************************************************************************
+* Copyright 2015-2020 Alexander Barthel alex@littlenavmap.org
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*****************************************************************************/
+
+#ifndef LITTLENAVMAP_RANDOMFLIGHTPLANGENERATOR_H
+#define LITTLENAVMAP_RANDOMFLIGHTPLANGENERATOR_H
+
+#include "geo/pos.h"
+
+#include <QVector>
+
+class QAtomicInt;
+
+/*
+ * Picks random departure and destination airport pairs from a search result set where the
+ * direct distance is between a given minimum and maximum.
+ *
+ * Positions are put into a grid of one by one degree cells on construction. Destinations are
+ * then collected by visiting only the cells that can overlap the distance annulus around a
+ * departure instead of trying random indexes.
+ *
+ * All methods are const and the class has no static state. It is safe to use one instance from
+ * several threads or to use separate instances in parallel.
+ */
+class RandomFlightplanGenerator
+{
+public:
+  /* airports is a list of airport id and position pairs as returned by SqlModel::getFullResultSet().
+   * Entries with invalid positions are ignored. */
+  RandomFlightplanGenerator(const QVector<std::pair<int, atools::geo::Pos> >& airports, float distanceMinMeter,
+                            float distanceMaxMeter);
+
+  /* Generate up to numPlans pairs of departure and destination airport ids. Each plan has a different departure.
+   * Result is the same for the same seed and airport list.
+   * Stops early and returns what was found so far if canceled is not null and set to a value != 0.
+   * Returns fewer than numPlans entries or an empty list if not enough airports satisfy the criteria. */
+  QVector<std::pair<int, int> > generate(int numPlans, quint32 seed, const QAtomicInt *canceled = nullptr) const;
+
+  /* Number of airports with valid coordinates */
+  int size() const
+  {
+    return positions.size();
+  }
+
+private:
+  /* Get all indexes to positions within the distance annulus around departure index. Excludes departure. */
+  void destinationCandidates(QVector<int>& candidates, int departure) const;
+
+  /* Grid cell index for position */
+  static int cellIndex(float lonX, float latY);
+
+  /* Add all cells for latitude row to candidates. Cells from lonMin to lonMax are normalized to -180 - 180 */
+  void cellCandidates(QVector<int>& candidates, int departure, int latRow, int lonMinCell, int lonMaxCell) const;
+
+  /* Filtered valid positions and their airport ids. Index is the same for both. */
+  QVector<atools::geo::Pos> positions;
+  QVector<int> ids;
+
+  /* Compressed grid. Indexes into positions for cell c are cellIndexes[cellStart[c]] to cellIndexes[cellStart[c + 1] - 1] */
+  QVector<int> cellStart, cellIndexes;
+
+  float distanceMin, distanceMax;
+};
+
+#endif // LITTLENAVMAP_RANDOMFLIGHTPLANGENERATOR_H
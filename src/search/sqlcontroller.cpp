@@ -296,7 +296,6 @@ void SqlController::filterByDistance(const atools::geo::Pos& center, sqlmodeltyp
     view->clearSelection();
 
     currentDistanceCenter = center;
-    atools::geo::Rect rect(center, atools::geo::nmToMeter(maxDistance));
 
     bool proxyWasNull = false;
     if(proxyModel == nullptr)
@@ -314,8 +313,8 @@ void SqlController::filterByDistance(const atools::geo::Pos& center, sqlmodeltyp
     // Update distances in proxy to get precise radius filtering (second filter stage)
     proxyModel->setDistanceFilter(center, dir, minDistance, maxDistance);
 
-    // Update rectangle filter in query model (first coarse filter stage)
-    model->filterByBoundingRect(rect);
+    // Update rectangle and approximate circle filter in query model (first coarse filter stage)
+    model->filterByDistance(center, atools::geo::nmToMeter(maxDistance));
 
     if(proxyWasNull)
     {
@@ -356,13 +355,11 @@ void SqlController::filterByDistanceUpdate(sqlmodeltypes::SearchDirection dir, f
   if(proxyModel != nullptr)
   {
     view->clearSelection();
-    // Create new bounding rectangle for first stage search
-    atools::geo::Rect rect(currentDistanceCenter, atools::geo::nmToMeter(maxDistance));
 
     // Update proxy second stage filter
     proxyModel->setDistanceFilter(currentDistanceCenter, dir, minDistance, maxDistance);
-    // Update SQL model coarse first stage filter
-    model->filterByBoundingRect(rect);
+    // Update SQL model coarse first stage filter with bounding rectangle and approximate circle
+    model->filterByDistance(currentDistanceCenter, atools::geo::nmToMeter(maxDistance));
     searchParamsChanged = true;
   }
 }
@@ -22,6 +22,7 @@
 #include "sql/sqldatabase.h"
 #include "sql/sqlquery.h"
 #include "exception.h"
+#include "geo/calculations.h"
 #include "search/column.h"
 #include "search/columnlist.h"
 #include "sql/sqlrecord.h"
@@ -72,6 +73,16 @@ void SqlModel::filterExcluding(QModelIndex index, bool forceQueryBuilder)
 void SqlModel::filterByBoundingRect(const atools::geo::Rect& boundingRectangle)
 {
   boundingRect = boundingRectangle;
+  distanceCenter = atools::geo::Pos();
+  distanceMaxMeter = 0.f;
+  buildQuery();
+}
+
+void SqlModel::filterByDistance(const atools::geo::Pos& center, float maxDistanceMeter)
+{
+  boundingRect = atools::geo::Rect(center, maxDistanceMeter);
+  distanceCenter = center;
+  distanceMaxMeter = maxDistanceMeter;
   buildQuery();
 }
 
@@ -338,6 +349,8 @@ void SqlModel::clearWhereConditions()
 {
   whereConditionMap.clear();
   boundingRect = atools::geo::Rect();
+  distanceCenter = atools::geo::Pos();
+  distanceMaxMeter = 0.f;
 }
 
 /* Set header captions */
@@ -620,6 +633,24 @@ QString SqlModel::buildWhere(const atools::sql::SqlRecord& tableCols, QVector<co
     if(!queryWhere.isEmpty())
       queryWhere += WHERE_OPERATOR;
     queryWhere += rectCond;
+
+    // Cut off the corners of the rectangle by using a planar approximation of the distance in degrees.
+    // Longitude is scaled by the cosine of the latitude farthest from the equator which
+    // underestimates the distance and keeps the result a superset of the precise circle.
+    // Not used across the anti-meridian since the longitude difference wraps there.
+    if(distanceCenter.isValid() && distanceMaxMeter > 0.f && !boundingRect.crossesAntiMeridian())
+    {
+      float maxLat = std::min(std::max(std::abs(boundingRect.getTopLeft().getLatY()),
+                                       std::abs(boundingRect.getBottomRight().getLatY())), 90.f);
+      double lonScale = std::cos(atools::geo::toRadians(static_cast<double>(maxLat)));
+      // Add a margin to cover the error of the planar approximation
+      double radiusDeg = atools::geo::meterToNm(distanceMaxMeter) / 60. * 1.05;
+
+      queryWhere += WHERE_OPERATOR;
+      queryWhere += QString("((laty - %1) * (laty - %1) + (lonx - %2) * (lonx - %2) * %3 <= %4)").
+                    arg(distanceCenter.getLatY(), 0, 'f', 8).arg(distanceCenter.getLonX(), 0, 'f', 8).
+                    arg(lonScale * lonScale, 0, 'f', 8).arg(radiusDeg * radiusDeg, 0, 'f', 8);
+    }
   }
 
   if(!queryWhere.isEmpty())
@@ -125,6 +125,11 @@ public:
   /* Set a filter for objects within the given bounding rectangle */
   void filterByBoundingRect(const atools::geo::Rect& boundingRectangle);
 
+  /* Set a filter for objects within the bounding rectangle of the circle around center.
+   * Adds an approximate planar distance condition to the where clause which returns a small superset
+   * of the objects within maxDistanceMeter. Precise filtering is done in SqlProxyModel. */
+  void filterByDistance(const atools::geo::Pos& center, float maxDistanceMeter);
+
   QString getColumnName(int col) const;
 
   /* Set sort order for the given column name. Does not update or restart the query */
@@ -217,6 +222,10 @@ private:
   /* A bounding rectangle query is used if this is valid */
   atools::geo::Rect boundingRect;
 
+  /* Additional approximate circle filter is added inside the bounding rectangle if center is valid */
+  atools::geo::Pos distanceCenter;
+  float distanceMaxMeter = 0.f;
+
   QueryBuilder queryBuilder;
 
   /* Maps column name to where condition struct */
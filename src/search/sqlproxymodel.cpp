@@ -21,6 +21,7 @@
 #include "search/sqlmodel.h"
 #include "common/unit.h"
 #include "common/mapflags.h"
+#include "sql/sqlrecord.h"
 
 #include <QApplication>
 
@@ -29,6 +30,9 @@ using namespace atools::geo;
 SqlProxyModel::SqlProxyModel(QObject *parent, SqlModel *sqlModel)
   : QSortFilterProxyModel(parent), sourceSqlModel(sqlModel)
 {
+  // Connected before the proxy connects its own slots in setSourceModel() - cache is cleared before filtering again
+  connect(sourceSqlModel, &QAbstractItemModel::modelReset, this, &SqlProxyModel::sourceModelWasReset);
+  sourceModelWasReset();
 }
 
 SqlProxyModel::~SqlProxyModel()
@@ -43,11 +47,40 @@ void SqlProxyModel::setDistanceFilter(const Pos& center, sqlmodeltypes::SearchDi
   maxDistMeter = nmToMeter(maxDistance);
   centerPos = center;
   direction = dir;
+  rowGeometryCache.clear();
 }
 
 void SqlProxyModel::clearDistanceFilter()
 {
   centerPos = Pos();
+  rowGeometryCache.clear();
+}
+
+void SqlProxyModel::sourceModelWasReset()
+{
+  rowGeometryCache.clear();
+
+  atools::sql::SqlRecord record = sourceSqlModel->getSqlRecord();
+  lonxCol = record.indexOf("lonx");
+  latyCol = record.indexOf("laty");
+  distanceCol = record.indexOf("distance");
+  headingCol = record.indexOf("heading");
+}
+
+const SqlProxyModel::RowGeometry& SqlProxyModel::rowGeometry(int row) const
+{
+  if(row >= rowGeometryCache.size())
+    // Rows are added by fetchMore() - mark new ones as not calculated
+    rowGeometryCache.resize(std::max(row + 1, sourceSqlModel->rowCount()));
+
+  RowGeometry& geometry = rowGeometryCache[row];
+  if(geometry.distMeter < 0.f)
+  {
+    Pos pos(sourceSqlModel->getRawData(row, lonxCol).toFloat(), sourceSqlModel->getRawData(row, latyCol).toFloat());
+    geometry.distMeter = pos.distanceMeterTo(centerPos);
+    geometry.headingDeg = normalizeCourse(centerPos.angleDegTo(pos));
+  }
+  return geometry;
 }
 
 /* Does the filtering by minimum and maximum distance and direction */
@@ -56,48 +89,47 @@ bool SqlProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex&) const
   if(sourceSqlModel->isOverrideModeActive())
     return true;
 
-  Pos pos = buildPos(sourceRow);
-  float heading = normalizeCourse(centerPos.angleDegTo(pos));
+  const RowGeometry& geometry = rowGeometry(sourceRow);
+  float heading = geometry.headingDeg;
 
   switch(direction)
   {
     case sqlmodeltypes::ALL:
       // All directions
-      return matchDistance(pos);
+      return matchDistance(geometry.distMeter);
 
     case sqlmodeltypes::NORTH:
       if(MIN_NORTH_DEG <= heading || heading <= MAX_NORTH_DEG)
-        return matchDistance(pos);
+        return matchDistance(geometry.distMeter);
       else
         return false;
 
     case sqlmodeltypes::EAST:
       if(MIN_EAST_DEG <= heading && heading <= MAX_EAST_DEG)
-        return matchDistance(pos);
+        return matchDistance(geometry.distMeter);
       else
         return false;
 
     case sqlmodeltypes::SOUTH:
       if(MIN_SOUTH_DEG <= heading && heading <= MAX_SOUTH_DEG)
-        return matchDistance(pos);
+        return matchDistance(geometry.distMeter);
       else
         return false;
 
     case sqlmodeltypes::WEST:
       if(MIN_WEST_DEG <= heading && heading <= MAX_WEST_DEG)
-        return matchDistance(pos);
+        return matchDistance(geometry.distMeter);
       else
         return false;
   }
   return true;
 }
 
-bool SqlProxyModel::matchDistance(const Pos& pos) const
+bool SqlProxyModel::matchDistance(float distMeter) const
 {
   if(sourceSqlModel->isOverrideModeActive())
     return true;
 
-  float distMeter = pos.distanceMeterTo(centerPos);
   return distMeter >= minDistMeter && distMeter <= maxDistMeter;
 }
 
@@ -123,23 +155,12 @@ QVariant SqlProxyModel::headerData(int section, Qt::Orientation orientation, int
 /* Defines greater and lower than for sorting of the two columns distance and heading */
 bool SqlProxyModel::lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight) const
 {
-  QString leftCol = sourceSqlModel->getColumnName(sourceLeft.column());
-  QString rightCol = sourceSqlModel->getColumnName(sourceRight.column());
-
-  if(leftCol == "distance" && rightCol == "distance")
-  {
+  if(sourceLeft.column() == distanceCol && sourceRight.column() == distanceCol)
     // Sort by distance
-    float distLeft = buildPos(sourceLeft.row()).distanceMeterTo(centerPos);
-    float distRight = buildPos(sourceRight.row()).distanceMeterTo(centerPos);
-    return distLeft < distRight;
-  }
-  else if(leftCol == "heading" && rightCol == "heading")
-  {
+    return rowGeometry(sourceLeft.row()).distMeter < rowGeometry(sourceRight.row()).distMeter;
+  else if(sourceLeft.column() == headingCol && sourceRight.column() == headingCol)
     // Sort by heading
-    float headingLeft = normalizeCourse(centerPos.angleDegTo(buildPos(sourceLeft.row())));
-    float headingRight = normalizeCourse(centerPos.angleDegTo(buildPos(sourceRight.row())));
-    return headingLeft < headingRight;
-  }
+    return rowGeometry(sourceLeft.row()).headingDeg < rowGeometry(sourceRight.row()).headingDeg;
   else
     // Let the model do the sorting for other columns
     return QSortFilterProxyModel::lessThan(sourceLeft, sourceRight);
@@ -148,18 +169,18 @@ bool SqlProxyModel::lessThan(const QModelIndex& sourceLeft, const QModelIndex& s
 /* Returns the formatted data for the "distance" and "heading" column */
 QVariant SqlProxyModel::data(const QModelIndex& index, int role) const
 {
-  if(sourceSqlModel->getColumnName(index.column()) == "distance")
+  if(index.column() == distanceCol)
   {
     if(role == Qt::DisplayRole)
-      return Unit::distMeter(buildPos(mapToSource(index).row()).distanceMeterTo(centerPos), false);
+      return Unit::distMeter(rowGeometry(mapToSource(index).row()).distMeter, false);
     else if(role == Qt::TextAlignmentRole)
       return Qt::AlignRight;
   }
-  else if(sourceSqlModel->getColumnName(index.column()) == "heading")
+  else if(index.column() == headingCol)
   {
     if(role == Qt::DisplayRole)
     {
-      float heading = normalizeCourse(centerPos.angleDegTo(buildPos(mapToSource(index).row())));
+      float heading = rowGeometry(mapToSource(index).row()).headingDeg;
       if(heading < map::INVALID_COURSE_VALUE)
         return QLocale().toString(heading, 'f', 0);
       else
@@ -171,8 +192,3 @@ QVariant SqlProxyModel::data(const QModelIndex& index, int role) const
 
   return QSortFilterProxyModel::data(index, role);
 }
-
-Pos SqlProxyModel::buildPos(int row) const
-{
-  return Pos(sourceSqlModel->getRawData(row, "lonx").toFloat(), sourceSqlModel->getRawData(row, "laty").toFloat());
-}
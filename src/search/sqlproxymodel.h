@@ -31,6 +31,9 @@ class SqlModel;
  * and direction.
  * Dynamic loading on demand (like the SQL model does) does not work with this model. Therefore all results
  * have to be fetched.
+ *
+ * Distance and heading are calculated only once per source row and kept in a cache which is used for
+ * filtering, sorting and display. The cache is cleared when the source model is reset or the filter changes.
  */
 class SqlProxyModel :
   public QSortFilterProxyModel
@@ -62,8 +65,19 @@ private:
   virtual bool filterAcceptsRow(int sourceRow, const QModelIndex&) const override;
   virtual bool lessThan(const QModelIndex& sourceLeft, const QModelIndex& sourceRight) const override;
 
-  bool matchDistance(const atools::geo::Pos& pos) const;
-  atools::geo::Pos buildPos(int row) const;
+  /* Distance to center and heading from center for a source row */
+  struct RowGeometry
+  {
+    float distMeter = -1.f, headingDeg = 0.f;
+  };
+
+  bool matchDistance(float distMeter) const;
+
+  /* Get cached distance and heading for row. Calculates and fills cache if needed. */
+  const RowGeometry& rowGeometry(int row) const;
+
+  /* Clear cache and get column indexes from current source model record */
+  void sourceModelWasReset();
 
   /* Direction filter ranges are decreased by this value on each side */
   static float Q_DECL_CONSTEXPR DIR_RANGE_DEG = 22.5f;
@@ -79,6 +93,11 @@ private:
   sqlmodeltypes::SearchDirection direction;
   float minDistMeter = 0.f, maxDistMeter = 0.f;
 
+  /* Indexed by source row. distMeter is negative for rows which were not calculated yet. */
+  mutable QVector<RowGeometry> rowGeometryCache;
+
+  /* Column indexes in source model or -1 if not available */
+  int lonxCol = -1, latyCol = -1, distanceCol = -1, headingCol = -1;
 };
 
 #endif // LITTLENAVMAP_SQLPROXYMODEL_H
@@ -113,6 +113,9 @@ void TrackManager::loadTracks(const TrackVectorType& tracks, bool onlyValid)
   RouteStringReader reader(&builder);
   reader.setPlaintextMessages(true);
 
+  // Tracks share most of their waypoints - keep resolved idents for all track strings
+  reader.setKeepCache(true);
+
   // Maps trackpoint/waypoint (real or generated with offset) ids to records to insert into table trackpoint
   QHash<int, SqlRecord> trackpoints;
 
@@ -31,6 +31,7 @@
 #include "gui/errorhandler.h"
 #include "gui/mainwindow.h"
 #include "navapp.h"
+#include "query/userpointindex.h"
 #include "search/searchcontroller.h"
 #include "search/userdatasearch.h"
 #include "settings/settings.h"
@@ -57,6 +58,7 @@ UserdataController::UserdataController(atools::fs::userdata::UserdataManager *us
   icons = new UserdataIcons();
   icons->loadIcons();
   lastAddedRecord = new SqlRecord();
+  userpointIndex = new UserpointIndex(manager->getDatabase());
 
   connect(this, &UserdataController::userdataChanged, manager, &atools::sql::DataManagerBase::updateUndoRedoActions);
 
@@ -75,6 +77,7 @@ UserdataController::~UserdataController()
   delete buttonHandler;
   delete icons;
   delete lastAddedRecord;
+  delete userpointIndex;
 }
 
 void UserdataController::undoTriggered()
@@ -86,6 +89,9 @@ void UserdataController::undoTriggered()
     manager->undo();
     QGuiApplication::restoreOverrideCursor();
 
+    // Changed rows are not known - reload all
+    userpointIndex->reset();
+
     emit refreshUserdataSearch(false, false);
     emit userdataChanged();
   }
@@ -100,6 +106,8 @@ void UserdataController::redoTriggered()
     manager->redo();
     QGuiApplication::restoreOverrideCursor();
 
+    userpointIndex->reset();
+
     emit refreshUserdataSearch(false, false);
     emit userdataChanged();
   }
@@ -408,6 +416,7 @@ void UserdataController::moveUserpointFromMap(const map::MapUserpoint& userpoint
   // Change coordinate columns for id
   manager->updateRecords(rec, {userpoint.id});
   transaction.commit();
+  userpointIndex->pointsUpdated({userpoint.id});
 
   // No need to update search
   emit userdataChanged();
@@ -418,6 +427,7 @@ void UserdataController::clearTemporary()
 {
   manager->clearTemporary();
   manager->updateUndoRedoActions();
+  userpointIndex->reset();
 }
 
 map::MapUserpoint UserdataController::getUserpointById(int id)
@@ -495,6 +505,7 @@ void UserdataController::addUserpointInternal(int id, const atools::geo::Pos& po
     SqlTransaction transaction(manager->getDatabase());
     manager->insertOneRecord(*lastAddedRecord);
     transaction.commit();
+    userpointIndex->pointsAdded();
 
     if(enableCategory)
       enableCategoryOnMap(lastAddedRecord->valueStr("type"));
@@ -524,6 +535,7 @@ void UserdataController::editUserpoints(const QVector<int>& ids)
       SqlTransaction transaction(manager->getDatabase());
       manager->updateRecords(dlg.getRecord(), ids);
       transaction.commit();
+      userpointIndex->pointsUpdated(ids);
 
       emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
       emit userdataChanged();
@@ -542,6 +554,7 @@ void UserdataController::deleteUserpoints(const QVector<int>& ids)
   SqlTransaction transaction(manager->getDatabase());
   manager->deleteRows(ids);
   transaction.commit();
+  userpointIndex->pointsRemoved(ids);
 
   emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
   emit userdataChanged();
@@ -570,6 +583,7 @@ void UserdataController::importCsv()
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
       manager->updateUndoRedoActions();
+      userpointIndex->pointsAdded();
       emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     }
   }
@@ -602,6 +616,7 @@ void UserdataController::importXplaneUserFixDat()
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
       manager->updateUndoRedoActions();
+      userpointIndex->pointsAdded();
       emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     }
   }
@@ -633,6 +648,7 @@ void UserdataController::importGarmin()
       mainWindow->showUserpointSearch();
       mainWindow->setStatusMessage(tr("%n userpoint(s) imported.", "", numImported));
       manager->updateUndoRedoActions();
+      userpointIndex->pointsAdded();
       emit refreshUserdataSearch(false /* load all */, false /* keep selection */);
     }
   }
@@ -58,6 +58,7 @@ struct MapUserpoint;
 
 class MainWindow;
 class UserdataIcons;
+class UserpointIndex;
 class QToolButton;
 class QAction;
 
@@ -151,6 +152,12 @@ public:
   /* Fill structure for user point id */
   map::MapUserpoint getUserpointById(int id);
 
+  /* In memory index of all userpoints used for map display. Kept up to date on all changes. */
+  UserpointIndex *getUserpointIndex() const
+  {
+    return userpointIndex;
+  }
+
 signals:
   /* Sent after database modification to update the search result table */
   void refreshUserdataSearch(bool loadAll, bool keepSelection);
@@ -195,6 +202,9 @@ private:
   QVector<QAction *> actions;
   atools::sql::SqlRecord *lastAddedRecord = nullptr;
 
+  /* Userpoints for map display */
+  UserpointIndex *userpointIndex = nullptr;
+
   /* Takes care about all action logic like toggling of all/selected and none/selected */
   atools::gui::ActionButtonHandler *buttonHandler;
 